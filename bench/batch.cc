@@ -0,0 +1,56 @@
+/**
+ * @file batch.cc
+ * @brief Scaling of `pltxt2htm::convert_batch` on titles mixed with a few large lab reports
+ */
+
+#include <cstddef>
+#include <span>
+#include <thread>
+#include <fast_io/fast_io.h>
+#include <fast_io/fast_io_dsal/vector.h>
+#include <pltxt2htm/pltxt2htm.hh>
+#include "bench.hh"
+
+int main() noexcept {
+    constexpr ::fast_io::u8string_view title{u8"<color=red>小灯泡</color>的<b>伏安特性</b>"};
+    auto const report = ::pltxt2htm_bench::make_document(500 * 1024);
+
+    // a large report every 2000 titles, so that a static split of the documents leaves threads idle
+    ::fast_io::vector<::fast_io::u8string_view> documents{};
+    ::std::size_t bytes{};
+    for (::std::size_t i{}; i < 20000; ++i) {
+        ::fast_io::u8string_view const document{i % 2000 == 0 ? ::fast_io::u8string_view{report.data(), report.size()}
+                                                                : title};
+        documents.push_back(document);
+        bytes += document.size();
+    }
+    ::std::span<::fast_io::u8string_view const> const batch{documents.data(), documents.size()};
+    ::fast_io::println(::fast_io::u8c_stdout(), u8"documents: ", batch.size(), u8", bytes: ", bytes,
+                       u8", cpus: ", ::std::thread::hardware_concurrency());
+
+    // the same pipeline without reusing the scratch state across documents
+    ::pltxt2htm_bench::run(u8"loop of pltxt2advanced_html", bytes, 5, [batch] {
+        for (auto const document : batch) {
+            [[maybe_unused]] auto html = ::pltxt2htm::pltxt2advanced_html<true>(document, u8"localhost:5173");
+        }
+    });
+
+    double single_thread_ns{};
+    for (::std::size_t const threads :
+         {::std::size_t{1}, ::std::size_t{2}, ::std::size_t{4}, ::std::size_t{8}, ::std::size_t{}}) {
+        // 0 is the number of cpus
+        auto const name = ::fast_io::u8concat_fast_io(
+            u8"convert_batch(threads=", threads == 0 ? ::std::thread::hardware_concurrency() : threads, u8")");
+        auto const ns =
+            ::pltxt2htm_bench::run(::fast_io::u8string_view{name.data(), name.size()}, bytes, 5, [batch, threads] {
+                [[maybe_unused]] auto htmls = ::pltxt2htm::convert_batch<true>(
+                    batch, u8"localhost:5173", ::pltxt2htm::BatchOptions{.threads = threads});
+            });
+        if (threads == 1) {
+            single_thread_ns = ns;
+        }
+        ::fast_io::println(::fast_io::u8c_stdout(), u8"  speedup: ", single_thread_ns / ns);
+    }
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+/**
+ * @file bench.hh
+ * @brief Helpers shared by benchmarks
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fast_io/fast_io.h>
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+
+namespace pltxt2htm_bench {
+
+/**
+ * @brief A paragraph similar to the description of experiments in Quantum-Physics
+ */
+inline constexpr ::fast_io::u8string_view paragraph{
+    u8"<size=48><b>实验目的</b></size>\n"
+    u8"测量<color=red>小灯泡</color>的伏安特性曲线, 参见<Experiment=642cf37a494746375aae306a>电学实验</Experiment>\n"
+    u8"<i>注意</i>: 电压不要超过 3.8V, 否则会烧坏小灯泡 &lt;警告&gt;\n"
+    u8"由<user=5f7e1b2c3d4e5f6a7b8c9d0e>物理实验室</user>提供, 讨论区: "
+    u8"<discussion=6400a1b2c3d4e5f6a7b8c9d0>点此</discussion>\n"
+    u8"# 数据记录\n"
+    u8"| U/V | I/A |\n"
+    u8"<del>旧数据</del> <a>链接</a> \\* 星号 <!-- 这是注释 -->\n\n"};
+
+/**
+ * @brief A prose heavy paragraph which is mostly plain ascii
+ */
+inline constexpr ::fast_io::u8string_view ascii_paragraph{
+    u8"In this experiment, students measured the current-voltage characteristic of a small bulb. "
+    u8"The filament resistance increased with temperature, therefore the curve bent towards the voltage axis. "
+    u8"Readings were taken every 0.2V up to 3.8V; the supply was switched off between runs to let it cool.\n"
+    u8"See <Experiment=642cf37a494746375aae306a>the lab</Experiment> for the circuit, and <b>do not</b> exceed "
+    u8"the rated voltage.\n\n"};
+
+/**
+ * @brief A chat style note where nearly every word is wrapped in a tag
+ */
+inline constexpr ::fast_io::u8string_view tag_paragraph{
+    u8"<color=red>U</color>=<b>3.8</b><color=blue>V</color>, <COLOR=red>I</COLOR>=<i>0.3</i>A <br>"
+    u8"<Size=12><strong>R</strong></Size> <em>rises</em> <color=#00ff00><b>ok</b></color> "
+    u8"<user=5f7e1b2c3d4e5f6a7b8c9d0e>me</user> <p><del>old</del></p> "
+    u8"<experiment=642cf37a494746375aae306a><h3>lab</h3></experiment>\n"};
+
+/**
+ * @brief Generate a document which is at least `size` bytes by repeating `text`.
+ */
+inline ::fast_io::u8string make_document(::std::size_t size,
+                                         ::fast_io::u8string_view text = ::pltxt2htm_bench::paragraph) noexcept {
+    ::fast_io::u8string result{};
+    while (result.size() < size) {
+        result.append(text);
+    }
+    return result;
+}
+
+/**
+ * @brief Run `func` `iterations` times and print the throughput.
+ * @return nanoseconds per iteration
+ */
+template<typename Func>
+inline double run(::fast_io::u8string_view name, ::std::size_t bytes, ::std::size_t iterations, Func&& func) noexcept {
+    auto const start = ::std::chrono::steady_clock::now();
+    for (::std::size_t i{}; i < iterations; ++i) {
+        func();
+    }
+    auto const end = ::std::chrono::steady_clock::now();
+    auto const elapsed = ::std::chrono::duration_cast<::std::chrono::nanoseconds>(end - start).count();
+    double const ns = static_cast<double>(elapsed) / static_cast<double>(iterations);
+    double const mb_per_s = static_cast<double>(bytes) / ns * 1e9 / (1024.0 * 1024.0);
+    ::fast_io::println(::fast_io::u8c_stdout(), name, u8": ", ns, u8" ns/iter, ", mb_per_s, u8" MiB/s");
+    return ns;
+}
+
+} // namespace pltxt2htm_bench
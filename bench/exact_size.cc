@@ -0,0 +1,36 @@
+/**
+ * @file exact_size.cc
+ * @brief Rendering into a growing string vs measuring the html first and allocating it once
+ */
+
+#include <cstddef>
+#include <fast_io/fast_io.h>
+#include <pltxt2htm/pltxt2htm.hh>
+#include "bench.hh"
+
+int main() noexcept {
+    auto const storage = ::pltxt2htm_bench::make_document(1024 * 1024);
+    ::fast_io::u8string_view const document{storage.data(), storage.size()};
+
+    auto ast = ::pltxt2htm::parse_pltxt<true>(document);
+    ::pltxt2htm::optimize_ast<true>(ast);
+    ::fast_io::println(::fast_io::u8c_stdout(), u8"input: ", document.size(), u8" bytes, html: ",
+                       ::pltxt2htm::advanced_html_size<true>(ast, u8"localhost:5173"), u8" bytes");
+
+    ::pltxt2htm_bench::run(u8"render(growing)", document.size(), 50, [&ast] {
+        [[maybe_unused]] auto html = ::pltxt2htm::details::render_to_string<false>([&ast](auto& html_sink) {
+            ::pltxt2htm::details::ast2advanced_html<true>(ast, u8"localhost:5173", html_sink);
+        });
+    });
+    ::pltxt2htm_bench::run(u8"render(exact_size)", document.size(), 50, [&ast] {
+        [[maybe_unused]] auto html = ::pltxt2htm::details::render_to_string<true>([&ast](auto& html_sink) {
+            ::pltxt2htm::details::ast2advanced_html<true>(ast, u8"localhost:5173", html_sink);
+        });
+    });
+    // the measuring pass of render(exact_size)
+    ::pltxt2htm_bench::run(u8"advanced_html_size(ast)", document.size(), 50, [&ast] {
+        [[maybe_unused]] auto size = ::pltxt2htm::advanced_html_size<true>(ast, u8"localhost:5173");
+    });
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file flat_ast.cc
+ * @brief Rendering the pointer based ast vs rendering FlatAst, and re-rendering a stored image of FlatAst
+ *        vs re-parsing the document
+ */
+
+#include <cstddef>
+#include <fast_io/fast_io.h>
+#include <pltxt2htm/pltxt2htm.hh>
+#include "bench.hh"
+
+int main() noexcept {
+    auto const storage = ::pltxt2htm_bench::make_document(50 * 1024);
+    ::fast_io::u8string_view const document{storage.data(), storage.size()};
+
+    auto const ast = ::pltxt2htm::parse_pltxt<true>(document);
+    auto const flat_ast = ::pltxt2htm::flatten_ast<true>(ast);
+    ::fast_io::println(::fast_io::u8c_stdout(), u8"input: ", document.size(), u8" bytes, nodes: ", flat_ast.size());
+
+    ::pltxt2htm_bench::run(u8"flatten_ast", document.size(), 200, [&ast] {
+        [[maybe_unused]] auto result = ::pltxt2htm::flatten_ast<true>(ast);
+    });
+    ::pltxt2htm_bench::run(u8"ast2advanced_html(Ast)", document.size(), 200, [&ast] {
+        [[maybe_unused]] auto html = ::pltxt2htm::details::ast2advanced_html<true>(ast, u8"localhost:5173");
+    });
+    ::pltxt2htm_bench::run(u8"ast2advanced_html(FlatAst)", document.size(), 200, [&flat_ast] {
+        [[maybe_unused]] auto html = ::pltxt2htm::details::ast2advanced_html<true>(flat_ast, u8"localhost:5173");
+    });
+    ::pltxt2htm_bench::run(u8"flatten_ast + ast2advanced_html(FlatAst)", document.size(), 200, [&ast] {
+        [[maybe_unused]] auto html =
+            ::pltxt2htm::details::ast2advanced_html<true>(::pltxt2htm::flatten_ast<true>(ast), u8"localhost:5173");
+    });
+    ::pltxt2htm_bench::run(u8"ast2common_html(Ast)", document.size(), 200, [&ast] {
+        [[maybe_unused]] auto html = ::pltxt2htm::details::ast2common_html<true>(ast);
+    });
+    ::pltxt2htm_bench::run(u8"ast2common_html(FlatAst)", document.size(), 200, [&flat_ast] {
+        [[maybe_unused]] auto html = ::pltxt2htm::details::ast2common_html<true>(flat_ast);
+    });
+
+    auto const image = ::pltxt2htm::serialize_flat_ast(flat_ast);
+    ::fast_io::u8string_view const image_view{image.data(), image.size()};
+    ::fast_io::println(::fast_io::u8c_stdout(), u8"image: ", image.size(), u8" bytes");
+    ::pltxt2htm_bench::run(u8"serialize_flat_ast", document.size(), 200, [&flat_ast] {
+        [[maybe_unused]] auto result = ::pltxt2htm::serialize_flat_ast(flat_ast);
+    });
+    ::pltxt2htm_bench::run(u8"re-render: pltxt2advanced_html", document.size(), 200, [document] {
+        [[maybe_unused]] auto html = ::pltxt2htm::pltxt2advanced_html<true>(document, u8"localhost:5173");
+    });
+    ::pltxt2htm_bench::run(u8"re-render: load_flat_ast + ast2advanced_html", document.size(), 200, [image_view] {
+        auto const view = ::pltxt2htm::load_flat_ast(image_view);
+        [[maybe_unused]] auto html =
+            ::pltxt2htm::details::ast2advanced_html<true>(view.value<true>(), u8"localhost:5173");
+    });
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file linear_time.cc
+ * @brief Growth of the time of converting adversarial pl-texts: unterminated tags, closing tags which never match
+ *        and deep nesting
+ * @details The time per byte of converting 16n bytes is compared with n bytes: it is about the same for a linear
+ *          conversion, up to the misses of caches, and 16 times for a quadratic scan. It exits with 1 if any shape
+ *          takes more than 4 times.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+#include <fast_io/fast_io.h>
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <pltxt2htm/pltxt2htm.hh>
+
+namespace {
+
+/**
+ * @brief `prefix` followed by `unit` repeated until the text is at least `size` bytes.
+ */
+::fast_io::u8string repeat(::fast_io::u8string_view prefix, ::fast_io::u8string_view unit, ::std::size_t size) {
+    ::fast_io::u8string pltext{prefix};
+    while (pltext.size() < size) {
+        pltext.append(unit);
+    }
+    return pltext;
+}
+
+/**
+ * @brief Time of converting `pltext` once, in nanoseconds.
+ */
+double convert_time(::fast_io::u8string const& pltext) {
+    ::fast_io::u8string_view const view{pltext.data(), pltext.size()};
+    auto const start = ::std::chrono::steady_clock::now();
+    static_cast<void>(::pltxt2htm::pltxt2advanced_html<true>(view, u8"localhost:5173"));
+    static_cast<void>(::pltxt2htm::pltxt2common_html<true>(view));
+    return static_cast<double>((::std::chrono::steady_clock::now() - start).count());
+}
+
+} // namespace
+
+int main() {
+    constexpr ::std::size_t size{::std::size_t{1} << 16};
+    constexpr ::std::size_t growth{16};
+    // prefixes of tags which never end with `>`, closing tags which never match, and tags which are never closed
+    constexpr ::fast_io::u8string_view cases[][2]{
+        {u8"", u8"<color=aaaaaaaa"},
+        {u8"", u8"<color=a    "},
+        {u8"", u8"<size=1"},
+        {u8"", u8"<experiment=a"},
+        {u8"", u8"<b    "},
+        {u8"", u8"<br /"},
+        {u8"", u8"<a"},
+        {u8"", u8"<!--"},
+        {u8"", u8"<!-"},
+        {u8"<b><i>", u8"<!--"},
+        {u8"<color=red>", u8"</color "},
+        {u8"<b>", u8"</"},
+        {u8"", u8"\n# a<br"},
+        {u8"", u8"\n- - -x"},
+        {u8"", u8"<ul><li>"},
+        {u8"", u8"<b><i>"},
+    };
+    bool linear{true};
+    for (auto const& [prefix, unit] : cases) {
+        auto const small = ::repeat(prefix, unit, size);
+        auto const large = ::repeat(prefix, unit, size * growth);
+        // interleaved, so that both sizes see the same load of the machine
+        auto small_time = ::std::numeric_limits<double>::max();
+        auto large_time = ::std::numeric_limits<double>::max();
+        for (int i{}; i < 5; ++i) {
+            small_time = ::std::min(small_time, ::convert_time(small));
+            large_time = ::std::min(large_time, ::convert_time(large));
+        }
+        auto const ratio = (large_time / static_cast<double>(large.size())) /
+                           (small_time / static_cast<double>(small.size()));
+        ::fast_io::println(::fast_io::u8c_stdout(), prefix, unit, u8": ", small_time / 1e6, u8" ms at 64 KiB, ",
+                           large_time / 1e6, u8" ms at 1 MiB, ratio of time per byte ", ratio);
+        if (ratio > 4) {
+            linear = false;
+        }
+    }
+
+    return linear ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file parse_alloc.cc
+ * @brief Allocation count and throughput of parsing a document of about 50 KB
+ */
+
+// every allocation of pltxt2htm and fast_io goes through the global allocator of fast_io
+#define FAST_IO_USE_CUSTOM_GLOBAL_ALLOCATOR
+
+#include <cstddef>
+#include <cstdlib>
+
+namespace {
+
+::std::size_t allocation_count{};
+
+[[nodiscard]]
+void* checked(void* p) noexcept {
+    if (p == nullptr) [[unlikely]] {
+        ::std::abort();
+    }
+    return p;
+}
+
+} // namespace
+
+namespace fast_io {
+
+/**
+ * @brief Count the allocations and reallocations, then forward them to malloc
+ * @note Defined before fast_io is included, because fast_io checks the methods of the allocator on first use.
+ */
+class custom_global_allocator {
+public:
+    static void* allocate(::std::size_t n) noexcept {
+        ++allocation_count;
+        return checked(::std::malloc(n == 0 ? 1 : n));
+    }
+
+    static void* allocate_zero(::std::size_t n) noexcept {
+        ++allocation_count;
+        return checked(::std::calloc(1, n == 0 ? 1 : n));
+    }
+
+    static void* reallocate(void* p, ::std::size_t n) noexcept {
+        ++allocation_count;
+        return checked(::std::realloc(p, n == 0 ? 1 : n));
+    }
+
+    static void deallocate(void* p) noexcept {
+        ::std::free(p);
+    }
+};
+
+} // namespace fast_io
+
+#include <fast_io/fast_io.h>
+#include <pltxt2htm/pltxt2htm.hh>
+#include "bench.hh"
+
+int main() noexcept {
+    auto const storage = ::pltxt2htm_bench::make_document(50 * 1024);
+    ::fast_io::u8string_view const document{storage.data(), storage.size()};
+
+    auto const allocation_count_begin = allocation_count;
+    {
+        [[maybe_unused]] auto ast = ::pltxt2htm::parse_pltxt<true>(document);
+    }
+    ::fast_io::println(::fast_io::u8c_stdout(), u8"input: ", document.size(), u8" bytes, allocations per parse: ",
+                       allocation_count - allocation_count_begin);
+
+    ::pltxt2htm_bench::run(u8"parse_pltxt", document.size(), 200, [&document] {
+        [[maybe_unused]] auto ast = ::pltxt2htm::parse_pltxt<true>(document);
+    });
+    ::pltxt2htm_bench::run(u8"pltxt2advanced_html", document.size(), 200, [&document] {
+        [[maybe_unused]] auto html = ::pltxt2htm::pltxt2advanced_html<true>(document, u8"localhost:5173");
+    });
+
+    return 0;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file scan.cc
+ * @brief Throughput of parsing prose heavy documents, which is dominated by scanning plain text
+ */
+
+#include <cstddef>
+#include <fast_io/fast_io.h>
+#include <pltxt2htm/pltxt2htm.hh>
+#include "bench.hh"
+
+int main() noexcept {
+    auto const ascii_storage = ::pltxt2htm_bench::make_document(1024 * 1024, ::pltxt2htm_bench::ascii_paragraph);
+    ::fast_io::u8string_view const ascii_document{ascii_storage.data(), ascii_storage.size()};
+    auto const mixed_storage = ::pltxt2htm_bench::make_document(1024 * 1024);
+    ::fast_io::u8string_view const mixed_document{mixed_storage.data(), mixed_storage.size()};
+
+    // scanning a run of plain text which is as long as the document
+    ::fast_io::u8string const plain_storage(ascii_document.size(), u8'a');
+    auto const plain_first = plain_storage.data();
+    auto const plain_last = plain_storage.data() + plain_storage.size();
+    ::pltxt2htm_bench::run(u8"find_plain_text_end_scalar", plain_storage.size(), 50, [plain_first, plain_last] {
+        auto volatile end = ::pltxt2htm::details::find_plain_text_end_scalar<false>(plain_first, plain_last);
+        static_cast<void>(end);
+    });
+    ::pltxt2htm_bench::run(u8"find_plain_text_end", plain_storage.size(), 50, [plain_first, plain_last] {
+        auto volatile end = ::pltxt2htm::details::find_plain_text_end<false>(plain_first, plain_last);
+        static_cast<void>(end);
+    });
+
+    ::pltxt2htm_bench::run(u8"is_valid_utf8(mixed)", mixed_document.size(), 50, [&mixed_document] {
+        bool volatile valid = ::pltxt2htm::details::is_valid_utf8(mixed_document);
+        static_cast<void>(valid);
+    });
+
+    ::pltxt2htm_bench::run(u8"parse_pltxt(ascii)", ascii_document.size(), 50, [&ascii_document] {
+        [[maybe_unused]] auto ast = ::pltxt2htm::parse_pltxt<true>(ascii_document);
+    });
+    ::pltxt2htm_bench::run(u8"parse_pltxt(mixed)", mixed_document.size(), 50, [&mixed_document] {
+        [[maybe_unused]] auto ast = ::pltxt2htm::parse_pltxt<true>(mixed_document);
+    });
+
+    return 0;
+}
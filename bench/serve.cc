@@ -0,0 +1,222 @@
+/**
+ * @file serve.cc
+ * @brief Load generator of `pltxt2htm serve`, which reports the throughput and p50/p99 latency of requests
+ * @details Without arguments, a server is started in this process on a temporary unix socket.
+ *          `serve --unix <path>` or `serve --port <port>` benchmarks a running server instead.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include <fast_io/fast_io.h>
+#include <fast_io/fast_io_dsal/vector.h>
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include "../cmd/serve.hh"
+#include "bench.hh"
+
+#if defined(PLTXT2HTM_CMD_SERVE)
+
+namespace {
+
+/**
+ * @brief Where the server listens.
+ */
+struct Endpoint {
+    char const* unix_socket_path{};
+    ::std::uint_least16_t port{};
+};
+
+/**
+ * @brief Connect to the server, -1 on failure.
+ */
+int connect_to(::Endpoint const& endpoint) noexcept {
+    if (endpoint.unix_socket_path != nullptr) {
+        ::sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        ::std::strncpy(address.sun_path, endpoint.unix_socket_path, sizeof(address.sun_path) - 1);
+        auto const fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && ::connect(fd, reinterpret_cast<::sockaddr*>(&address), sizeof(address)) == 0) {
+            return fd;
+        }
+        ::close(fd);
+        return -1;
+    }
+    ::fast_io::posix_sockaddr_in address{.sin_family = ::fast_io::to_posix_sock_family(::fast_io::sock_family::inet),
+                                         .sin_port = ::fast_io::big_endian(endpoint.port),
+                                         .sin_addr = {127, 0, 0, 1}};
+    auto const fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<::sockaddr*>(&address), sizeof(address)) == 0) {
+        return fd;
+    }
+    ::close(fd);
+    return -1;
+}
+
+/**
+ * @brief Send all the bytes of `request` on the blocking socket.
+ * @return false if the connection is broken
+ */
+bool send_request(int fd, ::fast_io::u8string_view request) noexcept {
+    while (!request.empty()) {
+        auto const written = ::send(fd, request.data(), request.size(), 0);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        request.remove_prefix_unchecked(static_cast<::std::size_t>(written));
+    }
+    return true;
+}
+
+/**
+ * @brief Send `request` and receive the whole response on a kept-alive connection.
+ * @return false if the connection is broken or the status is not 200
+ */
+bool round_trip(int fd, ::fast_io::u8string_view request, ::fast_io::vector<char8_t>& buffer) noexcept {
+    if (!::send_request(fd, request)) {
+        return false;
+    }
+    ::std::size_t size{};
+    ::std::size_t head_end{::fast_io::containers::npos};
+    ::std::size_t content_length{};
+    while (true) {
+        if (size == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        auto const received = ::recv(fd, buffer.data() + size, buffer.size() - size, 0);
+        if (received <= 0) {
+            return false;
+        }
+        size += static_cast<::std::size_t>(received);
+        ::fast_io::u8string_view const response{buffer.data(), size};
+        if (head_end == ::fast_io::containers::npos) {
+            head_end = response.find(::fast_io::u8string_view{u8"\r\n\r\n"});
+            if (head_end == ::fast_io::containers::npos) {
+                continue;
+            }
+            if (!response.starts_with(u8"HTTP/1.1 200 ")) {
+                return false;
+            }
+            constexpr ::fast_io::u8string_view content_length_name{u8"Content-Length: "};
+            auto const value = response.find(content_length_name) + content_length_name.size();
+            for (auto i = value; response[i] >= u8'0' && response[i] <= u8'9'; ++i) {
+                content_length = content_length * 10 + static_cast<::std::size_t>(response[i] - u8'0');
+            }
+        }
+        if (size >= head_end + 4 + content_length) {
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Send `requests_per_connection` requests of `text` on each of `connections` connections concurrently,
+ *        one request in flight per connection, and print the throughput and the latency percentiles.
+ */
+void run_load(::fast_io::u8string_view name, ::Endpoint const& endpoint, ::fast_io::u8string_view text,
+              ::std::size_t connections, ::std::size_t requests_per_connection) noexcept {
+    auto const request = ::fast_io::u8concat_fast_io(
+        u8"POST /advanced_html?host=localhost:5173 HTTP/1.1\r\nHost: bench\r\nContent-Length: ", text.size(),
+        u8"\r\n\r\n", text);
+    ::fast_io::vector<::fast_io::vector<::std::int_least64_t>> latencies(connections);
+    ::fast_io::vector<::std::thread> clients{};
+    auto const start = ::std::chrono::steady_clock::now();
+    for (::std::size_t i{}; i < connections; ++i) {
+        clients.emplace_back([&endpoint, &request, &latencies, i, requests_per_connection] {
+            auto const fd = ::connect_to(endpoint);
+            if (fd < 0) {
+                return;
+            }
+            ::fast_io::vector<char8_t> buffer(::std::size_t{64} * 1024);
+            auto& connection_latencies = latencies.index_unchecked(i);
+            connection_latencies.reserve(requests_per_connection);
+            for (::std::size_t j{}; j < requests_per_connection; ++j) {
+                auto const request_start = ::std::chrono::steady_clock::now();
+                if (!::round_trip(fd, ::fast_io::u8string_view{request.data(), request.size()}, buffer)) {
+                    break;
+                }
+                connection_latencies.push_back(::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+                                                   ::std::chrono::steady_clock::now() - request_start)
+                                                   .count());
+            }
+            ::close(fd);
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    auto const elapsed = ::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+                             ::std::chrono::steady_clock::now() - start)
+                             .count();
+
+    ::fast_io::vector<::std::int_least64_t> all{};
+    for (auto const& connection_latencies : latencies) {
+        for (auto const latency : connection_latencies) {
+            all.push_back(latency);
+        }
+    }
+    if (all.size() != connections * requests_per_connection) [[unlikely]] {
+        ::fast_io::println(::fast_io::u8c_stdout(), name, u8": failed, only ", all.size(), u8" of ",
+                           connections * requests_per_connection, u8" requests are answered");
+        return;
+    }
+    ::std::sort(all.begin(), all.end());
+    auto const percentile = [&all](::std::size_t permille) {
+        return static_cast<double>(all.index_unchecked((all.size() - 1) * permille / 1000)) / 1000.0;
+    };
+    ::fast_io::println(::fast_io::u8c_stdout(), name, u8" (connections=", connections, u8"): ",
+                       static_cast<double>(all.size()) / static_cast<double>(elapsed) * 1e9, u8" req/s, p50 ",
+                       percentile(500), u8" us, p99 ", percentile(990), u8" us, max ", percentile(1000), u8" us");
+}
+
+} // namespace
+
+int main(int argc, char const* const* const argv) {
+    ::Endpoint endpoint{};
+    if (argc == 3 && ::std::strcmp(argv[1], "--unix") == 0) {
+        endpoint.unix_socket_path = argv[2];
+    } else if (argc == 3 && ::std::strcmp(argv[1], "--port") == 0) {
+        endpoint.port = static_cast<::std::uint_least16_t>(::std::atoi(argv[2]));
+    } else if (argc != 1) {
+        ::fast_io::perrln("Usage: serve [--unix <socket path> | --port <port on 127.0.0.1>]");
+        return 1;
+    }
+
+    // the server in this process
+    ::pltxt2htm_cmd::ServeOptions options{.unix_socket_path = "pltxt2htm_bench_serve.sock"};
+    ::pltxt2htm_cmd::ServeListeners listeners{};
+    ::pltxt2htm_cmd::ServeWorkers workers{};
+    if (argc == 1) {
+        if (!listeners.listen(options) || !workers.start<true>(listeners, options)) {
+            return 1;
+        }
+        endpoint.unix_socket_path = options.unix_socket_path;
+    }
+
+    constexpr ::fast_io::u8string_view title{u8"<color=red>小灯泡</color>的<b>伏安特性</b>"};
+    auto const report = ::pltxt2htm_bench::make_document(50 * 1024);
+    for (::std::size_t const connections : {::std::size_t{1}, ::std::size_t{4}, ::std::size_t{16}}) {
+        ::run_load(u8"title", endpoint, title, connections, 20000 / connections);
+    }
+    for (::std::size_t const connections : {::std::size_t{1}, ::std::size_t{4}, ::std::size_t{16}}) {
+        ::run_load(u8"50 KB report", endpoint, ::fast_io::u8string_view{report.data(), report.size()}, connections,
+                   800 / connections);
+    }
+
+    return 0;
+}
+
+#else
+
+int main() {
+    ::fast_io::perrln("`pltxt2htm serve` is not supported on this platform");
+    return 0;
+}
+
+#endif // defined(PLTXT2HTM_CMD_SERVE)
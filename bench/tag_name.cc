@@ -0,0 +1,23 @@
+/**
+ * @file tag_name.cc
+ * @brief Throughput of parsing tag dense documents, which is dominated by recognizing tags
+ */
+
+#include <cstddef>
+#include <fast_io/fast_io.h>
+#include <pltxt2htm/pltxt2htm.hh>
+#include "bench.hh"
+
+int main() noexcept {
+    auto const tag_storage = ::pltxt2htm_bench::make_document(1024 * 1024, ::pltxt2htm_bench::tag_paragraph);
+    ::fast_io::u8string_view const tag_document{tag_storage.data(), tag_storage.size()};
+
+    ::pltxt2htm_bench::run(u8"parse_pltxt(tags)", tag_document.size(), 50, [&tag_document] {
+        [[maybe_unused]] auto ast = ::pltxt2htm::parse_pltxt<true>(tag_document);
+    });
+    ::pltxt2htm_bench::run(u8"pltxt2advanced_html(tags)", tag_document.size(), 50, [&tag_document] {
+        [[maybe_unused]] auto html = ::pltxt2htm::pltxt2advanced_html<true>(tag_document, u8"localhost:5173");
+    });
+
+    return 0;
+}
@@ -0,0 +1,28 @@
+set_allowedmodes("release", "releasedbg")
+add_rules("mode.release", "mode.releasedbg")
+set_defaultmode("release")
+
+includes("../xmake/*.lua")
+
+set_languages("c++23")
+set_encodings("utf-8")
+set_kind("binary")
+set_default(false)
+add_includedirs("$(projectdir)/../include")
+
+-- requires g++ >= 14
+-- requires clang++ >= 20
+
+for _, file in ipairs(os.files("*.cc")) do
+    local name = path.basename(file)
+    target(name, function()
+        add_files(name .. ".cc")
+        add_tests("default")
+        if is_plat("windows") or is_plat("mingw") then
+            add_syslinks("ntdll")
+        end
+        if is_plat("linux") or is_plat("bsd") then
+            add_syslinks("pthread")
+        end
+    end)
+end
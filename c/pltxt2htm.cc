@@ -1,3 +1,4 @@
+#include <cstddef>
 #include <pltxt2htm/pltxt2htm.h>
 
 __attribute__((visibility("default"))) extern "C" char8_t const* common_parserd(char8_t const* pltext) noexcept {
@@ -27,3 +28,133 @@ __attribute__((visibility("default"))) extern "C" char8_t const* fixedadv_parser
                                                                                  const char8_t* const host) noexcept {
     return ::pltxt2htm::fixedadv_parser<true>(pltext, host);
 }
+
+__attribute__((visibility("default"))) extern "C" char8_t const* common_parserd_n(char8_t const* pltext,
+                                                                                  ::std::size_t pltext_size,
+                                                                                  ::std::size_t* html_size) noexcept {
+    return ::pltxt2htm::common_parser<false>(pltext, pltext_size, html_size);
+}
+
+__attribute__((visibility("default"))) extern "C" char8_t const* common_parser_n(char8_t const* pltext,
+                                                                                 ::std::size_t pltext_size,
+                                                                                 ::std::size_t* html_size) noexcept {
+    return ::pltxt2htm::common_parser<true>(pltext, pltext_size, html_size);
+}
+
+__attribute__((visibility("default"))) extern "C" ::std::size_t common_parserd_to(char8_t const* pltext,
+                                                                                  ::std::size_t pltext_size,
+                                                                                  char8_t* buffer,
+                                                                                  ::std::size_t buffer_size) noexcept {
+    return ::pltxt2htm::common_parser_to<false>(pltext, pltext_size, buffer, buffer_size);
+}
+
+__attribute__((visibility("default"))) extern "C" ::std::size_t common_parser_to(char8_t const* pltext,
+                                                                                 ::std::size_t pltext_size,
+                                                                                 char8_t* buffer,
+                                                                                 ::std::size_t buffer_size) noexcept {
+    return ::pltxt2htm::common_parser_to<true>(pltext, pltext_size, buffer, buffer_size);
+}
+
+__attribute__((visibility("default"))) extern "C" char8_t const* advanced_parserd_n(char8_t const* pltext,
+                                                                                    ::std::size_t pltext_size,
+                                                                                    char8_t const* host,
+                                                                                    ::std::size_t host_size,
+                                                                                    ::std::size_t* html_size) noexcept {
+    return ::pltxt2htm::advanced_parser<false>(pltext, pltext_size, host, host_size, html_size);
+}
+
+__attribute__((visibility("default"))) extern "C" char8_t const* advanced_parser_n(char8_t const* pltext,
+                                                                                   ::std::size_t pltext_size,
+                                                                                   char8_t const* host,
+                                                                                   ::std::size_t host_size,
+                                                                                   ::std::size_t* html_size) noexcept {
+    return ::pltxt2htm::advanced_parser<true>(pltext, pltext_size, host, host_size, html_size);
+}
+
+__attribute__((visibility("default"))) extern "C" ::std::size_t advanced_parserd_to(
+    char8_t const* pltext, ::std::size_t pltext_size, char8_t const* host, ::std::size_t host_size, char8_t* buffer,
+    ::std::size_t buffer_size) noexcept {
+    return ::pltxt2htm::advanced_parser_to<false>(pltext, pltext_size, host, host_size, buffer, buffer_size);
+}
+
+__attribute__((visibility("default"))) extern "C" ::std::size_t advanced_parser_to(char8_t const* pltext,
+                                                                                   ::std::size_t pltext_size,
+                                                                                   char8_t const* host,
+                                                                                   ::std::size_t host_size,
+                                                                                   char8_t* buffer,
+                                                                                   ::std::size_t buffer_size) noexcept {
+    return ::pltxt2htm::advanced_parser_to<true>(pltext, pltext_size, host, host_size, buffer, buffer_size);
+}
+
+__attribute__((visibility("default"))) extern "C" char8_t const* fixedadv_parserd_n(char8_t const* pltext,
+                                                                                    ::std::size_t pltext_size,
+                                                                                    char8_t const* host,
+                                                                                    ::std::size_t host_size,
+                                                                                    ::std::size_t* html_size) noexcept {
+    return ::pltxt2htm::fixedadv_parser<false>(pltext, pltext_size, host, host_size, html_size);
+}
+
+__attribute__((visibility("default"))) extern "C" char8_t const* fixedadv_parser_n(char8_t const* pltext,
+                                                                                   ::std::size_t pltext_size,
+                                                                                   char8_t const* host,
+                                                                                   ::std::size_t host_size,
+                                                                                   ::std::size_t* html_size) noexcept {
+    return ::pltxt2htm::fixedadv_parser<true>(pltext, pltext_size, host, host_size, html_size);
+}
+
+__attribute__((visibility("default"))) extern "C" ::std::size_t fixedadv_parserd_to(
+    char8_t const* pltext, ::std::size_t pltext_size, char8_t const* host, ::std::size_t host_size, char8_t* buffer,
+    ::std::size_t buffer_size) noexcept {
+    return ::pltxt2htm::fixedadv_parser_to<false>(pltext, pltext_size, host, host_size, buffer, buffer_size);
+}
+
+__attribute__((visibility("default"))) extern "C" ::std::size_t fixedadv_parser_to(char8_t const* pltext,
+                                                                                   ::std::size_t pltext_size,
+                                                                                   char8_t const* host,
+                                                                                   ::std::size_t host_size,
+                                                                                   char8_t* buffer,
+                                                                                   ::std::size_t buffer_size) noexcept {
+    return ::pltxt2htm::fixedadv_parser_to<true>(pltext, pltext_size, host, host_size, buffer, buffer_size);
+}
+
+__attribute__((visibility("default"))) extern "C" void common_parserd_batch(
+    char8_t const* const* pltexts, ::std::size_t const* pltext_sizes, ::std::size_t count, ::std::size_t threads,
+    char8_t const** htmls, ::std::size_t* html_sizes) noexcept {
+    ::pltxt2htm::common_parser_batch<false>(pltexts, pltext_sizes, count, threads, htmls, html_sizes);
+}
+
+__attribute__((visibility("default"))) extern "C" void common_parser_batch(
+    char8_t const* const* pltexts, ::std::size_t const* pltext_sizes, ::std::size_t count, ::std::size_t threads,
+    char8_t const** htmls, ::std::size_t* html_sizes) noexcept {
+    ::pltxt2htm::common_parser_batch<true>(pltexts, pltext_sizes, count, threads, htmls, html_sizes);
+}
+
+__attribute__((visibility("default"))) extern "C" void advanced_parserd_batch(
+    char8_t const* const* pltexts, ::std::size_t const* pltext_sizes, ::std::size_t count, char8_t const* host,
+    ::std::size_t host_size, ::std::size_t threads, char8_t const** htmls, ::std::size_t* html_sizes) noexcept {
+    ::pltxt2htm::advanced_parser_batch<false>(pltexts, pltext_sizes, count, host, host_size, threads, htmls,
+                                              html_sizes);
+}
+
+__attribute__((visibility("default"))) extern "C" void advanced_parser_batch(
+    char8_t const* const* pltexts, ::std::size_t const* pltext_sizes, ::std::size_t count, char8_t const* host,
+    ::std::size_t host_size, ::std::size_t threads, char8_t const** htmls, ::std::size_t* html_sizes) noexcept {
+    ::pltxt2htm::advanced_parser_batch<true>(pltexts, pltext_sizes, count, host, host_size, threads, htmls, html_sizes);
+}
+
+__attribute__((visibility("default"))) extern "C" void fixedadv_parserd_batch(
+    char8_t const* const* pltexts, ::std::size_t const* pltext_sizes, ::std::size_t count, char8_t const* host,
+    ::std::size_t host_size, ::std::size_t threads, char8_t const** htmls, ::std::size_t* html_sizes) noexcept {
+    ::pltxt2htm::fixedadv_parser_batch<false>(pltexts, pltext_sizes, count, host, host_size, threads, htmls,
+                                              html_sizes);
+}
+
+__attribute__((visibility("default"))) extern "C" void fixedadv_parser_batch(
+    char8_t const* const* pltexts, ::std::size_t const* pltext_sizes, ::std::size_t count, char8_t const* host,
+    ::std::size_t host_size, ::std::size_t threads, char8_t const** htmls, ::std::size_t* html_sizes) noexcept {
+    ::pltxt2htm::fixedadv_parser_batch<true>(pltexts, pltext_sizes, count, host, host_size, threads, htmls, html_sizes);
+}
+
+__attribute__((visibility("default"))) extern "C" void pltxt2htm_free(char8_t const* html) noexcept {
+    ::pltxt2htm::free_html(html);
+}
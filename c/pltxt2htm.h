@@ -3,6 +3,8 @@
 #ifndef PLTXT2HTM_H
 #define PLTXT2HTM_H
 
+#include <stddef.h>
+
 #if defined(__cplusplus)
 extern "C"
 #endif
@@ -57,4 +59,197 @@ extern "C"
 #endif
     ;
 
+/* `*_n` take the length of text and host, which need not be null-terminated and may contain '\0'.
+ * The length of the returned html is stored to `*html_size` unless `html_size` is NULL. */
+#if defined(__cplusplus)
+extern "C"
+#endif
+    char const* common_parser_n(char const* text, size_t text_size, size_t* html_size)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+#if defined(__cplusplus)
+extern "C"
+#endif
+    char const* common_parserd_n(char const* text, size_t text_size, size_t* html_size)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+#if defined(__cplusplus)
+extern "C"
+#endif
+    char const* advanced_parser_n(char const* text, size_t text_size, char const* host, size_t host_size,
+                                  size_t* html_size)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+#if defined(__cplusplus)
+extern "C"
+#endif
+    char const* advanced_parserd_n(char const* text, size_t text_size, char const* host, size_t host_size,
+                                   size_t* html_size)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+#if defined(__cplusplus)
+extern "C"
+#endif
+    char const* fixedadv_parser_n(char const* text, size_t text_size, char const* host, size_t host_size,
+                                  size_t* html_size)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+#if defined(__cplusplus)
+extern "C"
+#endif
+    char const* fixedadv_parserd_n(char const* text, size_t text_size, char const* host, size_t host_size,
+                                   size_t* html_size)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+/* `*_to` write the html and a null terminator to `buffer` of `buffer_size` bytes, and return the length of the html.
+ * If the returned length is not less than `buffer_size`, `buffer` is untouched, retry with a larger buffer. */
+#if defined(__cplusplus)
+extern "C"
+#endif
+    size_t common_parser_to(char const* text, size_t text_size, char* buffer, size_t buffer_size)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+#if defined(__cplusplus)
+extern "C"
+#endif
+    size_t common_parserd_to(char const* text, size_t text_size, char* buffer, size_t buffer_size)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+#if defined(__cplusplus)
+extern "C"
+#endif
+    size_t advanced_parser_to(char const* text, size_t text_size, char const* host, size_t host_size, char* buffer,
+                              size_t buffer_size)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+#if defined(__cplusplus)
+extern "C"
+#endif
+    size_t advanced_parserd_to(char const* text, size_t text_size, char const* host, size_t host_size, char* buffer,
+                               size_t buffer_size)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+#if defined(__cplusplus)
+extern "C"
+#endif
+    size_t fixedadv_parser_to(char const* text, size_t text_size, char const* host, size_t host_size, char* buffer,
+                              size_t buffer_size)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+#if defined(__cplusplus)
+extern "C"
+#endif
+    size_t fixedadv_parserd_to(char const* text, size_t text_size, char const* host, size_t host_size, char* buffer,
+                               size_t buffer_size)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+/* `*_batch` convert `count` texts of the given lengths on `threads` threads (0 means the number of cpus).
+ * The html of `texts[i]` is stored to `htmls[i]`, free each of them by `pltxt2htm_free`.
+ * Its length is stored to `html_sizes[i]` unless `html_sizes` is NULL. */
+#if defined(__cplusplus)
+extern "C"
+#endif
+    void common_parser_batch(char const* const* texts, size_t const* text_sizes, size_t count, size_t threads,
+                             char const** htmls, size_t* html_sizes)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+#if defined(__cplusplus)
+extern "C"
+#endif
+    void common_parserd_batch(char const* const* texts, size_t const* text_sizes, size_t count, size_t threads,
+                              char const** htmls, size_t* html_sizes)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+#if defined(__cplusplus)
+extern "C"
+#endif
+    void advanced_parser_batch(char const* const* texts, size_t const* text_sizes, size_t count, char const* host,
+                               size_t host_size, size_t threads, char const** htmls, size_t* html_sizes)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+#if defined(__cplusplus)
+extern "C"
+#endif
+    void advanced_parserd_batch(char const* const* texts, size_t const* text_sizes, size_t count, char const* host,
+                                size_t host_size, size_t threads, char const** htmls, size_t* html_sizes)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+#if defined(__cplusplus)
+extern "C"
+#endif
+    void fixedadv_parser_batch(char const* const* texts, size_t const* text_sizes, size_t count, char const* host,
+                               size_t host_size, size_t threads, char const** htmls, size_t* html_sizes)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+#if defined(__cplusplus)
+extern "C"
+#endif
+    void fixedadv_parserd_batch(char const* const* texts, size_t const* text_sizes, size_t count, char const* host,
+                                size_t host_size, size_t threads, char const** htmls, size_t* html_sizes)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
+/* Free the html returned by the functions above, it is allocated by pltxt2htm rather than the caller */
+#if defined(__cplusplus)
+extern "C"
+#endif
+    void pltxt2htm_free(char const* html)
+#if __cpp_noexcept_function_type >= 201501L
+        noexcept
+#endif
+    ;
+
 #endif
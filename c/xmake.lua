@@ -11,6 +11,10 @@ add_includedirs("$(projectdir)/../include")
 if is_plat("windows") or is_plat("mingw") then
     add_syslinks("ntdll")
 end
+if is_plat("linux") or is_plat("bsd") then
+    -- threads of the batch api
+    add_syslinks("pthread")
+end
 
 local my_on_config = function(target)
     if is_mode("debug") then
@@ -0,0 +1,218 @@
+#pragma once
+
+/**
+ * @file convert_files.hh
+ * @brief `--input-dir` and `--input-list` of the command line, which convert many files in one process
+ */
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+#include <fast_io/fast_io.h>
+#include <fast_io/fast_io_device.h>
+#include <fast_io/fast_io_dsal/vector.h>
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <pltxt2htm/pltxt2htm.hh>
+
+namespace pltxt2htm_cmd {
+
+/**
+ * @brief Collect the regular files under `input_dir` recursively, as paths relative to it.
+ * @return false if `input_dir` can not be walked, the error is printed to stderr
+ */
+inline bool collect_dir(::std::filesystem::path const& input_dir,
+                        ::fast_io::vector<::std::filesystem::path>& relative_paths) {
+    ::std::error_code ec{};
+    ::std::filesystem::recursive_directory_iterator iter{input_dir, ec};
+    for (; !ec && iter != ::std::filesystem::recursive_directory_iterator{}; iter.increment(ec)) {
+        if (iter->is_regular_file(ec)) {
+            relative_paths.push_back(iter->path().lexically_relative(input_dir));
+        }
+    }
+    if (ec) [[unlikely]] {
+        ::fast_io::perrln("Failed to walk `", ::fast_io::mnp::os_c_str(input_dir.c_str()),
+                          "`: ", ::fast_io::mnp::os_c_str(ec.message().c_str()));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Collect the paths listed in `list_file`, one path per line, empty lines are skipped.
+ * @return false if a path is absolute or goes out of its base directory by `..`, because its output would be
+ *         written out of the output directory
+ */
+inline bool collect_list(char const* list_file, ::fast_io::vector<::std::filesystem::path>& relative_paths) {
+    ::fast_io::native_file_loader const loader{::fast_io::mnp::os_c_str(list_file)};
+    ::std::u8string_view const list{reinterpret_cast<char8_t const*>(loader.data()), loader.size()};
+    ::std::size_t line_begin{};
+    while (line_begin < list.size()) {
+        auto line_end = list.find(u8'\n', line_begin);
+        if (line_end == ::std::u8string_view::npos) {
+            line_end = list.size();
+        }
+        auto line = list.substr(line_begin, line_end - line_begin);
+        line_begin = line_end + 1;
+        if (!line.empty() && line.back() == u8'\r') {
+            line.remove_suffix(1);
+        }
+        if (line.empty()) {
+            continue;
+        }
+        auto path = ::std::filesystem::path{line}.lexically_normal();
+        if (path.is_absolute() || path.has_root_path() || (!path.empty() && *path.begin() == u8"..")) [[unlikely]] {
+            ::fast_io::perrln("Listed path must be relative and stay in its directory: `",
+                              ::fast_io::mnp::os_c_str(path.c_str()), "`");
+            return false;
+        }
+        relative_paths.push_back(::std::move(path));
+    }
+    return true;
+}
+
+/**
+ * @brief Path of the html of `relative_path`, relative to the output directory.
+ */
+[[nodiscard]]
+inline ::std::filesystem::path output_relative_path(::std::filesystem::path const& relative_path) {
+    auto result = relative_path;
+    result.replace_extension(".html");
+    return result;
+}
+
+/**
+ * @brief Key of an output path which is equal for the paths of the same file on a case-insensitive file system.
+ * @note Only ASCII letters are folded.
+ */
+[[nodiscard]]
+inline ::std::filesystem::path::string_type output_path_key(::std::filesystem::path const& output_path) {
+    auto key = output_path.lexically_normal().native();
+    for (auto& chr : key) {
+        if (u8'A' <= chr && chr <= u8'Z') {
+            chr += u8'a' - u8'A';
+        }
+    }
+    return key;
+}
+
+/**
+ * @brief Find the files which would be converted to the same html, e.g. `a.txt` and `a.md`, `a.txt` and `A.txt`
+ *        (on a case-insensitive file system), or a file which is listed twice, whose outputs would be written by
+ *        2 workers at once.
+ * @return Number of such files, the collisions are printed to stderr.
+ */
+inline ::std::size_t check_output_collisions(::fast_io::vector<::std::filesystem::path> const& relative_paths,
+                                             ::std::filesystem::path const& output_dir) {
+    ::fast_io::vector<::std::filesystem::path> output_paths{};
+    ::fast_io::vector<::std::filesystem::path::string_type> output_keys{};
+    ::fast_io::vector<::std::size_t> order{};
+    for (::std::size_t i{}; i < relative_paths.size(); ++i) {
+        output_paths.push_back(::pltxt2htm_cmd::output_relative_path(relative_paths.index_unchecked(i)));
+        output_keys.push_back(::pltxt2htm_cmd::output_path_key(output_paths.back()));
+        order.push_back(i);
+    }
+    ::std::sort(order.begin(), order.end(), [&output_keys](::std::size_t lhs, ::std::size_t rhs) {
+        return output_keys.index_unchecked(lhs) < output_keys.index_unchecked(rhs);
+    });
+
+    ::std::size_t collisions{};
+    for (::std::size_t i{1}; i < order.size(); ++i) {
+        auto const previous = order.index_unchecked(i - 1);
+        auto const current = order.index_unchecked(i);
+        if (output_keys.index_unchecked(previous) != output_keys.index_unchecked(current)) {
+            continue;
+        }
+        ::fast_io::perrln("`", ::fast_io::mnp::os_c_str(relative_paths.index_unchecked(previous).c_str()), "` and `",
+                          ::fast_io::mnp::os_c_str(relative_paths.index_unchecked(current).c_str()),
+                          "` would both be converted to `",
+                          ::fast_io::mnp::os_c_str((output_dir / output_paths.index_unchecked(current)).c_str()), "`");
+        ++collisions;
+    }
+    return collisions;
+}
+
+/**
+ * @brief Scratch state of a worker, which is reused across the files it converts.
+ */
+template<bool ndebug>
+struct FileScratch {
+    ::pltxt2htm::details::BatchScratch<ndebug> batch_scratch{};
+    ::std::filesystem::path input_path{};
+    ::std::filesystem::path output_path{};
+};
+
+/**
+ * @brief Convert `input_dir / path` to `output_dir / path` (whose extension is replaced by `.html`)
+ *        for each of `relative_paths`, on a work-stealing pool of `threads` threads.
+ * @param input_dir: Empty means the current directory
+ * @return Number of files failed to be converted, the errors are printed to stderr.
+ *         Nothing is converted if two files would be converted to the same html.
+ */
+template<bool ndebug>
+inline ::std::size_t convert_files(::fast_io::vector<::std::filesystem::path> const& relative_paths,
+                                   ::std::filesystem::path const& input_dir,
+                                   ::std::filesystem::path const& output_dir, ::fast_io::u8string_view host,
+                                   ::pltxt2htm::BatchOptions const& options) {
+    ::std::size_t failed{::pltxt2htm_cmd::check_output_collisions(relative_paths, output_dir)};
+    if (failed != 0) [[unlikely]] {
+        return failed;
+    }
+
+    // create the output directories before converting, the files of a directory are adjacent when walking it
+    ::std::filesystem::path last_parent{};
+    for (auto const& relative_path : relative_paths) {
+        auto const parent = relative_path.parent_path();
+        if (parent.empty() || parent == last_parent) {
+            continue;
+        }
+        ::std::error_code ec{};
+        ::std::filesystem::create_directories(output_dir / parent, ec);
+        if (ec) [[unlikely]] {
+            ::fast_io::perrln("Failed to create `", ::fast_io::mnp::os_c_str((output_dir / parent).c_str()),
+                              "`: ", ::fast_io::mnp::os_c_str(ec.message().c_str()));
+            ++failed;
+        }
+        last_parent = parent;
+    }
+    if (failed != 0) [[unlikely]] {
+        return failed;
+    }
+
+    ::std::atomic_size_t failed_files{};
+    ::pltxt2htm::details::work_stealing_for_each<::pltxt2htm_cmd::FileScratch<ndebug>>(
+        relative_paths.size(), options.threads,
+        [&](::pltxt2htm_cmd::FileScratch<ndebug>& scratch, ::std::size_t index) {
+            auto const& relative_path = relative_paths.index_unchecked(index);
+            scratch.input_path = input_dir;
+            scratch.input_path /= relative_path;
+            scratch.output_path = output_dir;
+            scratch.output_path /= relative_path;
+            scratch.output_path.replace_extension(".html");
+#if __cpp_exceptions >= 199711L
+            try
+#endif // __cpp_exceptions >= 199711L
+            {
+                // the input is mapped instead of being read into a buffer
+                ::fast_io::native_file_loader const loader{::fast_io::mnp::os_c_str(scratch.input_path.c_str())};
+                auto const html = scratch.batch_scratch.convert(
+                    ::fast_io::u8string_view{reinterpret_cast<char8_t const*>(loader.data()), loader.size()}, host,
+                    options);
+                ::fast_io::u8native_file output_file{::fast_io::mnp::os_c_str(scratch.output_path.c_str()),
+                                                     ::fast_io::open_mode::out};
+                ::fast_io::println(output_file, html);
+            }
+#if __cpp_exceptions >= 199711L
+            catch (::fast_io::error const& e) {
+                ::fast_io::perrln(::fast_io::mnp::os_c_str(scratch.input_path.c_str()), ": ", e);
+                failed_files.fetch_add(1, ::std::memory_order_relaxed);
+            }
+#endif // __cpp_exceptions >= 199711L
+        });
+    return failed_files.load(::std::memory_order_relaxed);
+}
+
+} // namespace pltxt2htm_cmd
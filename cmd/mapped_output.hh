@@ -0,0 +1,54 @@
+#pragma once
+
+/**
+ * @file mapped_output.hh
+ * @brief `-o` of the command line, which renders the html straight into a mapped output file
+ */
+
+#include <cstddef>
+#include <fast_io/fast_io.h>
+#include <fast_io/fast_io_device.h>
+#include <pltxt2htm/pltxt2htm.hh>
+
+namespace pltxt2htm_cmd {
+
+/**
+ * @brief Write the html rendered by `render` and a newline to `output_file_path`.
+ * @param render: Invoked with an `html_sink`, twice where files can be mapped: the first time measures the html,
+ *                the file is then truncated to its size and mapped, and the second time writes the html to the
+ *                mapping without any buffer. Otherwise the html is written through a buffered stream.
+ */
+template<typename Render>
+inline void write_mapped_html(char const* output_file_path, Render&& render)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+#if defined(_WIN32) || defined(__CYGWIN__) ||                                                                      \
+    (!defined(__NEWLIB__) && !defined(__MSDOS__) &&                                                                \
+     (!defined(__wasm__) || (defined(__wasi__) && defined(_WASI_EMULATED_MMAN))) && __has_include(<sys/mman.h>))
+    // the same condition as fast_io defines `native_memory_map_file`
+    ::pltxt2htm::details::MeasureSink measure_sink{};
+    render(measure_sink);
+    // the newline which is the same as printing to stdout
+    auto const file_size = measure_sink.size() + 1;
+
+    ::fast_io::native_file output_file{::fast_io::mnp::os_c_str(output_file_path),
+                                       ::fast_io::open_mode::in | ::fast_io::open_mode::out |
+                                           ::fast_io::open_mode::creat | ::fast_io::open_mode::trunc};
+    ::fast_io::truncate(output_file, file_size);
+    ::fast_io::native_memory_map_file const mapping{::fast_io::at(output_file),
+                                                    ::fast_io::file_map_attribute::read_write, file_size};
+    auto const buffer = reinterpret_cast<char8_t*>(mapping.data());
+    ::pltxt2htm::details::UncheckedSink unchecked_sink{buffer};
+    render(unchecked_sink);
+    buffer[file_size - 1] = u8'\n';
+#else
+    ::fast_io::native_file output_file{::fast_io::mnp::os_c_str(output_file_path), ::fast_io::open_mode::out};
+    ::fast_io::u8native_io_observer output{output_file.native_handle()};
+    ::pltxt2htm::details::render_to_sink(output, render);
+    ::fast_io::println(output);
+#endif
+}
+
+} // namespace pltxt2htm_cmd
@@ -2,11 +2,17 @@
 #include <cstdint>
 #include <cstring>
 #include <cassert>
+#include <charconv>
+#include <filesystem>
 #include <exception/exception.hh>
 #include <fast_io/fast_io_dsal/string.h>
 #include <fast_io/fast_io_dsal/string_view.h>
 #include <fast_io/fast_io.h>
 #include <pltxt2htm/pltxt2htm.hh>
+#include "convert_files.hh"
+#include "mapped_output.hh"
+#include "stream.hh"
+#include "serve.hh"
 
 enum class TargetType : ::std::uint_least32_t {
     indeterminate = 0,
@@ -25,13 +31,95 @@ constexpr ::fast_io::u8string_view usage{
     echo "example" | pltxt2htm --target advanced_html --host <host name> -o <output file>
     echo "example" | pltxt2htm --target fixedadv_html --host <host name>
     echo "example" | pltxt2htm --target fixedadv_html --host <host name> -o <output file>
+    pltxt2htm --target <target> [--host <host name>] -i <input file> [-o <output file>]
+    pltxt2htm --target <target> [--host <default host name>] --stream <ndjson|length>
+    pltxt2htm serve [--unix <socket path>] [--port <port on 127.0.0.1>] [--host <default host name>]
+              [-j <threads>]
+    pltxt2htm --target <target> [--host <host name>] --input-dir <dir> --output-dir <dir> [-j <threads>]
+    pltxt2htm --target <target> [--host <host name>] --input-list <file> [--input-dir <dir>] --output-dir <dir>
+              [-j <threads>]
 )"};
 
+/**
+ * @brief `pltxt2htm serve ...`, see serve.hh
+ */
+int serve_main(int argc, char const* const* const argv)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif // __cpp_exceptions < 199711L
+{
+#if defined(PLTXT2HTM_CMD_SERVE)
+    ::pltxt2htm_cmd::ServeOptions options{};
+    for (::std::size_t i{2}; i < static_cast<::std::size_t>(argc); ++i) {
+        if (i == static_cast<::std::size_t>(argc) - 1) [[unlikely]] {
+            ::fast_io::perrln("You must specify a value after `", ::fast_io::mnp::os_c_str(argv[i]), "`");
+            return 1;
+        }
+        if (::std::strcmp(argv[i], "--unix") == 0) {
+            options.unix_socket_path = argv[++i];
+        } else if (::std::strcmp(argv[i], "--host") == 0) {
+            options.default_host = ::fast_io::u8string_view{
+                ::fast_io::mnp::os_c_str(reinterpret_cast<char8_t const*>(argv[++i]))};
+        } else if (::std::strcmp(argv[i], "--port") == 0 || ::std::strcmp(argv[i], "-j") == 0) {
+            bool const is_port{::std::strcmp(argv[i], "--port") == 0};
+            ++i;
+            auto const end = argv[i] + ::std::strlen(argv[i]);
+            ::std::size_t value{};
+            if (auto const [ptr, ec] = ::std::from_chars(argv[i], end, value);
+                ec != ::std::errc{} || ptr != end || (is_port ? value > UINT16_MAX : value == 0)) [[unlikely]] {
+                ::fast_io::perrln(is_port ? "Invalid port: " : "Invalid number of threads: ",
+                                  ::fast_io::mnp::os_c_str(argv[i]));
+                return 1;
+            }
+            if (is_port) {
+                options.port = static_cast<::std::uint_least16_t>(value);
+                options.listen_tcp = true;
+            } else {
+                options.threads = value;
+            }
+        } else [[unlikely]] {
+            ::fast_io::perrln("Unknown option of serve: ", ::fast_io::mnp::os_c_str(argv[i]));
+            return 1;
+        }
+    }
+    if (options.unix_socket_path == nullptr && !options.listen_tcp) [[unlikely]] {
+        ::fast_io::perrln("** You must specify `--unix` and/or `--port` to listen on");
+        return 1;
+    }
+    #if __cpp_exceptions >= 199711L
+    try
+    #endif // __cpp_exceptions >= 199711L
+    {
+        return ::pltxt2htm_cmd::serve<
+    #ifdef NDEBUG
+            true
+    #else
+            false
+    #endif
+            >(options);
+    }
+    #if __cpp_exceptions >= 199711L
+    catch (::fast_io::error const& e) {
+        ::fast_io::perrln(e);
+        return 1;
+    }
+    #endif // __cpp_exceptions >= 199711L
+#else
+    static_cast<void>(argc);
+    static_cast<void>(argv);
+    ::fast_io::perrln("** `pltxt2htm serve` is not supported on this platform");
+    return 1;
+#endif
+}
+
 int main(int argc, char const* const* const argv)
 #if __cpp_exceptions < 199711L
     noexcept
 #endif // __cpp_exceptions < 199711L
 {
+    if (argc >= 2 && ::std::strcmp(argv[1], "serve") == 0) {
+        return ::serve_main(argc, argv);
+    }
     if (argc == 1) {
         ::fast_io::print(
             "pltxt2htm\n"
@@ -67,8 +155,19 @@ int main(int argc, char const* const* const argv)
     ::TargetType target_type = TargetType::indeterminate;
     // host prefix of physics-lab-web
     char8_t const* host = nullptr;
+    // input file path, stdin is read without it
+    char const* input_file_path = nullptr;
     // store output file path, can be optional
     char const* output_file_path = nullptr;
+    // convert all files under the directory, or the files listed in `input_list_path` relative to it
+    char const* input_dir_path = nullptr;
+    char const* input_list_path = nullptr;
+    char const* output_dir_path = nullptr;
+    // number of threads converting files, 0 means the number of cpus
+    ::std::size_t threads{};
+    // convert records from stdin to stdout until stdin ends, see stream.hh
+    bool stream{};
+    ::pltxt2htm_cmd::StreamFraming stream_framing{};
     for (::std::size_t i{1}; i < static_cast<::std::size_t>(argc); ++i) {
         if (::std::strcmp(argv[i], "--host") == 0) {
             if (i == static_cast<::std::size_t>(argc) - 1) [[unlikely]] {
@@ -97,6 +196,17 @@ int main(int argc, char const* const* const argv)
                 return 1;
             }
             ++i;
+        } else if (::std::strcmp(argv[i], "-i") == 0) {
+            if (i == static_cast<::std::size_t>(argc) - 1) [[unlikely]] {
+                ::fast_io::perrln("You must specify input file after `-i`");
+                return 1;
+            }
+            if (input_file_path != nullptr) [[unlikely]] {
+                ::fast_io::perrln("You can only specify one input file");
+                return 1;
+            }
+            input_file_path = argv[++i];
+            continue;
         } else if (::std::strcmp(argv[i], "-o") == 0) {
             if (i == static_cast<::std::size_t>(argc) - 1) [[unlikely]] {
                 ::fast_io::perrln("You must specify output file after `-o`");
@@ -108,6 +218,54 @@ int main(int argc, char const* const* const argv)
             }
             output_file_path = argv[++i];
             continue;
+        } else if (::std::strcmp(argv[i], "--input-dir") == 0 || ::std::strcmp(argv[i], "--input-list") == 0 ||
+                   ::std::strcmp(argv[i], "--output-dir") == 0) {
+            char const*& path = ::std::strcmp(argv[i], "--input-dir") == 0    ? input_dir_path
+                                : ::std::strcmp(argv[i], "--input-list") == 0 ? input_list_path
+                                                                              : output_dir_path;
+            if (i == static_cast<::std::size_t>(argc) - 1) [[unlikely]] {
+                ::fast_io::perrln("You must specify a path after `", ::fast_io::mnp::os_c_str(argv[i]), "`");
+                return 1;
+            }
+            if (path != nullptr) [[unlikely]] {
+                ::fast_io::perrln("You can only specify one `", ::fast_io::mnp::os_c_str(argv[i]), "`");
+                return 1;
+            }
+            path = argv[++i];
+            continue;
+        } else if (::std::strcmp(argv[i], "--stream") == 0) {
+            if (i == static_cast<::std::size_t>(argc) - 1) [[unlikely]] {
+                ::fast_io::perrln("You must specify framing (ndjson or length) after `--stream`");
+                return 1;
+            }
+            if (stream) [[unlikely]] {
+                ::fast_io::perrln("You can only specify one `--stream`");
+                return 1;
+            }
+            ++i;
+            if (::std::strcmp(argv[i], "ndjson") == 0) {
+                stream_framing = ::pltxt2htm_cmd::StreamFraming::ndjson;
+            } else if (::std::strcmp(argv[i], "length") == 0) {
+                stream_framing = ::pltxt2htm_cmd::StreamFraming::length;
+            } else [[unlikely]] {
+                ::fast_io::perrln("Invalid framing: ", ::fast_io::mnp::os_c_str(argv[i]));
+                return 1;
+            }
+            stream = true;
+            continue;
+        } else if (::std::strcmp(argv[i], "-j") == 0) {
+            if (i == static_cast<::std::size_t>(argc) - 1) [[unlikely]] {
+                ::fast_io::perrln("You must specify number of threads after `-j`");
+                return 1;
+            }
+            ++i;
+            auto const end = argv[i] + ::std::strlen(argv[i]);
+            if (auto const [ptr, ec] = ::std::from_chars(argv[i], end, threads);
+                ec != ::std::errc{} || ptr != end || threads == 0) [[unlikely]] {
+                ::fast_io::perrln("Invalid number of threads: ", ::fast_io::mnp::os_c_str(argv[i]));
+                return 1;
+            }
+            continue;
         } else if (::std::strcmp(argv[i], "-h") == 0 || ::std::strcmp(argv[i], "--help") == 0) {
             if (i != 1) [[unlikely]] {
                 ::fast_io::perrln(
@@ -138,7 +296,8 @@ int main(int argc, char const* const* const argv)
     case ::TargetType::fixedadv_html:
         [[fallthrough]];
     case ::TargetType::advanced_html: {
-        if (host == nullptr) [[unlikely]] {
+        // records of `--stream` may specify their own hosts
+        if (host == nullptr && !stream) [[unlikely]] {
             ::fast_io::perrln("** You must specify host name with `--host`");
             ::fast_io::println(::fast_io::u8c_stderr(), usage);
             return 1;
@@ -159,54 +318,154 @@ int main(int argc, char const* const* const argv)
     }
     }
 
+    if (input_dir_path != nullptr || input_list_path != nullptr || output_dir_path != nullptr) {
+        if (output_dir_path == nullptr || (input_dir_path == nullptr && input_list_path == nullptr)) [[unlikely]] {
+            ::fast_io::perrln("** `--output-dir` and one of `--input-dir`, `--input-list` must be specified together");
+            return 1;
+        }
+        if (input_file_path != nullptr || output_file_path != nullptr) [[unlikely]] {
+            ::fast_io::perrln("** You can not specify `-i` or `-o` when converting files to `--output-dir`");
+            return 1;
+        }
+        if (stream) [[unlikely]] {
+            ::fast_io::perrln("** You can not specify `--stream` when converting files to `--output-dir`");
+            return 1;
+        }
+    } else if (threads != 0) [[unlikely]] {
+        ::fast_io::perrln("** `-j` is only used with `--output-dir`");
+        return 1;
+    }
+    if (stream && (input_file_path != nullptr || output_file_path != nullptr)) [[unlikely]] {
+        ::fast_io::perrln("** You can not specify `-i` or `-o` with `--stream`, which reads stdin and writes stdout");
+        return 1;
+    }
+
 #if __cpp_exceptions >= 199711L
     try
 #endif // __cpp_exceptions >= 199711L
     {
-        ::fast_io::u8string input_text{};
-        ::fast_io::io::scan(::fast_io::u8c_stdin(), ::fast_io::mnp::whole_get(input_text));
+        // options of converting many documents in one process
+        ::pltxt2htm::BatchOptions options{.threads = threads};
+        if (target_type == ::TargetType::fixedadv_html) {
+            options.html = ::pltxt2htm::BatchHtml::fixedadv;
+        } else if (target_type == ::TargetType::common_html) {
+            // the same as the default of pltxt2common_html
+            options.html = ::pltxt2htm::BatchHtml::common;
+            options.optimize = false;
+        }
 
-        ::fast_io::u8string html;
-        if (target_type == ::TargetType::advanced_html) {
-            html = ::pltxt2htm::pltxt2advanced_html<
+        if (stream) {
+            auto const complete = ::pltxt2htm_cmd::run_stream<
 #ifdef NDEBUG
                 true
 #else
                 false
 #endif
-                >(::fast_io::mnp::os_c_str(input_text), ::fast_io::mnp::os_c_str(host));
-        } else if (target_type == ::TargetType::common_html) {
-            html = ::pltxt2htm::pltxt2common_html<
+                >(stream_framing,
+                  host == nullptr ? ::fast_io::u8string_view{}
+                                  : ::fast_io::u8string_view{::fast_io::mnp::os_c_str(host)},
+                  options);
+            if (!complete) [[unlikely]] {
+                ::fast_io::perrln("** stdin ends in the middle of a record");
+                return 1;
+            }
+            return 0;
+        }
+
+        if (output_dir_path != nullptr) {
+            ::fast_io::vector<::std::filesystem::path> relative_paths{};
+            ::std::filesystem::path const input_dir{input_dir_path == nullptr ? "" : input_dir_path};
+            if (input_list_path != nullptr ? !::pltxt2htm_cmd::collect_list(input_list_path, relative_paths)
+                                           : !::pltxt2htm_cmd::collect_dir(input_dir, relative_paths)) [[unlikely]] {
+                return 1;
+            }
+            auto const failed = ::pltxt2htm_cmd::convert_files<
 #ifdef NDEBUG
                 true
 #else
                 false
 #endif
-                >(::fast_io::mnp::os_c_str(input_text));
-        } else if (target_type == ::TargetType::fixedadv_html) {
-            html = ::pltxt2htm::pltxt2fixedadv_html<
+                >(relative_paths, input_dir, ::std::filesystem::path{output_dir_path},
+                  host == nullptr ? ::fast_io::u8string_view{}
+                                  : ::fast_io::u8string_view{::fast_io::mnp::os_c_str(host)},
+                  options);
+            return failed == 0 ? 0 : 1;
+        }
+
+        // a file given by `-i` is mapped and parsed in place, stdin is read into a string
+        ::fast_io::native_file_loader input_file{};
+        ::fast_io::u8string input_text{};
+        ::fast_io::u8string_view input_view{};
+        if (input_file_path != nullptr) {
+            input_file = ::fast_io::native_file_loader{::fast_io::mnp::os_c_str(input_file_path)};
+            input_view = ::fast_io::u8string_view{reinterpret_cast<char8_t const*>(input_file.data()),
+                                                  input_file.size()};
+        } else {
+            ::fast_io::io::scan(::fast_io::u8c_stdin(), ::fast_io::mnp::whole_get(input_text));
+            input_view = ::fast_io::u8string_view{input_text.data(), input_text.size()};
+        }
+
+        // the input may contain '\0', which is parsed as the other chars
+        auto ast = ::pltxt2htm::parse_pltxt<
 #ifdef NDEBUG
-                true
+            true
 #else
-                false
+            false
 #endif
-                >(::fast_io::mnp::os_c_str(input_text), ::fast_io::mnp::os_c_str(host));
-        } else [[unlikely]] {
-            ::exception::unreachable<
+            >(input_view);
+        if (target_type != ::TargetType::common_html) {
+            // the same as the default of pltxt2advanced_html and pltxt2fixedadv_html
+            ::pltxt2htm::optimize_ast<
 #ifdef NDEBUG
                 true
 #else
                 false
 #endif
-                >();
+                >(ast);
         }
+
+        // the html is written to the output as it is rendered, instead of being copied from a whole string
+        auto const render = [&ast, target_type, host](auto& html_sink) {
+            if (target_type == ::TargetType::advanced_html) {
+                ::pltxt2htm::details::ast2advanced_html<
+#ifdef NDEBUG
+                    true
+#else
+                    false
+#endif
+                    >(ast, ::fast_io::mnp::os_c_str(host), html_sink);
+            } else if (target_type == ::TargetType::common_html) {
+                ::pltxt2htm::details::ast2common_html<
+#ifdef NDEBUG
+                    true
+#else
+                    false
+#endif
+                    >(ast, html_sink);
+            } else if (target_type == ::TargetType::fixedadv_html) {
+                ::pltxt2htm::details::ast2advanced_html<
+#ifdef NDEBUG
+                    true,
+#else
+                    false,
+#endif
+                    false>(ast, ::fast_io::mnp::os_c_str(host), html_sink);
+            } else [[unlikely]] {
+                ::exception::unreachable<
+#ifdef NDEBUG
+                    true
+#else
+                    false
+#endif
+                    >();
+            }
+        };
         if (output_file_path == nullptr) {
-            ::fast_io::println(::fast_io::u8c_stdout(), html);
+            auto output = ::fast_io::u8c_stdout();
+            ::pltxt2htm::details::render_to_sink(output, render);
+            ::fast_io::println(output);
         } else {
-            auto output_file =
-                ::fast_io::native_file{::fast_io::mnp::os_c_str(output_file_path), ::fast_io::open_mode::out};
-            auto output_file_handle = ::fast_io::u8native_io_observer{output_file.native_handle()};
-            ::fast_io::println(output_file_handle, html);
+            ::pltxt2htm_cmd::write_mapped_html(output_file_path, render);
         }
     }
 #if __cpp_exceptions >= 199711L
@@ -0,0 +1,795 @@
+#pragma once
+
+/**
+ * @file serve.hh
+ * @brief `pltxt2htm serve`, a long-lived server answering render requests over HTTP/1.1 on a unix domain socket
+ *        and/or 127.0.0.1
+ * @details A request is `POST /<target>?host=<host>` whose body is the pl-text, `target` is one of
+ *          `advanced_html`, `fixedadv_html` and `common_html`, `host` is optional when `--host` is given.
+ *          The html is answered with status 200, errors are answered with status 4xx and a plain text message,
+ *          then the connection is closed. Connections are kept alive as HTTP/1.1 specifies.
+ * @note Each worker thread accepts connections and answers their requests, with its own scratch state
+ *       (arena and buffers) which is kept warm across requests.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include <fast_io/fast_io.h>
+#include <fast_io/fast_io_device.h>
+#include <fast_io/fast_io_dsal/vector.h>
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <pltxt2htm/pltxt2htm.hh>
+
+#if !defined(_WIN32) && !defined(__wasi__) && __has_include(<sys/socket.h>) && __has_include(<sys/un.h>) &&     \
+    __has_include(<poll.h>)
+    #define PLTXT2HTM_CMD_SERVE 1
+    #include <csignal>
+    #include <cerrno>
+    #include <poll.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/uio.h>
+    #include <sys/un.h>
+#endif
+
+namespace pltxt2htm_cmd {
+
+struct ServeOptions {
+    // path of the unix domain socket, nullptr means not listening on it
+    char const* unix_socket_path{};
+    // port on 127.0.0.1, 0 means an ephemeral port
+    ::std::uint_least16_t port{};
+    bool listen_tcp{};
+    // number of worker threads, 0 means the number of cpus
+    ::std::size_t threads{};
+    // host of the requests which do not specify one, may be empty
+    ::fast_io::u8string_view default_host{};
+};
+
+#if defined(PLTXT2HTM_CMD_SERVE)
+
+namespace details {
+
+inline constexpr ::std::size_t max_request_head_size{16 * 1024};
+inline constexpr ::std::size_t max_request_body_size{64 * 1024 * 1024};
+
+/**
+ * @brief Compare ascii case-insensitively, `lower` must be lower case.
+ */
+[[nodiscard]]
+constexpr bool equals_ignore_case(::fast_io::u8string_view str, ::fast_io::u8string_view lower) noexcept {
+    if (str.size() != lower.size()) {
+        return false;
+    }
+    for (::std::size_t i{}; i < str.size(); ++i) {
+        auto chr = str[i];
+        if (chr >= u8'A' && chr <= u8'Z') {
+            chr = static_cast<char8_t>(chr - u8'A' + u8'a');
+        }
+        if (chr != lower[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+[[nodiscard]]
+constexpr ::fast_io::u8string_view trim_ows(::fast_io::u8string_view str) noexcept {
+    while (!str.empty() && (str.front() == u8' ' || str.front() == u8'\t')) {
+        str.remove_prefix_unchecked(1);
+    }
+    while (!str.empty() && (str.back() == u8' ' || str.back() == u8'\t')) {
+        str.remove_suffix_unchecked(1);
+    }
+    return str;
+}
+
+/**
+ * @brief Decode a component of the query string, where `+` is a space.
+ * @return false if a `%` is not followed by 2 hex digits
+ */
+[[nodiscard]]
+inline bool percent_decode(::fast_io::u8string_view str, ::fast_io::u8string& result) noexcept {
+    constexpr auto hex_digit = [](char8_t chr) -> int {
+        if (chr >= u8'0' && chr <= u8'9') {
+            return chr - u8'0';
+        } else if (chr >= u8'a' && chr <= u8'f') {
+            return chr - u8'a' + 10;
+        } else if (chr >= u8'A' && chr <= u8'F') {
+            return chr - u8'A' + 10;
+        } else {
+            return -1;
+        }
+    };
+    result.clear();
+    for (::std::size_t i{}; i < str.size(); ++i) {
+        if (str[i] == u8'+') {
+            result.push_back(u8' ');
+        } else if (str[i] == u8'%') {
+            if (str.size() - i < 3 || hex_digit(str[i + 1]) < 0 || hex_digit(str[i + 2]) < 0) {
+                return false;
+            }
+            result.push_back(static_cast<char8_t>(hex_digit(str[i + 1]) * 16 + hex_digit(str[i + 2])));
+            i += 2;
+        } else {
+            result.push_back(str[i]);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief The head of a request, whose views point into the receive buffer.
+ */
+struct HttpRequest {
+    ::fast_io::u8string_view method{};
+    ::fast_io::u8string_view path{};
+    ::fast_io::u8string_view query{};
+    ::std::size_t content_length{};
+    bool has_content_length{};
+    bool keep_alive{};
+    bool expect_continue{};
+};
+
+/**
+ * @brief Parse the head of a request, excluding the empty line which ends it.
+ * @return Empty on success, otherwise the status line and the message of the error
+ */
+[[nodiscard]]
+inline ::fast_io::u8string_view parse_http_head(::fast_io::u8string_view head,
+                                                ::pltxt2htm_cmd::details::HttpRequest& request) noexcept {
+    request = ::pltxt2htm_cmd::details::HttpRequest{};
+    auto line_end = head.find_character(u8'\n');
+    auto request_line = head.subview(0, line_end == ::fast_io::containers::npos ? head.size() : line_end);
+    if (!request_line.empty() && request_line.back() == u8'\r') {
+        request_line.remove_suffix_unchecked(1);
+    }
+    auto const method_end = request_line.find_character(u8' ');
+    if (method_end == ::fast_io::containers::npos) {
+        return u8"400 Bad Request\r\n\r\nmalformed request line";
+    }
+    auto const target_end = request_line.find_character(u8' ', method_end + 1);
+    if (target_end == ::fast_io::containers::npos) {
+        return u8"400 Bad Request\r\n\r\nmalformed request line";
+    }
+    request.method = request_line.subview(0, method_end);
+    auto const target = request_line.subview(method_end + 1, target_end - method_end - 1);
+    auto const version = request_line.subview(target_end + 1);
+    if (version == u8"HTTP/1.1") {
+        request.keep_alive = true;
+    } else if (version != u8"HTTP/1.0") {
+        return u8"505 HTTP Version Not Supported\r\n\r\nonly HTTP/1.0 and HTTP/1.1 are supported";
+    }
+    if (auto const query_begin = target.find_character(u8'?'); query_begin == ::fast_io::containers::npos) {
+        request.path = target;
+    } else {
+        request.path = target.subview(0, query_begin);
+        request.query = target.subview(query_begin + 1);
+    }
+
+    while (line_end != ::fast_io::containers::npos) {
+        auto const line_begin = line_end + 1;
+        line_end = head.find_character(u8'\n', line_begin);
+        auto line = head.subview(line_begin, (line_end == ::fast_io::containers::npos ? head.size() : line_end) -
+                                                 line_begin);
+        if (!line.empty() && line.back() == u8'\r') {
+            line.remove_suffix_unchecked(1);
+        }
+        if (line.empty()) {
+            continue;
+        }
+        auto const colon = line.find_character(u8':');
+        if (colon == ::fast_io::containers::npos) {
+            return u8"400 Bad Request\r\n\r\nmalformed header";
+        }
+        auto const name = line.subview(0, colon);
+        auto const value = ::pltxt2htm_cmd::details::trim_ows(line.subview(colon + 1));
+        if (::pltxt2htm_cmd::details::equals_ignore_case(name, u8"content-length")) {
+            ::std::size_t content_length{};
+            if (value.empty() || value.size() > 19) {
+                return u8"400 Bad Request\r\n\r\nmalformed content-length";
+            }
+            for (auto const chr : value) {
+                if (chr < u8'0' || chr > u8'9') {
+                    return u8"400 Bad Request\r\n\r\nmalformed content-length";
+                }
+                content_length = content_length * 10 + static_cast<::std::size_t>(chr - u8'0');
+            }
+            if (request.has_content_length && content_length != request.content_length) {
+                return u8"400 Bad Request\r\n\r\nconflicting content-length";
+            }
+            request.content_length = content_length;
+            request.has_content_length = true;
+        } else if (::pltxt2htm_cmd::details::equals_ignore_case(name, u8"transfer-encoding")) {
+            return u8"411 Length Required\r\n\r\nchunked body is not supported, use content-length";
+        } else if (::pltxt2htm_cmd::details::equals_ignore_case(name, u8"connection")) {
+            if (::pltxt2htm_cmd::details::equals_ignore_case(value, u8"close")) {
+                request.keep_alive = false;
+            } else if (::pltxt2htm_cmd::details::equals_ignore_case(value, u8"keep-alive")) {
+                request.keep_alive = true;
+            }
+        } else if (::pltxt2htm_cmd::details::equals_ignore_case(name, u8"expect")) {
+            request.expect_continue = ::pltxt2htm_cmd::details::equals_ignore_case(value, u8"100-continue");
+        }
+    }
+    return {};
+}
+
+inline void append_decimal(::fast_io::u8string& result, ::std::size_t value) noexcept {
+    char8_t digits[20];
+    auto first = digits + sizeof(digits);
+    do {
+        *--first = static_cast<char8_t>(u8'0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    result.append(::fast_io::u8string_view{first, static_cast<::std::size_t>(digits + sizeof(digits) - first)});
+}
+
+/**
+ * @brief Send as many bytes of `head` and `body` as the non-blocking socket takes, with one system call.
+ * @return Bytes sent, which is 0 if the send buffer of the socket is full, or -1 if the connection is broken
+ */
+[[nodiscard]]
+inline ::ssize_t send_some(int fd, ::fast_io::u8string_view head, ::fast_io::u8string_view body) noexcept {
+    ::iovec iov[2]{
+        {const_cast<char8_t*>(head.data()), head.size()},
+        {const_cast<char8_t*>(body.data()), body.size()},
+    };
+    while (true) {
+        auto const written = ::writev(fd, iov, body.empty() ? 1 : 2);
+        if (written >= 0) {
+            return written;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+        if (errno != EINTR) {
+            return -1;
+        }
+    }
+}
+
+/**
+ * @brief A connection accepted by a worker, with the bytes received but not answered yet and the bytes of the
+ *        response which are not sent yet.
+ */
+struct ServeConnection {
+    int fd{-1};
+    // bytes [begin, end) of the buffer are received but not answered
+    ::fast_io::vector<char8_t> buffer = ::fast_io::vector<char8_t>(::std::size_t{4096});
+    ::std::size_t begin{};
+    ::std::size_t end{};
+    // bytes of the pending request, the buffer grows to hold it at once
+    ::std::size_t pending_request_size{};
+    bool continue_sent{};
+    // bytes [output_begin, output.size()) of the response are not sent yet, because the client is not reading
+    ::fast_io::u8string output{};
+    ::std::size_t output_begin{};
+    // the connection is closed once the output is sent
+    bool closing{};
+
+    [[nodiscard]]
+    bool has_output(this ServeConnection const& self) noexcept {
+        return self.output_begin != self.output.size();
+    }
+};
+
+/**
+ * @brief State of a worker thread, which is reused across the requests it answers.
+ */
+template<bool ndebug>
+class ServeWorker {
+    ::pltxt2htm::details::BatchScratch<ndebug> scratch_{};
+    ::fast_io::u8string host_{};
+    ::fast_io::u8string response_head_{};
+
+    /**
+     * @brief Send `head` and `body` without blocking, the bytes which the socket does not take are kept in the
+     *        output of the connection, and are sent by `flush` once the socket is writable.
+     * @return false if the connection is broken
+     */
+    [[nodiscard]]
+    static bool send_(::pltxt2htm_cmd::details::ServeConnection& connection, ::fast_io::u8string_view head,
+                      ::fast_io::u8string_view body) noexcept {
+        if (!connection.has_output()) {
+            auto const sent = ::pltxt2htm_cmd::details::send_some(connection.fd, head, body);
+            if (sent < 0) {
+                return false;
+            }
+            auto left = static_cast<::std::size_t>(sent);
+            if (left >= head.size()) {
+                left -= head.size();
+                head = {};
+                body.remove_prefix_unchecked(left);
+            } else {
+                head.remove_prefix_unchecked(left);
+            }
+        }
+        connection.output.append(head);
+        connection.output.append(body);
+        return true;
+    }
+
+    /**
+     * @brief Answer an error, the connection is closed after it.
+     * @return false if the connection must be closed now, i.e. the answer is sent or the connection is broken
+     */
+    [[nodiscard]]
+    static bool reject_(::pltxt2htm_cmd::details::ServeConnection& connection,
+                        ::fast_io::u8string_view status_and_message) noexcept {
+        auto const separator = status_and_message.find(::fast_io::u8string_view{u8"\r\n\r\n"});
+        auto const message = status_and_message.subview(separator + 4);
+        auto const head = ::fast_io::u8concat_fast_io(
+            u8"HTTP/1.1 ", status_and_message.subview(0, separator),
+            u8"\r\nContent-Type: text/plain; charset=utf-8\r\nContent-Length: ", message.size(),
+            u8"\r\nConnection: close\r\n\r\n");
+        connection.closing = true;
+        return ServeWorker::send_(connection, ::fast_io::u8string_view{head.data(), head.size()}, message) &&
+               connection.has_output();
+    }
+
+public:
+    /**
+     * @brief Receive the bytes available on a readable connection, without blocking.
+     * @return false if the connection is closed
+     */
+    [[nodiscard]]
+    static bool receive(::pltxt2htm_cmd::details::ServeConnection& connection) noexcept {
+        if (connection.begin != 0) {
+            ::std::copy(connection.buffer.data() + connection.begin, connection.buffer.data() + connection.end,
+                        connection.buffer.data());
+            connection.end -= connection.begin;
+            connection.begin = 0;
+        }
+        auto capacity = connection.buffer.size();
+        while (capacity < connection.pending_request_size || capacity == connection.end) {
+            capacity *= 2;
+        }
+        if (capacity != connection.buffer.size()) {
+            connection.buffer.resize(capacity);
+        }
+        auto const received = ::recv(connection.fd, connection.buffer.data() + connection.end,
+                                     connection.buffer.size() - connection.end, MSG_DONTWAIT);
+        if (received > 0) {
+            connection.end += static_cast<::std::size_t>(received);
+            return true;
+        }
+        return received < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+
+    /**
+     * @brief Send the output of a writable connection, without blocking.
+     * @return false if the connection is broken
+     */
+    [[nodiscard]]
+    static bool flush(::pltxt2htm_cmd::details::ServeConnection& connection) noexcept {
+        auto const sent = ::pltxt2htm_cmd::details::send_some(
+            connection.fd,
+            ::fast_io::u8string_view{connection.output.data() + connection.output_begin,
+                                     connection.output.size() - connection.output_begin},
+            {});
+        if (sent < 0) {
+            return false;
+        }
+        connection.output_begin += static_cast<::std::size_t>(sent);
+        if (!connection.has_output()) {
+            connection.output.clear();
+            connection.output_begin = 0;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Answer the complete requests received on the connection.
+     * @return false if the connection must be closed
+     * @note The next request is not answered until the client has read the response, so that a client which does
+     *       not read holds one response at most.
+     */
+    [[nodiscard]]
+    bool answer(this ServeWorker& self, ::pltxt2htm_cmd::details::ServeConnection& connection,
+                ::pltxt2htm_cmd::ServeOptions const& options) noexcept {
+        while (true) {
+            if (connection.has_output()) {
+                return true;
+            }
+            if (connection.closing) {
+                return false;
+            }
+            ::fast_io::u8string_view const pending{connection.buffer.data() + connection.begin,
+                                                   connection.end - connection.begin};
+            auto const head_end = pending.find(::fast_io::u8string_view{u8"\r\n\r\n"});
+            if (head_end == ::fast_io::containers::npos) {
+                if (pending.size() > ::pltxt2htm_cmd::details::max_request_head_size) {
+                    return ServeWorker::reject_(
+                        connection, u8"431 Request Header Fields Too Large\r\n\r\nrequest head is too large");
+                }
+                connection.pending_request_size = 0;
+                return true;
+            }
+
+            ::pltxt2htm_cmd::details::HttpRequest request;
+            if (auto const error =
+                    ::pltxt2htm_cmd::details::parse_http_head(pending.subview(0, head_end), request);
+                !error.empty()) {
+                return ServeWorker::reject_(connection, error);
+            }
+            if (request.method != u8"POST") {
+                return ServeWorker::reject_(connection, u8"405 Method Not Allowed\r\n\r\nonly POST is allowed");
+            }
+            ::pltxt2htm::BatchOptions batch_options{};
+            if (request.path == u8"/advanced_html") {
+                batch_options.html = ::pltxt2htm::BatchHtml::advanced;
+            } else if (request.path == u8"/fixedadv_html") {
+                batch_options.html = ::pltxt2htm::BatchHtml::fixedadv;
+            } else if (request.path == u8"/common_html") {
+                // the same as the default of pltxt2common_html
+                batch_options.html = ::pltxt2htm::BatchHtml::common;
+                batch_options.optimize = false;
+            } else {
+                return ServeWorker::reject_(connection,
+                                            u8"404 Not Found\r\n\r\n"
+                                            u8"target must be /advanced_html, /fixedadv_html or /common_html");
+            }
+            if (!request.has_content_length) {
+                return ServeWorker::reject_(connection, u8"411 Length Required\r\n\r\ncontent-length is required");
+            }
+            if (request.content_length > ::pltxt2htm_cmd::details::max_request_body_size) {
+                return ServeWorker::reject_(connection, u8"413 Content Too Large\r\n\r\nbody is too large");
+            }
+
+            // wait for the whole body
+            auto const request_size = head_end + 4 + request.content_length;
+            if (pending.size() < request_size) {
+                if (request.expect_continue && !connection.continue_sent) {
+                    constexpr ::fast_io::u8string_view continue_status{u8"HTTP/1.1 100 Continue\r\n\r\n"};
+                    if (!ServeWorker::send_(connection, continue_status, {})) {
+                        return false;
+                    }
+                    connection.continue_sent = true;
+                }
+                connection.pending_request_size = request_size;
+                return true;
+            }
+
+            // the host of the query, or the default one
+            ::fast_io::u8string_view host{options.default_host};
+            for (auto query = request.query; !query.empty();) {
+                auto const separator = query.find_character(u8'&');
+                auto const parameter =
+                    query.subview(0, separator == ::fast_io::containers::npos ? query.size() : separator);
+                query = separator == ::fast_io::containers::npos ? ::fast_io::u8string_view{}
+                                                                 : query.subview(separator + 1);
+                if (parameter.starts_with(u8"host=")) {
+                    if (!::pltxt2htm_cmd::details::percent_decode(parameter.subview(5), self.host_)) {
+                        return ServeWorker::reject_(connection, u8"400 Bad Request\r\n\r\nmalformed host");
+                    }
+                    host = ::fast_io::u8string_view{self.host_.data(), self.host_.size()};
+                }
+            }
+            if (host.empty() && batch_options.html != ::pltxt2htm::BatchHtml::common) {
+                return ServeWorker::reject_(connection, u8"400 Bad Request\r\n\r\n"
+                                                        u8"host is required, e.g. /advanced_html?host=localhost");
+            }
+
+            auto const html =
+                self.scratch_.convert(pending.subview(head_end + 4, request.content_length), host, batch_options);
+            self.response_head_.clear();
+            self.response_head_.append(u8"HTTP/1.1 200 OK\r\nContent-Type: text/html; charset=utf-8\r\n");
+            self.response_head_.append(u8"Content-Length: ");
+            ::pltxt2htm_cmd::details::append_decimal(self.response_head_, html.size());
+            self.response_head_.append(request.keep_alive
+                                           ? ::fast_io::u8string_view{u8"\r\n\r\n"}
+                                           : ::fast_io::u8string_view{u8"\r\nConnection: close\r\n\r\n"});
+            if (!ServeWorker::send_(
+                    connection, ::fast_io::u8string_view{self.response_head_.data(), self.response_head_.size()},
+                    html)) {
+                return false;
+            }
+            connection.closing = !request.keep_alive;
+            connection.begin += request_size;
+            connection.pending_request_size = 0;
+            connection.continue_sent = false;
+        }
+    }
+};
+
+/**
+ * @brief Accept connections from `listeners` and answer their requests, until `stop_fd` is readable.
+ * @note A connection stays with the worker which accepts it, and the worker waits on the listeners and all its
+ *       connections at once, so that idle kept-alive connections do not hold a worker.
+ *       The listeners and the connections are non-blocking: a worker which loses the race of accepting a
+ *       connection goes back to waiting, and a response which the client does not read is sent when the
+ *       connection is writable, so that such a client does not stall the other connections of the worker.
+ */
+template<bool ndebug>
+inline void serve_until_stopped(::fast_io::vector<int> const& listeners, int stop_fd,
+                                ::pltxt2htm_cmd::ServeOptions const& options) noexcept {
+    ::pltxt2htm_cmd::details::ServeWorker<ndebug> worker{};
+    ::fast_io::vector<::pltxt2htm_cmd::details::ServeConnection> connections{};
+    ::fast_io::vector<::pollfd> poll_fds{};
+    // listeners and connections follow the stop fd in `poll_fds`
+    constexpr ::std::size_t first_listener{1};
+    while (true) {
+        poll_fds.clear();
+        poll_fds.push_back(::pollfd{.fd = stop_fd, .events = POLLIN, .revents = 0});
+        for (auto const listener : listeners) {
+            poll_fds.push_back(::pollfd{.fd = listener, .events = POLLIN, .revents = 0});
+        }
+        for (auto const& connection : connections) {
+            poll_fds.push_back(::pollfd{
+                .fd = connection.fd, .events = static_cast<short>(connection.has_output() ? POLLOUT : POLLIN),
+                .revents = 0});
+        }
+        if (::poll(poll_fds.data(), static_cast<::nfds_t>(poll_fds.size()), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // e.g. ENOMEM, retrying would spin
+            ::fast_io::perrln("A worker of serve stops, poll failed with errno ", errno);
+            break;
+        }
+        if (poll_fds.front().revents != 0) {
+            break;
+        }
+
+        // connections are answered before accepting new ones, whose indexes in `poll_fds` are not changed yet
+        for (::std::size_t i{connections.size()}; i-- != 0;) {
+            auto& connection = connections.index_unchecked(i);
+            if (poll_fds.index_unchecked(first_listener + listeners.size() + i).revents == 0) {
+                continue;
+            }
+            if (connection.has_output()) {
+                // the requests which are received already are answered once the response is sent
+                if (::pltxt2htm_cmd::details::ServeWorker<ndebug>::flush(connection) &&
+                    worker.answer(connection, options)) {
+                    continue;
+                }
+            } else if (::pltxt2htm_cmd::details::ServeWorker<ndebug>::receive(connection) &&
+                       worker.answer(connection, options)) {
+                continue;
+            }
+            ::close(connection.fd);
+            if (i != connections.size() - 1) {
+                ::std::swap(connection, connections.back());
+            }
+            connections.pop_back();
+        }
+        for (::std::size_t i{}; i < listeners.size(); ++i) {
+            if ((poll_fds.index_unchecked(first_listener + i).revents & POLLIN) == 0) {
+                continue;
+            }
+            auto const fd = ::accept(listeners.index_unchecked(i), nullptr, nullptr);
+            if (fd < 0) {
+                // taken by another worker, or the client has gone
+                continue;
+            }
+            // accepted sockets do not inherit O_NONBLOCK on linux
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+            connections.push_back(::pltxt2htm_cmd::details::ServeConnection{.fd = fd});
+        }
+    }
+    for (auto const& connection : connections) {
+        ::close(connection.fd);
+    }
+}
+
+} // namespace details
+
+/**
+ * @brief Listening sockets of the server, which are closed (and the unix socket is removed) on destruction.
+ */
+class ServeListeners {
+    ::fast_io::vector<::fast_io::posix_file> sockets_{};
+    char const* unix_socket_path_{};
+
+public:
+    ServeListeners() noexcept = default;
+    ServeListeners(ServeListeners const&) = delete;
+    ServeListeners& operator=(ServeListeners const&) = delete;
+
+    ~ServeListeners() {
+        if (this->unix_socket_path_ != nullptr) {
+            ::unlink(this->unix_socket_path_);
+        }
+    }
+
+    /**
+     * @brief Listen on the sockets of `options`.
+     * @return false if a socket can not be listened on, the error is printed to stderr
+     */
+    [[nodiscard]]
+    bool listen(this ServeListeners& self, ::pltxt2htm_cmd::ServeOptions const& options)
+#if __cpp_exceptions < 199711L
+        noexcept
+#endif
+    {
+        if (options.unix_socket_path != nullptr) {
+            ::sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            if (::std::strlen(options.unix_socket_path) >= sizeof(address.sun_path)) [[unlikely]] {
+                ::fast_io::perrln("Path of unix socket is too long: ",
+                                  ::fast_io::mnp::os_c_str(options.unix_socket_path));
+                return false;
+            }
+            ::std::strcpy(address.sun_path, options.unix_socket_path);
+            // a socket left by a previous server which was killed
+            if (struct ::stat status{}; ::stat(options.unix_socket_path, &status) == 0 && S_ISSOCK(status.st_mode)) {
+                ::unlink(options.unix_socket_path);
+            }
+            ::fast_io::posix_file socket{::fast_io::sock_family::local, ::fast_io::sock_type::stream,
+                                         ::fast_io::open_mode{}, ::fast_io::sock_protocol::ip};
+            ::fast_io::posix_bind(socket, &address, sizeof(address));
+            self.unix_socket_path_ = options.unix_socket_path;
+            ::fast_io::posix_listen(socket, SOMAXCONN);
+            self.sockets_.push_back(::std::move(socket));
+        }
+        if (options.listen_tcp) {
+            ::fast_io::posix_file socket{::fast_io::sock_family::inet, ::fast_io::sock_type::stream,
+                                         ::fast_io::open_mode{}, ::fast_io::sock_protocol::tcp};
+            int const reuse_address{1};
+            ::setsockopt(socket.fd, SOL_SOCKET, SO_REUSEADDR, &reuse_address, sizeof(reuse_address));
+            ::fast_io::posix_sockaddr_in address{
+                .sin_family = ::fast_io::to_posix_sock_family(::fast_io::sock_family::inet),
+                .sin_port = ::fast_io::big_endian(options.port),
+                .sin_addr = {127, 0, 0, 1}};
+            ::fast_io::posix_bind(socket, &address, sizeof(address));
+            ::fast_io::posix_listen(socket, SOMAXCONN);
+            self.sockets_.push_back(::std::move(socket));
+        }
+        for (auto const& socket : self.sockets_) {
+            ::fcntl(socket.fd, F_SETFL, ::fcntl(socket.fd, F_GETFL) | O_NONBLOCK);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Port of 127.0.0.1 which is listened on, useful when `options.port` is 0.
+     */
+    [[nodiscard]]
+    ::std::uint_least16_t tcp_port(this ServeListeners const& self) noexcept {
+        for (auto const& socket : self.sockets_) {
+            ::fast_io::posix_sockaddr_in address{};
+            ::socklen_t size{sizeof(address)};
+            if (::getsockname(socket.fd, reinterpret_cast<::sockaddr*>(&address), &size) == 0 &&
+                address.sin_family == ::fast_io::to_posix_sock_family(::fast_io::sock_family::inet)) {
+                return ::fast_io::big_endian(address.sin_port);
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief File descriptors of the listening sockets.
+     */
+    [[nodiscard]]
+    ::fast_io::vector<int> fds(this ServeListeners const& self) noexcept {
+        ::fast_io::vector<int> fds{};
+        for (auto const& socket : self.sockets_) {
+            fds.push_back(socket.fd);
+        }
+        return fds;
+    }
+};
+
+/**
+ * @brief Worker threads serving `ServeListeners`, which are stopped and joined on destruction.
+ * @note The workers wait on the read end of a pipe besides the sockets, writing to it wakes all of them. It must
+ *       be destroyed before the listeners and the options it serves.
+ */
+class ServeWorkers {
+    ::fast_io::vector<::std::thread> threads_{};
+    int stop_fds_[2]{-1, -1};
+
+public:
+    ServeWorkers() noexcept = default;
+    ServeWorkers(ServeWorkers const&) = delete;
+    ServeWorkers& operator=(ServeWorkers const&) = delete;
+
+    ~ServeWorkers() {
+        this->stop();
+        for (auto const fd : this->stop_fds_) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    /**
+     * @brief Start `options.threads` workers serving `listeners`, 0 means the number of cpus.
+     * @return false if the workers can not be started, the error is printed to stderr
+     */
+    template<bool ndebug>
+    [[nodiscard]]
+    bool start(this ServeWorkers& self, ::pltxt2htm_cmd::ServeListeners const& listeners,
+               ::pltxt2htm_cmd::ServeOptions const& options) noexcept {
+        if (::pipe(self.stop_fds_) != 0) [[unlikely]] {
+            self.stop_fds_[0] = -1;
+            self.stop_fds_[1] = -1;
+            ::fast_io::perrln("Failed to create the pipe stopping the workers");
+            return false;
+        }
+        for (auto const fd : self.stop_fds_) {
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+        auto threads = options.threads == 0 ? ::std::thread::hardware_concurrency() : options.threads;
+        if (threads == 0) {
+            threads = 1;
+        }
+        for (::std::size_t i{}; i < threads; ++i) {
+            self.threads_.push_back(
+                ::std::thread{[fds = listeners.fds(), stop_fd = self.stop_fds_[0], &options] {
+                    ::pltxt2htm_cmd::details::serve_until_stopped<ndebug>(fds, stop_fd, options);
+                }});
+        }
+        return true;
+    }
+
+    /**
+     * @brief Stop the workers and wait for them, their connections are closed.
+     */
+    void stop(this ServeWorkers& self) noexcept {
+        if (self.threads_.empty()) {
+            return;
+        }
+        // the byte is never read, so the pipe stays readable for every worker
+        char8_t const byte{};
+        while (::write(self.stop_fds_[1], &byte, 1) < 0 && errno == EINTR) {
+        }
+        for (auto& thread : self.threads_) {
+            thread.join();
+        }
+        self.threads_.clear();
+    }
+};
+
+/**
+ * @brief Serve until SIGINT or SIGTERM.
+ * @return exit code of the command line
+ */
+template<bool ndebug>
+inline int serve(::pltxt2htm_cmd::ServeOptions const& options)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    // a client closing its connection early must not kill the server
+    ::signal(SIGPIPE, SIG_IGN);
+    // the signals are waited by this thread, the workers inherit the mask
+    ::sigset_t stop_signals;
+    ::sigemptyset(&stop_signals);
+    ::sigaddset(&stop_signals, SIGINT);
+    ::sigaddset(&stop_signals, SIGTERM);
+    ::pthread_sigmask(SIG_BLOCK, &stop_signals, nullptr);
+
+    ::pltxt2htm_cmd::ServeListeners listeners{};
+    if (!listeners.listen(options)) [[unlikely]] {
+        return 1;
+    }
+    if (options.unix_socket_path != nullptr) {
+        ::fast_io::perrln("listening on unix:", ::fast_io::mnp::os_c_str(options.unix_socket_path));
+    }
+    if (options.listen_tcp) {
+        ::fast_io::perrln("listening on http://127.0.0.1:", listeners.tcp_port());
+    }
+    ::pltxt2htm_cmd::ServeWorkers workers{};
+    if (!workers.start<ndebug>(listeners, options)) [[unlikely]] {
+        return 1;
+    }
+
+    int signal_number;
+    ::sigwait(&stop_signals, &signal_number);
+    // the workers are joined before the listeners are closed
+    workers.stop();
+    return 0;
+}
+
+#endif // defined(PLTXT2HTM_CMD_SERVE)
+
+} // namespace pltxt2htm_cmd
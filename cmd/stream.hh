@@ -0,0 +1,517 @@
+#pragma once
+
+/**
+ * @file stream.hh
+ * @brief `--stream` of the command line, which converts records from stdin to stdout in one long-lived process
+ * @details Framings of the records:
+ *          - ndjson: one json object per line, `{"id": <any scalar>, "text": "...", "host": "..."}`,
+ *                    `id` and `host` are optional. Each line is answered by `{"id": <the same id>, "html": "..."}`
+ *                    or `{"id": <the same id>, "error": "..."}`. Blank lines are skipped.
+ *          - length: `u32 host size, host, u32 text size, text`, sizes are little endian and a host of size 0 means
+ *                    `--host`. Each record is answered by `u32 html size, html`, or by
+ *                    `u32 0xffffffff, u32 error size, error` if the html is not smaller than 0xffffffff bytes.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <fast_io/fast_io.h>
+#include <fast_io/fast_io_dsal/vector.h>
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <pltxt2htm/pltxt2htm.hh>
+
+namespace pltxt2htm_cmd {
+
+enum class StreamFraming : ::std::uint_least8_t {
+    ndjson,
+    length,
+};
+
+namespace details {
+
+[[nodiscard]]
+constexpr bool is_json_whitespace(char8_t chr) noexcept {
+    return chr == u8' ' || chr == u8'\t' || chr == u8'\n' || chr == u8'\r';
+}
+
+constexpr void skip_json_whitespace(::fast_io::u8string_view json, ::std::size_t& index) noexcept {
+    while (index < json.size() && ::pltxt2htm_cmd::details::is_json_whitespace(json[index])) {
+        ++index;
+    }
+}
+
+[[nodiscard]]
+constexpr int hex_digit(char8_t chr) noexcept {
+    if (chr >= u8'0' && chr <= u8'9') {
+        return chr - u8'0';
+    } else if (chr >= u8'a' && chr <= u8'f') {
+        return chr - u8'a' + 10;
+    } else if (chr >= u8'A' && chr <= u8'F') {
+        return chr - u8'A' + 10;
+    } else {
+        return -1;
+    }
+}
+
+/**
+ * @brief Parse the 4 hex digits after `\u`.
+ * @return false if they are not hex digits
+ */
+[[nodiscard]]
+constexpr bool parse_json_hex4(::fast_io::u8string_view json, ::std::size_t& index,
+                               ::std::uint_least32_t& code_unit) noexcept {
+    if (json.size() - index < 4) {
+        return false;
+    }
+    code_unit = 0;
+    for (::std::size_t i{}; i < 4; ++i) {
+        auto const digit = ::pltxt2htm_cmd::details::hex_digit(json[index++]);
+        if (digit < 0) {
+            return false;
+        }
+        code_unit = code_unit * 16 + static_cast<::std::uint_least32_t>(digit);
+    }
+    return true;
+}
+
+inline void append_utf8(::fast_io::u8string& result, ::std::uint_least32_t code_point) noexcept {
+    if (code_point < 0x80) {
+        result.push_back(static_cast<char8_t>(code_point));
+    } else if (code_point < 0x800) {
+        result.push_back(static_cast<char8_t>(0xc0 | (code_point >> 6)));
+        result.push_back(static_cast<char8_t>(0x80 | (code_point & 0x3f)));
+    } else if (code_point < 0x10000) {
+        result.push_back(static_cast<char8_t>(0xe0 | (code_point >> 12)));
+        result.push_back(static_cast<char8_t>(0x80 | ((code_point >> 6) & 0x3f)));
+        result.push_back(static_cast<char8_t>(0x80 | (code_point & 0x3f)));
+    } else {
+        result.push_back(static_cast<char8_t>(0xf0 | (code_point >> 18)));
+        result.push_back(static_cast<char8_t>(0x80 | ((code_point >> 12) & 0x3f)));
+        result.push_back(static_cast<char8_t>(0x80 | ((code_point >> 6) & 0x3f)));
+        result.push_back(static_cast<char8_t>(0x80 | (code_point & 0x3f)));
+    }
+}
+
+/**
+ * @brief Decode the json string starting at `json[index]` (which is `"`) into `result`.
+ * @note A lone surrogate is decoded to U+FFFD.
+ * @return false if the string is malformed
+ */
+[[nodiscard]]
+inline bool parse_json_string(::fast_io::u8string_view json, ::std::size_t& index,
+                              ::fast_io::u8string& result) noexcept {
+    result.clear();
+    ++index;
+    while (index < json.size()) {
+        // copy the run of plain chars at once
+        auto const run_end = ::std::find_if(json.begin() + index, json.end(),
+                                            [](char8_t chr) { return chr == u8'"' || chr == u8'\\'; });
+        auto const run_end_index = static_cast<::std::size_t>(run_end - json.begin());
+        result.append(json.subview(index, run_end_index - index));
+        index = run_end_index;
+        if (index == json.size()) {
+            break;
+        }
+        if (json[index++] == u8'"') {
+            return true;
+        }
+        if (index == json.size()) {
+            break;
+        }
+        switch (json[index++]) {
+        case u8'"': {
+            result.push_back(u8'"');
+            break;
+        }
+        case u8'\\': {
+            result.push_back(u8'\\');
+            break;
+        }
+        case u8'/': {
+            result.push_back(u8'/');
+            break;
+        }
+        case u8'b': {
+            result.push_back(u8'\b');
+            break;
+        }
+        case u8'f': {
+            result.push_back(u8'\f');
+            break;
+        }
+        case u8'n': {
+            result.push_back(u8'\n');
+            break;
+        }
+        case u8'r': {
+            result.push_back(u8'\r');
+            break;
+        }
+        case u8't': {
+            result.push_back(u8'\t');
+            break;
+        }
+        case u8'u': {
+            ::std::uint_least32_t code_point;
+            if (!::pltxt2htm_cmd::details::parse_json_hex4(json, index, code_point)) {
+                return false;
+            }
+            if (code_point >= 0xd800 && code_point < 0xdc00) {
+                // a high surrogate must be followed by `\u` and a low surrogate
+                ::std::uint_least32_t low_surrogate;
+                if (json.size() - index >= 6 && json[index] == u8'\\' && json[index + 1] == u8'u') {
+                    auto low_index = index + 2;
+                    if (!::pltxt2htm_cmd::details::parse_json_hex4(json, low_index, low_surrogate)) {
+                        return false;
+                    }
+                    if (low_surrogate >= 0xdc00 && low_surrogate < 0xe000) {
+                        code_point = 0x10000 + ((code_point - 0xd800) << 10) + (low_surrogate - 0xdc00);
+                        index = low_index;
+                    } else {
+                        code_point = 0xfffd;
+                    }
+                } else {
+                    code_point = 0xfffd;
+                }
+            } else if (code_point >= 0xdc00 && code_point < 0xe000) {
+                code_point = 0xfffd;
+            }
+            ::pltxt2htm_cmd::details::append_utf8(result, code_point);
+            break;
+        }
+        default: {
+            return false;
+        }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Skip the json value starting at `json[index]`, objects and arrays are skipped with their nested values.
+ * @return false if the value is malformed
+ */
+[[nodiscard]]
+inline bool skip_json_value(::fast_io::u8string_view json, ::std::size_t& index,
+                            ::fast_io::u8string& string_scratch) noexcept {
+    ::std::size_t depth{};
+    do {
+        ::pltxt2htm_cmd::details::skip_json_whitespace(json, index);
+        if (index == json.size()) {
+            return false;
+        }
+        auto const chr = json[index];
+        if (chr == u8'"') {
+            if (!::pltxt2htm_cmd::details::parse_json_string(json, index, string_scratch)) {
+                return false;
+            }
+        } else if (chr == u8'{' || chr == u8'[') {
+            ++depth;
+            ++index;
+        } else if (chr == u8'}' || chr == u8']') {
+            if (depth == 0) {
+                return false;
+            }
+            --depth;
+            ++index;
+        } else if (chr == u8',' || chr == u8':') {
+            if (depth == 0) {
+                return false;
+            }
+            ++index;
+        } else {
+            // numbers, true, false and null
+            auto const begin = index;
+            while (index < json.size() && (json[index] == u8'-' || json[index] == u8'+' || json[index] == u8'.' ||
+                                           (json[index] >= u8'0' && json[index] <= u8'9') ||
+                                           (json[index] >= u8'a' && json[index] <= u8'z') ||
+                                           (json[index] >= u8'A' && json[index] <= u8'Z'))) {
+                ++index;
+            }
+            if (index == begin) {
+                return false;
+            }
+        }
+    } while (depth != 0);
+    return true;
+}
+
+/**
+ * @brief A record of the ndjson framing, whose strings are reused across records.
+ */
+struct JsonRecord {
+    // raw json of `id`, which is echoed to the output
+    ::fast_io::u8string_view id{};
+    ::fast_io::u8string text{};
+    ::fast_io::u8string host{};
+    bool has_text{};
+    bool has_host{};
+    ::fast_io::u8string key_scratch{};
+};
+
+/**
+ * @brief Parse a line of the ndjson framing.
+ * @return Empty on success, otherwise the error message
+ */
+[[nodiscard]]
+inline ::fast_io::u8string_view parse_json_record(::fast_io::u8string_view line,
+                                                  ::pltxt2htm_cmd::details::JsonRecord& record) noexcept {
+    record.id = ::fast_io::u8string_view{};
+    record.has_text = false;
+    record.has_host = false;
+    ::std::size_t index{};
+    ::pltxt2htm_cmd::details::skip_json_whitespace(line, index);
+    if (index == line.size() || line[index++] != u8'{') {
+        return u8"record must be a json object";
+    }
+    ::pltxt2htm_cmd::details::skip_json_whitespace(line, index);
+    if (index < line.size() && line[index] == u8'}') {
+        ++index;
+    } else {
+        while (true) {
+            ::pltxt2htm_cmd::details::skip_json_whitespace(line, index);
+            if (index == line.size() || line[index] != u8'"' ||
+                !::pltxt2htm_cmd::details::parse_json_string(line, index, record.key_scratch)) {
+                return u8"malformed key";
+            }
+            ::pltxt2htm_cmd::details::skip_json_whitespace(line, index);
+            if (index == line.size() || line[index++] != u8':') {
+                return u8"expected `:` after key";
+            }
+            ::pltxt2htm_cmd::details::skip_json_whitespace(line, index);
+            ::fast_io::u8string_view const key{record.key_scratch.data(), record.key_scratch.size()};
+            if (key == u8"text" || key == u8"host") {
+                bool const is_text{key == u8"text"};
+                if (index == line.size() || line[index] != u8'"' ||
+                    !::pltxt2htm_cmd::details::parse_json_string(line, index, is_text ? record.text : record.host)) {
+                    return is_text ? u8"`text` must be a string" : u8"`host` must be a string";
+                }
+                (is_text ? record.has_text : record.has_host) = true;
+            } else {
+                // the key is overwritten by the strings in the skipped value
+                bool const is_id{key == u8"id"};
+                auto const value_begin = index;
+                if (!::pltxt2htm_cmd::details::skip_json_value(line, index, record.key_scratch)) {
+                    return u8"malformed value";
+                }
+                if (is_id) {
+                    record.id = line.subview(value_begin, index - value_begin);
+                }
+            }
+            ::pltxt2htm_cmd::details::skip_json_whitespace(line, index);
+            if (index == line.size()) {
+                return u8"unterminated object";
+            }
+            if (line[index] == u8',') {
+                ++index;
+                continue;
+            }
+            if (line[index++] != u8'}') {
+                return u8"expected `,` or `}` after value";
+            }
+            break;
+        }
+    }
+    ::pltxt2htm_cmd::details::skip_json_whitespace(line, index);
+    if (index != line.size()) {
+        return u8"trailing characters after the object";
+    }
+    if (!record.has_text) {
+        return u8"missing `text`";
+    }
+    return {};
+}
+
+/**
+ * @brief Append `str` as a json string.
+ */
+inline void append_json_string(::fast_io::u8string& result, ::fast_io::u8string_view str) noexcept {
+    constexpr char8_t hex_digits[]{u8"0123456789abcdef"};
+    result.push_back(u8'"');
+    ::std::size_t run_begin{};
+    for (::std::size_t i{}; i < str.size(); ++i) {
+        auto const chr = str[i];
+        if (chr >= 0x20 && chr != u8'"' && chr != u8'\\') [[likely]] {
+            continue;
+        }
+        result.append(str.subview(run_begin, i - run_begin));
+        run_begin = i + 1;
+        switch (chr) {
+        case u8'"': {
+            result.append(u8"\\\"");
+            break;
+        }
+        case u8'\\': {
+            result.append(u8"\\\\");
+            break;
+        }
+        case u8'\n': {
+            result.append(u8"\\n");
+            break;
+        }
+        case u8'\r': {
+            result.append(u8"\\r");
+            break;
+        }
+        case u8'\t': {
+            result.append(u8"\\t");
+            break;
+        }
+        default: {
+            result.append(u8"\\u00");
+            result.push_back(hex_digits[chr >> 4]);
+            result.push_back(hex_digits[chr & 0xf]);
+            break;
+        }
+        }
+    }
+    result.append(str.subview(run_begin));
+    result.push_back(u8'"');
+}
+
+[[nodiscard]]
+constexpr ::std::uint_least32_t load_le32(char8_t const* ptr) noexcept {
+    return static_cast<::std::uint_least32_t>(ptr[0]) | (static_cast<::std::uint_least32_t>(ptr[1]) << 8) |
+           (static_cast<::std::uint_least32_t>(ptr[2]) << 16) | (static_cast<::std::uint_least32_t>(ptr[3]) << 24);
+}
+
+/**
+ * @brief Size prefix of an error answer in the length framing, htmls of this size or larger can not be framed.
+ */
+inline constexpr ::std::uint_least32_t length_error_frame{0xffff'ffff};
+
+inline void append_le32(::fast_io::u8string& result, ::std::uint_least32_t value) noexcept {
+    result.push_back(static_cast<char8_t>(value));
+    result.push_back(static_cast<char8_t>(value >> 8));
+    result.push_back(static_cast<char8_t>(value >> 16));
+    result.push_back(static_cast<char8_t>(value >> 24));
+}
+
+} // namespace details
+
+/**
+ * @brief Convert the records read from stdin until its end, and write the answers to stdout in the same order.
+ * @param default_host: Host of the records which do not specify one, may be empty
+ * @note The scratch state of the conversion is reused across records. The answers are written once the records
+ *       buffered from stdin are converted, so that a client waiting for an answer before sending the next record
+ *       is answered at once, and a client sending many records at once gets the answers in large writes.
+ * @return false if stdin ends in the middle of a length-prefixed record
+ */
+template<bool ndebug>
+inline bool run_stream(::pltxt2htm_cmd::StreamFraming framing, ::fast_io::u8string_view default_host,
+                       ::pltxt2htm::BatchOptions const& options)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    auto const input = ::fast_io::native_stdin<char8_t>();
+    auto const output = ::fast_io::native_stdout<char8_t>();
+    ::pltxt2htm::details::BatchScratch<ndebug> scratch{};
+    ::pltxt2htm_cmd::details::JsonRecord json_record{};
+    ::fast_io::u8string answers{};
+    // input bytes [begin, end) are buffered but not processed yet
+    ::fast_io::vector<char8_t> buffer(::std::size_t{64} * 1024);
+    ::std::size_t begin{}, end{};
+    bool eof{};
+
+    auto const answer_json = [&](::fast_io::u8string_view line) {
+        if (auto const error = ::pltxt2htm_cmd::details::parse_json_record(line, json_record); !error.empty()) {
+            answers.append(u8"{\"id\":");
+            answers.append(json_record.id.empty() ? ::fast_io::u8string_view{u8"null"} : json_record.id);
+            answers.append(u8",\"error\":");
+            ::pltxt2htm_cmd::details::append_json_string(answers, error);
+            answers.append(u8"}\n");
+            return;
+        }
+        auto const html = scratch.convert(
+            ::fast_io::u8string_view{json_record.text.data(), json_record.text.size()},
+            json_record.has_host ? ::fast_io::u8string_view{json_record.host.data(), json_record.host.size()}
+                                 : default_host,
+            options);
+        answers.append(u8"{\"id\":");
+        answers.append(json_record.id.empty() ? ::fast_io::u8string_view{u8"null"} : json_record.id);
+        answers.append(u8",\"html\":");
+        ::pltxt2htm_cmd::details::append_json_string(answers, html);
+        answers.append(u8"}\n");
+    };
+
+    while (true) {
+        // answer the complete records in the buffer
+        while (begin != end) {
+            ::fast_io::u8string_view const pending{buffer.data() + begin, end - begin};
+            if (framing == ::pltxt2htm_cmd::StreamFraming::ndjson) {
+                auto line_end = pending.find_character(u8'\n');
+                if (line_end == ::fast_io::containers::npos) {
+                    if (!eof) {
+                        break;
+                    }
+                    // the last line may miss the newline
+                    line_end = pending.size();
+                }
+                auto line = pending.subview(0, line_end);
+                begin += line_end == pending.size() ? line_end : line_end + 1;
+                if (!line.empty() && line.back() == u8'\r') {
+                    line.remove_suffix_unchecked(1);
+                }
+                if (::std::all_of(line.begin(), line.end(), ::pltxt2htm_cmd::details::is_json_whitespace)) {
+                    continue;
+                }
+                answer_json(line);
+            } else {
+                if (pending.size() < 4) {
+                    break;
+                }
+                auto const host_size = ::pltxt2htm_cmd::details::load_le32(pending.data());
+                if (pending.size() - 4 < host_size + ::std::size_t{4}) {
+                    break;
+                }
+                auto const text_size = ::pltxt2htm_cmd::details::load_le32(pending.data() + 4 + host_size);
+                if (pending.size() - 8 - host_size < text_size) {
+                    break;
+                }
+                auto const html = scratch.convert(pending.subview(8 + host_size, text_size),
+                                                  host_size == 0 ? default_host : pending.subview(4, host_size),
+                                                  options);
+                if (html.size() >= ::pltxt2htm_cmd::details::length_error_frame) [[unlikely]] {
+                    constexpr ::fast_io::u8string_view error{u8"the html is too large for a length-prefixed frame"};
+                    ::pltxt2htm_cmd::details::append_le32(answers, ::pltxt2htm_cmd::details::length_error_frame);
+                    ::pltxt2htm_cmd::details::append_le32(answers,
+                                                          static_cast<::std::uint_least32_t>(error.size()));
+                    answers.append(error);
+                } else {
+                    ::pltxt2htm_cmd::details::append_le32(answers, static_cast<::std::uint_least32_t>(html.size()));
+                    answers.append(html);
+                }
+                begin += 8 + ::std::size_t{host_size} + text_size;
+            }
+        }
+
+        // write the answers before waiting for more records
+        if (!answers.empty()) {
+            ::fast_io::operations::write_all(output, answers.data(), answers.data() + answers.size());
+            answers.clear();
+        }
+        if (eof) {
+            return begin == end;
+        }
+
+        // keep the incomplete record at the front, and grow the buffer if it is full
+        if (begin != 0) {
+            ::std::copy(buffer.data() + begin, buffer.data() + end, buffer.data());
+            end -= begin;
+            begin = 0;
+        }
+        if (end == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        auto const read_end =
+            ::fast_io::operations::read_some(input, buffer.data() + end, buffer.data() + buffer.size());
+        if (read_end == buffer.data() + end) {
+            eof = true;
+        }
+        end = static_cast<::std::size_t>(read_end - buffer.data());
+    }
+}
+
+} // namespace pltxt2htm_cmd
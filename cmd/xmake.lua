@@ -12,6 +12,10 @@ target("pltxt2htm", function()
     if is_plat("windows", "mingw") then
         add_syslinks("ntdll")
     end
+    if is_plat("linux") or is_plat("bsd") then
+        -- threads of --input-dir and --input-list
+        add_syslinks("pthread")
+    end
 
     if is_mode("release") then
         set_exceptions("no-cxx")
@@ -12,6 +12,22 @@ using ::pltxt2htm::pltxt2advanced_html;
 using ::pltxt2htm::pltxt2fixedadv_html;
 using ::pltxt2htm::parse_pltxt;
 using ::pltxt2htm::optimize_ast;
+using ::pltxt2htm::flatten_ast;
+using ::pltxt2htm::serialize_flat_ast;
+using ::pltxt2htm::load_flat_ast;
+using ::pltxt2htm::advanced_html_size;
+using ::pltxt2htm::fixedadv_html_size;
+using ::pltxt2htm::common_html_size;
+using ::pltxt2htm::convert_batch;
+
+// exported options
+using ::pltxt2htm::BatchHtml;
+using ::pltxt2htm::BatchOptions;
+using ::pltxt2htm::Limits;
+
+// exported concepts
+using ::pltxt2htm::html_sink;
+using ::pltxt2htm::flat_ast_like;
 
 namespace version {
 // exported global constant variable (version of pltxt2htm)
@@ -24,11 +40,14 @@ using ::pltxt2htm::version::patch;
 
 // exported nodes
 using ::pltxt2htm::NodeType;
+using ::pltxt2htm::FlatAst;
+using ::pltxt2htm::FlatAstView;
 
 // basic
 using ::pltxt2htm::PlTxtNode;
 using ::pltxt2htm::U8Char;
 using ::pltxt2htm::InvalidU8Char;
+using ::pltxt2htm::TextRun;
 using ::pltxt2htm::Text;
 
 // html_node
@@ -1,4 +1,5 @@
-#include <cstring>
+#include <cstddef>
+#include <cstdint>
 #include <pltxt2htm/pltxt2htm.hh>
 
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
@@ -6,9 +7,9 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
     noexcept
 #endif
 {
-    ::fast_io::u8string str(size + 1);
-    ::std::memcpy(str.data(), data, size);
-    [[maybe_unused]] auto _ = ::pltxt2htm::pltxt2common_html(::fast_io::mnp::os_c_str(str));
+    // the input is not null-terminated and may contain '\0', so that over-reads are caught
+    ::fast_io::u8string_view const text{reinterpret_cast<char8_t const*>(data), size};
+    [[maybe_unused]] auto _ = ::pltxt2htm::pltxt2common_html(text);
 
     return 0;
 }
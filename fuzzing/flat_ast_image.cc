@@ -0,0 +1,19 @@
+#include <cstddef>
+#include <cstdint>
+#include <pltxt2htm/pltxt2htm.hh>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    // an image is read from disk, so any bytes must be rejected or rendered in bounds
+    ::fast_io::u8string_view const image{reinterpret_cast<char8_t const*>(data), size};
+    auto const view = ::pltxt2htm::load_flat_ast(image);
+    if (view.has_value()) {
+        [[maybe_unused]] auto advanced_html = ::pltxt2htm::details::ast2advanced_html<false>(view.value<false>(), u8"_");
+        [[maybe_unused]] auto common_html = ::pltxt2htm::details::ast2common_html<false>(view.value<false>());
+    }
+
+    return 0;
+}
@@ -39,3 +39,7 @@ end)
 target("common_parser", function()
     add_files("$(projectdir)/common_parser.cc")
 end)
+
+target("flat_ast_image", function()
+    add_files("$(projectdir)/flat_ast_image.cc")
+end)
@@ -0,0 +1,154 @@
+#pragma once
+
+/**
+ * @file arena.hh
+ * @brief Document-scoped bump allocator for ast nodes
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <fast_io/fast_io_core.h>
+
+namespace pltxt2htm::details {
+
+/**
+ * @brief Header of a memory block owned by `NodeArena`.
+ * @note Every slot allocated in a chunk holds a reference to the chunk, the arena holds one more
+ *       reference to its active chunk. Therefore a chunk is released in bulk after the last node
+ *       inside it is destroyed, even if the ast outlives the arena.
+ */
+struct alignas(::std::max_align_t) ArenaChunk {
+    ::std::size_t refcount_;
+    ::std::size_t capacity_;
+    ::std::size_t used_;
+};
+
+/**
+ * @brief Drop one reference of the chunk, free it if no one uses it.
+ */
+inline void release_arena_chunk(::pltxt2htm::details::ArenaChunk* chunk) noexcept {
+    if (--chunk->refcount_ == 0) {
+        ::fast_io::native_global_allocator::deallocate(chunk);
+    }
+}
+
+/**
+ * @brief Bump allocator that parse_pltxt uses to allocate all nodes of a document.
+ * @note Nodes allocated by the same arena share chunks whose reference count is not atomic,
+ *       they must be destroyed by one thread at a time. A node that outlives the others of its
+ *       chunk keeps the whole chunk alive.
+ */
+class NodeArena {
+    ::pltxt2htm::details::ArenaChunk* chunk_{nullptr};
+    ::std::size_t next_capacity_{initial_capacity};
+
+public:
+    static constexpr ::std::size_t initial_capacity{4096};
+    static constexpr ::std::size_t max_capacity{1024 * 1024};
+
+    constexpr NodeArena() noexcept = default;
+    constexpr NodeArena(NodeArena const&) noexcept = delete;
+    constexpr NodeArena(NodeArena&&) noexcept = delete;
+    constexpr NodeArena& operator=(NodeArena const&) noexcept = delete;
+    constexpr NodeArena& operator=(NodeArena&&) noexcept = delete;
+
+    ~NodeArena() noexcept {
+        if (this->chunk_ != nullptr) {
+            ::pltxt2htm::details::release_arena_chunk(this->chunk_);
+        }
+    }
+
+    /**
+     * @brief Allocate a slot which is released by `NodeArena::deallocate`.
+     * @param size: sizeof the object.
+     * @param align: alignof the object, must not be greater than alignof(::std::max_align_t).
+     */
+    [[nodiscard]]
+    void* allocate(this NodeArena& self, ::std::size_t size, ::std::size_t align) noexcept {
+        if (align < alignof(::pltxt2htm::details::ArenaChunk*)) {
+            align = alignof(::pltxt2htm::details::ArenaChunk*);
+        }
+        ::std::size_t offset{};
+        if (self.chunk_ != nullptr) {
+            offset = (self.chunk_->used_ + sizeof(::pltxt2htm::details::ArenaChunk*) + align - 1) & ~(align - 1);
+        }
+        if (self.chunk_ == nullptr || offset + size > self.chunk_->capacity_) [[unlikely]] {
+            ::std::size_t const required = size + align + sizeof(::pltxt2htm::details::ArenaChunk*);
+            ::std::size_t capacity = self.next_capacity_;
+            if (capacity < required) {
+                capacity = required;
+            }
+            // bad alloc terminates in the allocator, it should never be an exception or err_code
+            auto chunk = reinterpret_cast<::pltxt2htm::details::ArenaChunk*>(
+                ::fast_io::native_global_allocator::allocate(sizeof(::pltxt2htm::details::ArenaChunk) + capacity));
+            chunk->refcount_ = 1;
+            chunk->capacity_ = capacity;
+            chunk->used_ = 0;
+            if (self.chunk_ != nullptr) {
+                ::pltxt2htm::details::release_arena_chunk(self.chunk_);
+            }
+            self.chunk_ = chunk;
+            if (self.next_capacity_ < ::pltxt2htm::details::NodeArena::max_capacity) {
+                self.next_capacity_ *= 2;
+            }
+            offset = (sizeof(::pltxt2htm::details::ArenaChunk*) + align - 1) & ~(align - 1);
+        }
+        auto const data = reinterpret_cast<char*>(self.chunk_ + 1);
+        ::std::memcpy(data + offset - sizeof(::pltxt2htm::details::ArenaChunk*), &self.chunk_,
+                      sizeof(::pltxt2htm::details::ArenaChunk*));
+        self.chunk_->used_ = offset + size;
+        ++self.chunk_->refcount_;
+        return data + offset;
+    }
+
+    /**
+     * @brief Reuse the active chunk from its beginning if no node lives in it any more.
+     * @note Call it after the ast of a document is destroyed, so that the next document allocates its
+     *       nodes from the memory which is already touched instead of a new chunk.
+     */
+    void rewind(this NodeArena& self) noexcept {
+        if (self.chunk_ != nullptr && self.chunk_->refcount_ == 1) {
+            self.chunk_->used_ = 0;
+        }
+    }
+
+    /**
+     * @brief Release a slot allocated by `NodeArena::allocate`.
+     * @note The arena which allocates the slot may already be destroyed.
+     */
+    static void deallocate(void* ptr) noexcept {
+        ::pltxt2htm::details::ArenaChunk* chunk;
+        ::std::memcpy(&chunk, reinterpret_cast<char*>(ptr) - sizeof(::pltxt2htm::details::ArenaChunk*),
+                      sizeof(::pltxt2htm::details::ArenaChunk*));
+        ::pltxt2htm::details::release_arena_chunk(chunk);
+    }
+};
+
+/**
+ * @brief The arena that `HeapGuard` allocates from, nullptr means using ::fast_io::native_global_allocator
+ */
+inline thread_local ::pltxt2htm::details::NodeArena* current_node_arena{nullptr};
+
+/**
+ * @brief RAII of setting `current_node_arena`
+ */
+class NodeArenaScope {
+    ::pltxt2htm::details::NodeArena* previous_;
+
+public:
+    NodeArenaScope(::pltxt2htm::details::NodeArena& arena) noexcept
+        : previous_{::pltxt2htm::details::current_node_arena} {
+        ::pltxt2htm::details::current_node_arena = &arena;
+    }
+
+    constexpr NodeArenaScope(NodeArenaScope const&) noexcept = delete;
+    constexpr NodeArenaScope(NodeArenaScope&&) noexcept = delete;
+    constexpr NodeArenaScope& operator=(NodeArenaScope const&) noexcept = delete;
+    constexpr NodeArenaScope& operator=(NodeArenaScope&&) noexcept = delete;
+
+    ~NodeArenaScope() noexcept {
+        ::pltxt2htm::details::current_node_arena = this->previous_;
+    }
+};
+
+} // namespace pltxt2htm::details
@@ -2,6 +2,7 @@
 
 #include <utility>
 #include <fast_io/fast_io_dsal/vector.h>
+#include <fast_io/fast_io_dsal/string_view.h>
 #include "node_type.hh"
 #include "../heap_guard.hh"
 
@@ -76,6 +77,39 @@ public:
     constexpr InvalidU8Char& operator=(InvalidU8Char&& other) noexcept = default;
 };
 
+/**
+ * @brief Contiguous valid UTF-8 text which is a slice of the pl-text
+ * @note The node borrows the pl-text, therefore the pl-text must outlive the node.
+ */
+class TextRun : public ::pltxt2htm::PlTxtNode {
+    ::fast_io::u8string_view text_;
+
+public:
+    constexpr TextRun() noexcept = delete;
+
+    constexpr TextRun(::fast_io::u8string_view text) noexcept
+        : PlTxtNode{::pltxt2htm::NodeType::text_run},
+          text_{text} {
+    }
+
+    constexpr TextRun(TextRun const& other) noexcept = default;
+    constexpr TextRun(TextRun&& other) noexcept = default;
+    constexpr TextRun& operator=(TextRun const& other) noexcept = default;
+    constexpr TextRun& operator=(TextRun&& other) noexcept = default;
+
+    [[nodiscard]]
+    constexpr auto get_text(this TextRun const& self) noexcept {
+        return self.text_;
+    }
+
+    /**
+     * @brief Extend the run with `length` bytes which directly follow it in the pl-text
+     */
+    constexpr void extend(this TextRun& self, ::std::size_t length) noexcept {
+        self.text_ = ::fast_io::u8string_view{self.text_.data(), self.text_.size() + length};
+    }
+};
+
 namespace details {
 
 class PairedTagBase : public ::pltxt2htm::PlTxtNode {
@@ -95,6 +129,25 @@ public:
     constexpr PairedTagBase& operator=(PairedTagBase const&) noexcept = delete;
     constexpr PairedTagBase& operator=(PairedTagBase&&) noexcept = default;
 
+    /**
+     * @note Nodes under it are destroyed with an explicit stack instead of recursion, because the nesting of tags is
+     *       only bounded by the pl-text: the children of a paired tag are moved to the stack before it is destroyed.
+     */
+    constexpr ~PairedTagBase() noexcept {
+        ::pltxt2htm::Ast pending{::std::move(this->subast_)};
+        while (!pending.empty()) {
+            auto node{::std::move(pending.back())};
+            pending.pop_back();
+            if (::pltxt2htm::details::is_paired_tag(node->node_type())) {
+                auto& subast = static_cast<PairedTagBase*>(node.get_unsafe())->subast_;
+                for (auto& child : subast) {
+                    pending.push_back(::std::move(child));
+                }
+                subast.clear();
+            }
+        }
+    }
+
     [[nodiscard]]
     constexpr auto&& get_subast(this auto&& self) noexcept {
         return ::std::forward_like<decltype(self)>(self.subast_);
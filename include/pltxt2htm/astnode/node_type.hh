@@ -14,6 +14,8 @@ enum class NodeType : ::std::uint_least32_t {
     u8char,
     // invalid utf-8 char
     invalid_u8char,
+    // contiguous utf-8 chars borrowed from the pl-text
+    text_run,
     // text
     text,
 
@@ -163,4 +165,83 @@ enum class NodeType : ::std::uint_least32_t {
     // latex,
 };
 
+namespace details {
+
+/**
+ * @brief Whether nodes of the type derive from PairedTagBase
+ */
+[[nodiscard]]
+constexpr bool is_paired_tag(::pltxt2htm::NodeType node_type) noexcept {
+    switch (node_type) {
+    case ::pltxt2htm::NodeType::text:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::pl_color:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::pl_a:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::pl_experiment:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::pl_discussion:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::pl_user:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::pl_size:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::pl_b:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::pl_i:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::html_p:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::html_h1:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::html_h2:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::html_h3:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::html_h4:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::html_h5:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::html_h6:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::html_del:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::html_note:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::html_em:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::html_strong:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::html_ul:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::html_li:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::html_code:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::html_pre:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::md_atx_h1:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::md_atx_h2:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::md_atx_h3:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::md_atx_h4:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::md_atx_h5:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::md_atx_h6:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::md_code_fence: {
+        return true;
+    }
+    default: {
+        return false;
+    }
+    }
+}
+
+} // namespace details
+
 } // namespace pltxt2htm
\ No newline at end of file
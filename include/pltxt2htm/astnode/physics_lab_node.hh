@@ -6,7 +6,7 @@
  */
 
 #include <utility>
-#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
 #include <exception/exception.hh>
 #include "basic.hh"
 
@@ -19,14 +19,14 @@ namespace pltxt2htm {
  *          - <COLOR=xxx>...</COLOR>
  */
 class Color : public ::pltxt2htm::details::PairedTagBase {
-    ::fast_io::u8string color_;
+    ::fast_io::u8string_view color_;
 
 public:
     constexpr Color() noexcept = delete;
 
-    constexpr Color(::pltxt2htm::Ast&& text, ::fast_io::u8string&& color) noexcept
+    constexpr Color(::pltxt2htm::Ast&& text, ::fast_io::u8string_view color) noexcept
         : ::pltxt2htm::details::PairedTagBase{::pltxt2htm::NodeType::pl_color, ::std::move(text)},
-          color_(::std::move(color)) {
+          color_(color) {
     }
 
     constexpr Color(::pltxt2htm::Color const&) noexcept = default;
@@ -46,7 +46,7 @@ public:
 };
 
 class A : public ::pltxt2htm::details::PairedTagBase {
-    ::fast_io::u8string color_;
+    ::fast_io::u8string_view color_;
 
 public:
     constexpr A() noexcept = delete;
@@ -83,14 +83,14 @@ public:
  *          - <EXPERIMENT=xxx>...</EXPERIMENT>
  */
 class Experiment : public ::pltxt2htm::details::PairedTagBase {
-    ::fast_io::u8string id_;
+    ::fast_io::u8string_view id_;
 
 public:
     constexpr Experiment() noexcept = delete;
 
-    constexpr Experiment(::pltxt2htm::Ast&& subast, ::fast_io::u8string&& id) noexcept
+    constexpr Experiment(::pltxt2htm::Ast&& subast, ::fast_io::u8string_view id) noexcept
         : ::pltxt2htm::details::PairedTagBase{::pltxt2htm::NodeType::pl_experiment, ::std::move(subast)},
-          id_(::std::move(id)) {
+          id_(id) {
     }
 
     constexpr Experiment(::pltxt2htm::Experiment const&) noexcept = default;
@@ -116,14 +116,14 @@ public:
  *          - <DISCUSSION=xxx>...</DISCUSSION>
  */
 class Discussion : public ::pltxt2htm::details::PairedTagBase {
-    ::fast_io::u8string id_{};
+    ::fast_io::u8string_view id_{};
 
 public:
     constexpr Discussion() noexcept = delete;
 
-    constexpr Discussion(::pltxt2htm::Ast&& subast, ::fast_io::u8string&& id) noexcept
+    constexpr Discussion(::pltxt2htm::Ast&& subast, ::fast_io::u8string_view id) noexcept
         : ::pltxt2htm::details::PairedTagBase{::pltxt2htm::NodeType::pl_discussion, ::std::move(subast)},
-          id_(::std::move(id)) {
+          id_(id) {
     }
 
     constexpr Discussion(::pltxt2htm::Discussion const&) noexcept = default;
@@ -147,14 +147,14 @@ public:
  * @example - <user=xxx>...</user>
  */
 class User : public ::pltxt2htm::details::PairedTagBase {
-    ::fast_io::u8string id_{};
+    ::fast_io::u8string_view id_{};
 
 public:
     constexpr User() noexcept = delete;
 
-    constexpr User(::pltxt2htm::Ast&& subast, ::fast_io::u8string&& id) noexcept
+    constexpr User(::pltxt2htm::Ast&& subast, ::fast_io::u8string_view id) noexcept
         : ::pltxt2htm::details::PairedTagBase{::pltxt2htm::NodeType::pl_user, ::std::move(subast)},
-          id_(::std::move(id)) {
+          id_(id) {
     }
 
     constexpr User(::pltxt2htm::User const&) noexcept = default;
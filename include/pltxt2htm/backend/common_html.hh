@@ -1,12 +1,13 @@
 #pragma once
 
-#include <fast_io/fast_io_dsal/list.h>
 #include <fast_io/fast_io_dsal/array.h>
-#include <fast_io/fast_io_dsal/stack.h>
 #include <fast_io/fast_io_dsal/vector.h>
 #include <fast_io/fast_io_dsal/string.h>
 #include <fast_io/fast_io_dsal/string_view.h>
 #include "frame_context.hh"
+#include "advanced_html.hh"
+#include "../flat_ast.hh"
+#include "../sink.hh"
 #include "../utils.hh"
 #include "../astnode/basic.hh"
 #include "../astnode/physics_lab_node.hh"
@@ -15,251 +16,368 @@
 namespace pltxt2htm::details {
 
 /**
- * @brief Translate pl-text's ast to common html(only enable color, b and i tag).
- *        usually be used to render header
+ * @brief Html of the nodes in common html, shared by `ast2common_html` and `DirectRenderer`.
+ * @note Only color, b and i tags are rendered, other tags are transparent.
  */
 template<bool ndebug>
-constexpr auto ast2common_html(::pltxt2htm::Ast const& ast_init)
+class CommonHtmlEmitter {
+public:
+    /**
+     * @brief Write a node whose html depends on neither children nor payload.
+     */
+    template<::pltxt2htm::html_sink Sink>
+    constexpr void leaf(this CommonHtmlEmitter const&, ::pltxt2htm::NodeType node_type, Sink& result)
 #if __cpp_exceptions < 199711L
-    noexcept
+        noexcept
 #endif
-    -> ::fast_io::u8string {
-    ::fast_io::u8string result{};
-    ::fast_io::stack<::pltxt2htm::details::BackendBasicFrameContext,
-                     ::fast_io::list<::pltxt2htm::details::BackendBasicFrameContext>>
-        call_stack{};
-    call_stack.push(::pltxt2htm::details::BackendBasicFrameContext(ast_init, ::pltxt2htm::NodeType::base, 0));
-
-restart:
-    auto&& ast = call_stack.top().ast_;
-    auto&& current_index = call_stack.top().current_index_;
-    for (; current_index < ast.size(); ++current_index) {
-        auto&& node = ::pltxt2htm::details::vector_index<ndebug>(ast, current_index);
-
-        switch (node->node_type()) {
-        case ::pltxt2htm::NodeType::u8char: {
-            result.push_back(reinterpret_cast<::pltxt2htm::U8Char const*>(node.release_imul())->get_u8char());
-            break;
-        }
-        case ::pltxt2htm::NodeType::invalid_u8char: {
-            auto escape_str = ::fast_io::array{char8_t{0xef}, 0xbf, 0xbd};
-            result.append(::fast_io::u8string_view{escape_str.data(), escape_str.size()});
-            break;
-        }
-        case ::pltxt2htm::NodeType::space: {
-            auto escape_str = ::fast_io::array{u8'&', u8'n', u8'b', u8's', u8'p', u8';'};
-            result.append(::fast_io::u8string_view{escape_str.data(), escape_str.size()});
-            break;
-        }
-        case ::pltxt2htm::NodeType::md_escape_ampersand:
-            [[fallthrough]];
-        case ::pltxt2htm::NodeType::ampersand: {
-            auto escape_str = ::fast_io::array{u8'&', u8'a', u8'm', u8'p', u8';'};
-            result.append(::fast_io::u8string_view{escape_str.data(), escape_str.size()});
-            break;
-        }
-        case ::pltxt2htm::NodeType::md_escape_single_quote:
-            [[fallthrough]];
-        case ::pltxt2htm::NodeType::single_quote: {
-            auto escape_str = ::fast_io::array{u8'&', u8'a', u8'p', u8'o', u8's', u8';'};
-            result.append(::fast_io::u8string_view{escape_str.data(), escape_str.size()});
-            break;
-        }
-        case ::pltxt2htm::NodeType::md_escape_double_quote:
+    {
+        switch (node_type) {
+        case ::pltxt2htm::NodeType::line_break:
             [[fallthrough]];
-        case ::pltxt2htm::NodeType::double_quote: {
-            auto escape_str = ::fast_io::array{u8'&', u8'q', u8'u', u8'o', u8't', u8';'};
-            result.append(::fast_io::u8string_view{escape_str.data(), escape_str.size()});
-            break;
-        }
-        case ::pltxt2htm::NodeType::md_escape_less_than:
+        case ::pltxt2htm::NodeType::html_br:
             [[fallthrough]];
-        case ::pltxt2htm::NodeType::less_than: {
-            auto escape_str = ::fast_io::array{u8'&', u8'l', u8't', u8';'};
-            result.append(::fast_io::u8string_view{escape_str.data(), escape_str.size()});
-            break;
-        }
-        case ::pltxt2htm::NodeType::md_escape_greater_than:
+        case ::pltxt2htm::NodeType::md_hr:
             [[fallthrough]];
-        case ::pltxt2htm::NodeType::greater_than: {
-            auto escape_str = ::fast_io::array{u8'&', u8'g', u8't', u8';'};
-            result.append(::fast_io::u8string_view{escape_str.data(), escape_str.size()});
+        case ::pltxt2htm::NodeType::html_hr: {
             break;
         }
-        case ::pltxt2htm::NodeType::tab: {
-            auto escape_str =
-                ::fast_io::array{u8'&', u8'n', u8'b', u8's', u8'p', u8';', u8'&', u8'n', u8'b', u8's', u8'p', u8';',
-                                 u8'&', u8'n', u8'b', u8's', u8'p', u8';', u8'&', u8'n', u8'b', u8's', u8'p', u8';'};
-            result.append(::fast_io::u8string_view{escape_str.data(), escape_str.size()});
+        default: {
+            // escaped chars are the same as advanced html
+            ::pltxt2htm::details::AdvancedHtmlEmitter<ndebug>{}.leaf(node_type, result);
             break;
         }
-        case ::pltxt2htm::NodeType::line_break:
-            [[fallthrough]];
-        case ::pltxt2htm::NodeType::html_br: {
-            break;
         }
+    }
+
+    /**
+     * @brief Write the opening tag of a node with children.
+     * @param str: Color of pl_color and pl_a, unused otherwise
+     */
+    template<::pltxt2htm::html_sink Sink>
+    constexpr void open_tag(this CommonHtmlEmitter const&, ::pltxt2htm::NodeType node_type,
+                            ::fast_io::u8string_view str, ::std::size_t, Sink& result)
+#if __cpp_exceptions < 199711L
+        noexcept
+#endif
+    {
+        switch (node_type) {
         case ::pltxt2htm::NodeType::pl_color:
             [[fallthrough]];
         case ::pltxt2htm::NodeType::pl_a: {
             // <a> and <color> is the same tag&struct in fact
-            auto color = reinterpret_cast<::pltxt2htm::Color const*>(node.release_imul());
-            call_stack.push(::pltxt2htm::details::BackendBasicFrameContext(color->get_subast(),
-                                                                           ::pltxt2htm::NodeType::pl_color, 0));
-            ++current_index;
             auto close_tag1 = ::fast_io::array{u8'<', u8's', u8'p',  u8'a', u8'n', u8' ', u8's', u8't', u8'y', u8'l',
                                                u8'e', u8'=', u8'\"', u8'c', u8'o', u8'l', u8'o', u8'r', u8':'};
             result.append(::fast_io::u8string_view{close_tag1.data(), close_tag1.size()});
-            result.append(color->get_color());
+            result.append(str);
             auto close_tag2 = ::fast_io::array{u8';', u8'\"', u8'>'};
             result.append(::fast_io::u8string_view{close_tag2.data(), close_tag2.size()});
-            goto restart;
+            break;
         }
         case ::pltxt2htm::NodeType::html_strong:
             [[fallthrough]];
         case ::pltxt2htm::NodeType::pl_b: {
-            auto b = reinterpret_cast<::pltxt2htm::details::PairedTagBase const*>(node.release_imul());
-            call_stack.push(
-                ::pltxt2htm::details::BackendBasicFrameContext(b->get_subast(), ::pltxt2htm::NodeType::pl_b, 0));
-            ++current_index;
             auto start_tag = ::fast_io::array{u8'<', u8's', u8't', u8'r', u8'o', u8'n', u8'g', u8'>'};
             result.append(::fast_io::u8string_view{start_tag.data(), start_tag.size()});
-            goto restart;
+            break;
         }
         case ::pltxt2htm::NodeType::pl_i:
             [[fallthrough]];
         case ::pltxt2htm::NodeType::html_em: {
-            auto em = reinterpret_cast<::pltxt2htm::details::PairedTagBase const*>(node.release_imul());
-            call_stack.push(
-                ::pltxt2htm::details::BackendBasicFrameContext(em->get_subast(), ::pltxt2htm::NodeType::html_em, 0));
-            ++current_index;
             auto start_tag = ::fast_io::array{u8'<', u8'e', u8'm', u8'>'};
             result.append(::fast_io::u8string_view(start_tag.begin(), start_tag.size()));
-            goto restart;
-        }
-        case ::pltxt2htm::NodeType::md_escape_backslash: {
-            result.push_back(u8'\\');
-            break;
-        }
-        case ::pltxt2htm::NodeType::md_escape_exclamation: {
-            result.push_back(u8'!');
-            break;
-        }
-        case ::pltxt2htm::NodeType::md_escape_hash: {
-            result.push_back(u8'#');
-            break;
-        }
-        case ::pltxt2htm::NodeType::md_escape_dollar: {
-            result.push_back(u8'$');
-            break;
-        }
-        case ::pltxt2htm::NodeType::md_escape_percent: {
-            result.push_back(u8'%');
             break;
         }
-        case ::pltxt2htm::NodeType::md_escape_left_paren: {
-            result.push_back(u8'(');
-            break;
-        }
-        case ::pltxt2htm::NodeType::md_escape_right_paren: {
-            result.push_back(u8')');
-            break;
-        }
-        case ::pltxt2htm::NodeType::md_escape_asterisk: {
-            result.push_back(u8'*');
-            break;
-        }
-        case ::pltxt2htm::NodeType::md_escape_plus: {
-            result.push_back(u8'+');
-            break;
-        }
-        case ::pltxt2htm::NodeType::md_escape_comma: {
-            result.push_back(u8',');
+        default: {
             break;
         }
-        case ::pltxt2htm::NodeType::md_escape_hyphen: {
-            result.push_back(u8'-');
-            break;
         }
-        case ::pltxt2htm::NodeType::md_escape_dot: {
-            result.push_back(u8'.');
+    }
+
+    /**
+     * @brief Write the closing tag of a node with children.
+     */
+    template<::pltxt2htm::html_sink Sink>
+    constexpr void close_tag(this CommonHtmlEmitter const&, ::pltxt2htm::NodeType node_type, Sink& result)
+#if __cpp_exceptions < 199711L
+        noexcept
+#endif
+    {
+        switch (node_type) {
+        case ::pltxt2htm::NodeType::html_strong:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_b: {
+            auto close_tag = ::fast_io::array{u8'<', u8'/', u8's', u8't', u8'r', u8'o', u8'n', u8'g', u8'>'};
+            result.append(::fast_io::u8string_view{close_tag.data(), close_tag.size()});
             break;
         }
-        case ::pltxt2htm::NodeType::md_escape_slash: {
-            result.push_back(u8'/');
+        case ::pltxt2htm::NodeType::html_em:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_i: {
+            auto close_tag = ::fast_io::array{u8'<', u8'/', u8'e', u8'm', u8'>'};
+            result.append(::fast_io::u8string_view{close_tag.data(), close_tag.size()});
             break;
         }
-        case ::pltxt2htm::NodeType::md_escape_colon: {
-            result.push_back(u8':');
+        case ::pltxt2htm::NodeType::pl_a:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_color: {
+            auto close_tag = ::fast_io::array{u8'<', u8'/', u8's', u8'p', u8'a', u8'n', u8'>'};
+            result.append(::fast_io::u8string_view{close_tag.data(), close_tag.size()});
             break;
         }
-        case ::pltxt2htm::NodeType::md_escape_semicolon: {
-            result.push_back(u8';');
+        default: {
             break;
         }
-        case ::pltxt2htm::NodeType::md_escape_equals: {
-            result.push_back(u8'=');
-            break;
         }
-        case ::pltxt2htm::NodeType::md_escape_question: {
-            result.push_back(u8'?');
+    }
+};
+
+/**
+ * @brief Translate pl-text's ast to common html(only enable color, b and i tag).
+ *        usually be used to render header
+ * @param [in] ast: FlatAst or FlatAstView of a mapped image
+ * @param [out] result: Sink which the html is appended to
+ */
+template<bool ndebug, ::pltxt2htm::flat_ast_like FlatAstType, ::pltxt2htm::html_sink Sink>
+constexpr void ast2common_html(FlatAstType const& ast, Sink& result)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    ::pltxt2htm::details::CommonHtmlEmitter<ndebug> const emitter{};
+    ::pltxt2htm::details::FrameStack<::pltxt2htm::details::BackendBasicFrameContext> call_stack{};
+    call_stack.emplace(::pltxt2htm::NodeType::base, ast.first_child(0));
+
+restart:
+    auto&& current_index = call_stack.top().current_index_;
+    for (; current_index != ::pltxt2htm::FlatAst::npos; current_index = ast.next_sibling(current_index)) {
+        auto const node = current_index;
+        auto const node_type = ast.node_type(node);
+
+        switch (node_type) {
+        case ::pltxt2htm::NodeType::u8char: {
+            result.push_back(static_cast<char8_t>(ast.get_num(node)));
             break;
         }
-        case ::pltxt2htm::NodeType::md_escape_at: {
-            result.push_back(u8'@');
+        case ::pltxt2htm::NodeType::text_run: {
+            result.append(ast.get_str(node));
             break;
         }
-        case ::pltxt2htm::NodeType::md_escape_left_bracket: {
-            result.push_back(u8'[');
-            break;
+        case ::pltxt2htm::NodeType::pl_color:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_a: {
+            current_index = ast.next_sibling(node);
+            call_stack.emplace(node_type, ast.first_child(node));
+            emitter.open_tag(node_type, ast.get_str(node), 0, result);
+            goto restart;
         }
-        case ::pltxt2htm::NodeType::md_escape_right_bracket: {
-            result.push_back(u8']');
-            break;
+        case ::pltxt2htm::NodeType::html_strong:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_b:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_i:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::html_em: {
+            current_index = ast.next_sibling(node);
+            call_stack.emplace(node_type, ast.first_child(node));
+            emitter.open_tag(node_type, ::fast_io::u8string_view{}, 0, result);
+            goto restart;
         }
-        case ::pltxt2htm::NodeType::md_escape_caret: {
-            result.push_back(u8'^');
+        case ::pltxt2htm::NodeType::invalid_u8char:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::space:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_ampersand:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::ampersand:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_single_quote:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::single_quote:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_double_quote:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::double_quote:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_less_than:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::less_than:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_greater_than:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::greater_than:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::tab:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::line_break:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::html_br:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_backslash:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_exclamation:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_hash:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_dollar:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_percent:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_left_paren:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_right_paren:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_asterisk:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_plus:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_comma:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_hyphen:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_dot:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_slash:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_colon:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_semicolon:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_equals:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_question:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_at:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_left_bracket:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_right_bracket:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_caret:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_underscore:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_backtick:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_left_brace:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_pipe:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_right_brace:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_escape_tilde:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_hr:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::html_hr:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::html_note: {
+            emitter.leaf(node_type, result);
             break;
         }
-        case ::pltxt2htm::NodeType::md_escape_underscore: {
-            result.push_back(u8'_');
-            break;
+        default: {
+            auto const first_child = ast.first_child(node);
+            if (first_child == ::pltxt2htm::FlatAst::npos) {
+                // Optimization: if the tag is empty, we can skip it
+                break;
+            }
+            current_index = ast.next_sibling(node);
+            call_stack.emplace(::pltxt2htm::NodeType::base, first_child);
+            goto restart;
         }
-        case ::pltxt2htm::NodeType::md_escape_backtick: {
-            result.push_back(u8'`');
-            break;
         }
-        case ::pltxt2htm::NodeType::md_escape_left_brace: {
-            result.push_back(u8'{');
-            break;
+    }
+
+    {
+        auto top_frame = ::std::move(call_stack.top());
+        call_stack.pop();
+        if (call_stack.empty()) {
+            return;
+        } else {
+            emitter.close_tag(top_frame.nested_tag_type_, result);
+            goto restart;
         }
-        case ::pltxt2htm::NodeType::md_escape_pipe: {
-            result.push_back(u8'|');
+    }
+}
+
+/**
+ * @brief Translate pl-text's flat ast to a new string of common html.
+ */
+template<bool ndebug, ::pltxt2htm::flat_ast_like FlatAstType>
+constexpr auto ast2common_html(FlatAstType const& ast)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+    -> ::fast_io::u8string {
+    ::fast_io::u8string result{};
+    ::pltxt2htm::details::ast2common_html<ndebug>(ast, result);
+    return result;
+}
+
+/**
+ * @brief Translate pl-text's ast to common html, the same html as rendering the flat ast of `ast_init`.
+ * @param [out] result: Sink which the html is appended to
+ * @note The ast is rendered where it is, see the note of `ast2advanced_html`.
+ */
+template<bool ndebug, ::pltxt2htm::html_sink Sink>
+constexpr void ast2common_html(::pltxt2htm::Ast const& ast_init, Sink& result)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    ::pltxt2htm::details::CommonHtmlEmitter<ndebug> const emitter{};
+    ::pltxt2htm::details::FrameStack<::pltxt2htm::details::BackendAstFrameContext> call_stack{};
+    call_stack.emplace(ast_init, ::pltxt2htm::NodeType::base);
+
+restart:
+    auto&& frame = call_stack.top();
+    for (; frame.current_index_ < frame.ast_.size(); ++frame.current_index_) {
+        auto&& node = ::pltxt2htm::details::vector_index<ndebug>(frame.ast_, frame.current_index_);
+        auto const node_type = node->node_type();
+
+        switch (node_type) {
+        case ::pltxt2htm::NodeType::u8char: {
+            result.push_back(reinterpret_cast<::pltxt2htm::U8Char const*>(node.release_imul())->get_u8char());
             break;
         }
-        case ::pltxt2htm::NodeType::md_escape_right_brace: {
-            result.push_back(u8'}');
+        case ::pltxt2htm::NodeType::text_run: {
+            result.append(reinterpret_cast<::pltxt2htm::TextRun const*>(node.release_imul())->get_text());
             break;
         }
-        case ::pltxt2htm::NodeType::md_escape_tilde: {
-            result.push_back(u8'~');
-            break;
+        case ::pltxt2htm::NodeType::pl_color:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_a: {
+            auto const color = reinterpret_cast<::pltxt2htm::Color const*>(node.release_imul());
+            ++frame.current_index_;
+            call_stack.emplace(color->get_subast(), node_type);
+            emitter.open_tag(node_type, color->get_color(), 0, result);
+            goto restart;
         }
-        case ::pltxt2htm::NodeType::md_hr:
+        case ::pltxt2htm::NodeType::html_strong:
             [[fallthrough]];
-        case ::pltxt2htm::NodeType::html_hr:
+        case ::pltxt2htm::NodeType::pl_b:
             [[fallthrough]];
-        case ::pltxt2htm::NodeType::html_note: {
-            break;
+        case ::pltxt2htm::NodeType::pl_i:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::html_em: {
+            auto const paired_tag = reinterpret_cast<::pltxt2htm::details::PairedTagBase const*>(node.release_imul());
+            ++frame.current_index_;
+            call_stack.emplace(paired_tag->get_subast(), node_type);
+            emitter.open_tag(node_type, ::fast_io::u8string_view{}, 0, result);
+            goto restart;
         }
         default: {
-            auto a_paired_tag = reinterpret_cast<::pltxt2htm::details::PairedTagBase const*>(node.release_imul());
-            if (a_paired_tag->get_subast().empty()) {
+            if (!::pltxt2htm::details::is_paired_tag(node_type)) {
+                emitter.leaf(node_type, result);
+                break;
+            }
+            auto&& subast =
+                reinterpret_cast<::pltxt2htm::details::PairedTagBase const*>(node.release_imul())->get_subast();
+            if (subast.empty()) {
                 // Optimization: if the tag is empty, we can skip it
                 break;
             }
-            call_stack.push(::pltxt2htm::details::BackendBasicFrameContext(a_paired_tag->get_subast(),
-                                                                           ::pltxt2htm::NodeType::base, 0));
-            ++current_index;
+            ++frame.current_index_;
+            call_stack.emplace(subast, ::pltxt2htm::NodeType::base);
             goto restart;
         }
         }
@@ -269,40 +387,26 @@ restart:
         auto top_frame = ::std::move(call_stack.top());
         call_stack.pop();
         if (call_stack.empty()) {
-            return result;
+            return;
         } else {
-            switch (top_frame.nested_tag_type_) {
-            case ::pltxt2htm::NodeType::html_strong:
-                [[fallthrough]];
-            case ::pltxt2htm::NodeType::pl_b: {
-                auto close_tag = ::fast_io::array{u8'<', u8'/', u8's', u8't', u8'r', u8'o', u8'n', u8'g', u8'>'};
-                result.append(::fast_io::u8string_view{close_tag.data(), close_tag.size()});
-                goto restart;
-            }
-            case ::pltxt2htm::NodeType::html_em:
-                [[fallthrough]];
-            case ::pltxt2htm::NodeType::pl_i: {
-                auto close_tag = ::fast_io::array{u8'<', u8'/', u8'e', u8'm', u8'>'};
-                result.append(::fast_io::u8string_view{close_tag.data(), close_tag.size()});
-                goto restart;
-            }
-            case ::pltxt2htm::NodeType::pl_a:
-                [[fallthrough]];
-            case ::pltxt2htm::NodeType::pl_color: {
-                auto close_tag = ::fast_io::array{u8'<', u8'/', u8's', u8'p', u8'a', u8'n', u8'>'};
-                result.append(::fast_io::u8string_view{close_tag.data(), close_tag.size()});
-                goto restart;
-            }
-            case ::pltxt2htm::NodeType::base: {
-                goto restart;
-            }
-            default:
-                [[unlikely]] {
-                    ::exception::unreachable<ndebug>();
-                }
-            }
+            emitter.close_tag(top_frame.nested_tag_type_, result);
+            goto restart;
         }
     }
 }
 
+/**
+ * @brief Translate pl-text's ast to a new string of common html.
+ */
+template<bool ndebug>
+constexpr auto ast2common_html(::pltxt2htm::Ast const& ast)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+    -> ::fast_io::u8string {
+    ::fast_io::u8string result{};
+    ::pltxt2htm::details::ast2common_html<ndebug>(ast, result);
+    return result;
+}
+
 } // namespace pltxt2htm::details
@@ -1,22 +1,23 @@
 #pragma once
 
+#include <cstddef>
 #include <fast_io/fast_io_dsal/vector.h>
 #include <fast_io/fast_io_dsal/string_view.h>
 #include "../astnode/basic.hh"
+#include "../astnode/node_type.hh"
+#include "../flat_ast.hh"
 
 namespace pltxt2htm::details {
 
 class BackendBasicFrameContext {
 public:
-    ::pltxt2htm::Ast const& ast_;
     ::pltxt2htm::NodeType const nested_tag_type_;
-    // TODO How about store iterator?
-    ::std::size_t current_index_;
+    // index of the current node in FlatAst
+    ::pltxt2htm::FlatAst::index_type current_index_;
 
-    BackendBasicFrameContext(::pltxt2htm::Ast const& ast, ::pltxt2htm::NodeType const nested_tag_type,
-                             ::std::size_t current_index) noexcept
-        : ast_(ast),
-          nested_tag_type_{nested_tag_type},
+    BackendBasicFrameContext(::pltxt2htm::NodeType const nested_tag_type,
+                             ::pltxt2htm::FlatAst::index_type current_index) noexcept
+        : nested_tag_type_{nested_tag_type},
           current_index_{current_index} {
     }
 
@@ -32,4 +33,31 @@ public:
         ::pltxt2htm::details::BackendBasicFrameContext&&) noexcept = delete;
 };
 
+/**
+ * @brief Frame of the backends which render the ast without flattening it.
+ */
+class BackendAstFrameContext {
+public:
+    ::pltxt2htm::Ast const& ast_;
+    ::pltxt2htm::NodeType const nested_tag_type_;
+    ::std::size_t current_index_;
+
+    BackendAstFrameContext(::pltxt2htm::Ast const& ast, ::pltxt2htm::NodeType const nested_tag_type) noexcept
+        : ast_(ast),
+          nested_tag_type_{nested_tag_type},
+          current_index_{} {
+    }
+
+    constexpr BackendAstFrameContext(::pltxt2htm::details::BackendAstFrameContext const&) noexcept = default;
+    constexpr BackendAstFrameContext(::pltxt2htm::details::BackendAstFrameContext&&) noexcept = default;
+
+    constexpr ~BackendAstFrameContext() noexcept = default;
+
+    // const reference do not support operator=
+    constexpr ::pltxt2htm::details::BackendAstFrameContext& operator=(
+        ::pltxt2htm::details::BackendAstFrameContext const&) noexcept = delete;
+    constexpr ::pltxt2htm::details::BackendAstFrameContext& operator=(
+        ::pltxt2htm::details::BackendAstFrameContext&&) noexcept = delete;
+};
+
 } // namespace pltxt2htm::details
@@ -0,0 +1,296 @@
+#pragma once
+
+/**
+ * @file batch.hh
+ * @brief Convert many documents on a work-stealing pool of threads
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <span>
+#if !defined(__wasi__) || defined(_REENTRANT)
+    // wasm32-wasip1 has no threads, whose libc++ rejects including <thread>
+    #include <thread>
+#endif
+#include <fast_io/fast_io_dsal/vector.h>
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <exception/exception.hh>
+#include "arena.hh"
+#include "parser.hh"
+#include "optimizer.hh"
+#include "backend/advanced_html.hh"
+#include "backend/common_html.hh"
+
+namespace pltxt2htm {
+
+/**
+ * @brief Which html the documents of a batch are rendered to.
+ */
+enum class BatchHtml : ::std::uint_least8_t {
+    advanced, // the one of `pltxt2advanced_html`
+    fixedadv, // the one of `pltxt2fixedadv_html`
+    common,   // the one of `pltxt2common_html`, host is ignored
+};
+
+struct BatchOptions {
+    ::pltxt2htm::BatchHtml html{::pltxt2htm::BatchHtml::advanced};
+    /**
+     * @brief Whether optimize the ast like the template argument `optimize` of the render functions
+     */
+    bool optimize{true};
+    /**
+     * @brief Number of threads including the calling one, 0 means `::std::thread::hardware_concurrency()`
+     */
+    ::std::size_t threads{};
+};
+
+namespace details {
+
+/**
+ * @brief Indexes [begin, end) of the documents which a worker has not converted yet, packed in one atomic word.
+ * @note The owner takes documents from the front one by one, and idle workers steal the back half.
+ *       Therefore a worker stuck on a large document gives away the rest of its range.
+ */
+class alignas(64) WorkRange {
+    ::std::atomic<::std::uint_least64_t> range_{};
+
+    [[nodiscard]]
+    static constexpr ::std::uint_least64_t pack_(::std::uint_least32_t begin, ::std::uint_least32_t end) noexcept {
+        return (static_cast<::std::uint_least64_t>(begin) << 32) | end;
+    }
+
+public:
+    /**
+     * @brief Replace the range of the owner, which must be empty.
+     */
+    void assign(this WorkRange& self, ::std::uint_least32_t begin, ::std::uint_least32_t end) noexcept {
+        self.range_.store(::pltxt2htm::details::WorkRange::pack_(begin, end), ::std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Take the first index of the range, called by the owner.
+     */
+    [[nodiscard]]
+    bool pop_front(this WorkRange& self, ::std::uint_least32_t& index) noexcept {
+        auto range = self.range_.load(::std::memory_order_relaxed);
+        while (true) {
+            auto const begin = static_cast<::std::uint_least32_t>(range >> 32);
+            auto const end = static_cast<::std::uint_least32_t>(range);
+            if (begin >= end) {
+                return false;
+            }
+            if (self.range_.compare_exchange_weak(range, ::pltxt2htm::details::WorkRange::pack_(begin + 1, end),
+                                                  ::std::memory_order_relaxed)) {
+                index = begin;
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Take the back half (at least one index) of the range, called by the other workers.
+     */
+    [[nodiscard]]
+    bool steal_back(this WorkRange& self, ::std::uint_least32_t& stolen_begin,
+                    ::std::uint_least32_t& stolen_end) noexcept {
+        auto range = self.range_.load(::std::memory_order_relaxed);
+        while (true) {
+            auto const begin = static_cast<::std::uint_least32_t>(range >> 32);
+            auto const end = static_cast<::std::uint_least32_t>(range);
+            if (begin >= end) {
+                return false;
+            }
+            auto const mid = static_cast<::std::uint_least32_t>(begin + (end - begin) / 2);
+            if (self.range_.compare_exchange_weak(range, ::pltxt2htm::details::WorkRange::pack_(begin, mid),
+                                                  ::std::memory_order_relaxed)) {
+                stolen_begin = mid;
+                stolen_end = end;
+                return true;
+            }
+        }
+    }
+};
+
+/**
+ * @brief State that a worker reuses across the documents it converts.
+ * @note The nodes of a document are allocated from `arena_` which is rewound after the ast is destroyed,
+ *       the html buffer keeps its capacity.
+ *       The frame stacks of the traversals are inline in most documents, therefore they are not kept here.
+ */
+template<bool ndebug>
+class BatchScratch {
+    ::pltxt2htm::details::NodeArena arena_{};
+    ::fast_io::u8string html_{};
+
+public:
+    /**
+     * @brief Convert `pltext` to html.
+     * @return View of the html, which is valid until the next call.
+     */
+    [[nodiscard]]
+    ::fast_io::u8string_view convert(this BatchScratch& self, ::fast_io::u8string_view pltext,
+                                     ::fast_io::u8string_view host, ::pltxt2htm::BatchOptions const& options)
+#if __cpp_exceptions < 199711L
+        noexcept
+#endif
+    {
+        {
+            ::pltxt2htm::details::NodeArenaScope const arena_scope{self.arena_};
+            ::pltxt2htm::details::AstBuilder<ndebug> builder{};
+            auto ast = ::pltxt2htm::details::parse_pltxt<ndebug>(pltext, builder);
+            if (options.optimize) {
+                ::pltxt2htm::optimize_ast<ndebug>(ast);
+            }
+
+            self.html_.clear();
+            switch (options.html) {
+            case ::pltxt2htm::BatchHtml::advanced: {
+                ::pltxt2htm::details::ast2advanced_html<ndebug>(ast, host, self.html_);
+                break;
+            }
+            case ::pltxt2htm::BatchHtml::fixedadv: {
+                ::pltxt2htm::details::ast2advanced_html<ndebug, false>(ast, host, self.html_);
+                break;
+            }
+            case ::pltxt2htm::BatchHtml::common: {
+                ::pltxt2htm::details::ast2common_html<ndebug>(ast, self.html_);
+                break;
+            }
+            }
+        }
+        self.arena_.rewind();
+
+        return ::fast_io::u8string_view{self.html_.data(), self.html_.size()};
+    }
+};
+
+/**
+ * @brief Invoke `func(scratch, index)` for each index in [0, size) on a work-stealing pool of `threads` threads,
+ *        including the calling one.
+ * @tparam Scratch: Default constructible state of a worker, e.g. `BatchScratch`, which is created by each
+ *                  worker once and passed to all the `func` it invokes
+ * @param threads: 0 means `::std::thread::hardware_concurrency()`, no more threads than `size` are started
+ */
+template<typename Scratch, typename Func>
+void work_stealing_for_each(::std::size_t const size, ::std::size_t threads, Func const& func)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    if (size == 0) {
+        return;
+    }
+    if (size > UINT_LEAST32_MAX) [[unlikely]] {
+        // too many documents is the same as bad alloc
+        ::exception::terminate();
+    }
+#if defined(__wasi__) && !defined(_REENTRANT)
+    threads = 1;
+#else
+    if (threads == 0) {
+        threads = ::std::thread::hardware_concurrency();
+    }
+#endif
+    if (threads > size) {
+        threads = size;
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    // indexes are split evenly at first, stealing balances the costs of them
+    ::std::unique_ptr<::pltxt2htm::details::WorkRange[]> ranges{new ::pltxt2htm::details::WorkRange[threads]};
+    for (::std::size_t i{}; i < threads; ++i) {
+        ranges[i].assign(static_cast<::std::uint_least32_t>(size * i / threads),
+                         static_cast<::std::uint_least32_t>(size * (i + 1) / threads));
+    }
+
+    auto const worker = [&ranges, threads, &func](::std::size_t id) {
+        Scratch scratch{};
+        while (true) {
+            ::std::uint_least32_t index;
+            while (ranges[id].pop_front(index)) {
+                func(scratch, static_cast<::std::size_t>(index));
+            }
+            bool stolen{};
+            for (::std::size_t i{1}; i < threads; ++i) {
+                ::std::uint_least32_t begin, end;
+                if (ranges[(id + i) % threads].steal_back(begin, end)) {
+                    ranges[id].assign(begin, end);
+                    stolen = true;
+                    break;
+                }
+            }
+            if (!stolen) {
+                // the indexes left are being processed by their owners
+                return;
+            }
+        }
+    };
+
+#if defined(__wasi__) && !defined(_REENTRANT)
+    worker(0);
+#else
+    ::fast_io::vector<::std::thread> pool{};
+    pool.reserve(threads - 1);
+    for (::std::size_t i{1}; i < threads; ++i) {
+        pool.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& thread : pool) {
+        thread.join();
+    }
+#endif
+}
+
+/**
+ * @brief Convert `pltexts` on a work-stealing pool, and pass each html to `consume(index, html)`.
+ * @note `consume` is invoked on the worker threads, each index once. The html it receives is only valid
+ *       during the call.
+ */
+template<bool ndebug, typename Consume>
+void run_batch(::std::span<::fast_io::u8string_view const> pltexts, ::fast_io::u8string_view host,
+               ::pltxt2htm::BatchOptions const& options, Consume const& consume)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    ::pltxt2htm::details::work_stealing_for_each<::pltxt2htm::details::BatchScratch<ndebug>>(
+        pltexts.size(), options.threads,
+        [pltexts, host, &options, &consume](::pltxt2htm::details::BatchScratch<ndebug>& scratch,
+                                            ::std::size_t index) {
+            consume(index, scratch.convert(pltexts[index], host, options));
+        });
+}
+
+} // namespace details
+
+/**
+ * @brief Convert many pl-texts to html on a pool of threads, like calling `pltxt2advanced_html` (or the one
+ *        chosen by `options.html`) for each of them.
+ * @tparam ndebug: Whether enable more debug checks like NDEBUG macro. show details in README.md Q/A
+ * @param options: see `BatchOptions`
+ * @return The htmls in the order of `pltexts`.
+ * @note Documents are taken from the pool by threads one by one, and an idle thread steals half of the documents
+ *       left to another one. Therefore a few large documents among many small ones do not leave threads idle.
+ */
+template<bool ndebug = false>
+[[nodiscard]]
+inline auto convert_batch(::std::span<::fast_io::u8string_view const> pltexts, ::fast_io::u8string_view host,
+                          ::pltxt2htm::BatchOptions const& options = {})
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+    -> ::fast_io::vector<::fast_io::u8string> {
+    ::fast_io::vector<::fast_io::u8string> result(pltexts.size());
+    ::pltxt2htm::details::run_batch<ndebug>(
+        pltexts, host, options, [&result](::std::size_t index, ::fast_io::u8string_view html) {
+            result.index_unchecked(index) = ::fast_io::u8string{html};
+        });
+    return result;
+}
+
+} // namespace pltxt2htm
@@ -0,0 +1,536 @@
+#pragma once
+
+/**
+ * @file direct_render.hh
+ * @brief Render html while parsing, without building the ast
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <fast_io/fast_io_dsal/vector.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <exception/exception.hh>
+#include "parser.hh"
+#include "frame_stack.hh"
+#include "sink.hh"
+#include "astnode/node_type.hh"
+
+namespace pltxt2htm::details {
+
+/**
+ * @brief Builder of the parser (see `AstBuilder`) which writes html to the sink as soon as the nodes are parsed.
+ * @tparam optimize: Whether the html is the same as the optimized ast (see `optimize_ast`).
+ * @tparam Emitter: `AdvancedHtmlEmitter` or `CommonHtmlEmitter`.
+ * @note The html is byte-identical to rendering the (optimized) ast, including the quirks of `optimize_ast`:
+ *       - a tag is merged with its only child only if the child is the same kind of tag, only once
+ *       - a tag which is the same as its parent is elided, its children are not optimized
+ *       - an inline tag without children after optimization is erased, therefore its opening tag is
+ *         pending until the first child which survives
+ *       - the optimization stops after the first block tag, the remaining nodes are rendered as is
+ *       Whether a tag is merged depends on its children, so the events from the opening tag of its first
+ *       child to the closing tag of that child are recorded and replayed once the merge is decided.
+ */
+template<bool ndebug, bool optimize, typename Emitter, ::pltxt2htm::html_sink Sink>
+class DirectRenderer {
+public:
+    class children_type {};
+
+    using call_stack_type = ::pltxt2htm::details::FrameStack<::pltxt2htm::details::BasicFrameContext<children_type>>;
+
+private:
+    enum class FrameState : ::std::uint_least8_t {
+        // the merge of the tag is not decided yet
+        undecided,
+        // opening tag is not written yet, the tag is erased if it has no child
+        pending,
+        opened,
+        elided,
+        // the only child of a merged tag, which has no tag
+        absorbed
+    };
+
+    class Frame {
+    public:
+        ::pltxt2htm::NodeType node_type;
+        FrameState state;
+        // block tags stop the optimization when they are closed
+        bool halts;
+        // attribute of the tag, see `AdvancedHtmlEmitter::open_tag`
+        ::fast_io::u8string_view str;
+        ::std::size_t num;
+    };
+
+    enum class EventKind : ::std::uint_least8_t {
+        leaf,
+        text,
+        open,
+        close
+    };
+
+    class Event {
+    public:
+        EventKind kind;
+        ::pltxt2htm::NodeType node_type;
+        // open: whether the tag is merged with its only child
+        bool merge;
+        // text, or attribute of open
+        ::fast_io::u8string_view str;
+        // size of open, or index of the open event of close
+        ::std::size_t num;
+    };
+
+    enum class Lookahead : ::std::uint_least8_t {
+        none,
+        // the top frame is mergeable, waiting for its first child
+        deciding,
+        // recording the first child of the top frame
+        recording,
+        // the first child is closed, the next event decides the merge
+        recorded
+    };
+
+    Emitter const& emitter_;
+    Sink& result_;
+    ::pltxt2htm::details::FrameStack<Frame> frames_{};
+    // frames below `opened_depth_` are not pending
+    ::std::size_t opened_depth_{1};
+    // number of elided frames, whose children are rendered as is
+    ::std::size_t raw_depth_{};
+    bool halted_{!optimize};
+    Lookahead lookahead_{Lookahead::none};
+    ::fast_io::vector<Event> events_{};
+    // indexes of the recorded open events which are not closed yet
+    ::fast_io::vector<::std::size_t> open_events_{};
+
+    [[nodiscard]]
+    static constexpr bool is_block_(::pltxt2htm::NodeType node_type) noexcept {
+        switch (node_type) {
+        case ::pltxt2htm::NodeType::html_p:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::html_h1:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::html_h2:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::html_h3:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::html_h4:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::html_h5:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::html_h6:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_atx_h1:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_atx_h2:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_atx_h3:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_atx_h4:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_atx_h5:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_atx_h6:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::html_ul:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::html_li:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::html_code:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::html_pre:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * @brief Whether `child` is merged into `parent` if it is the only child of `parent`.
+     */
+    [[nodiscard]]
+    static constexpr bool is_mergeable_(::pltxt2htm::NodeType parent, ::pltxt2htm::NodeType child) noexcept {
+        switch (parent) {
+        case ::pltxt2htm::NodeType::pl_color:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_a:
+            return child == ::pltxt2htm::NodeType::pl_color;
+        case ::pltxt2htm::NodeType::pl_experiment:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_discussion:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_user:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_size:
+            return child == parent;
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * @brief The tags which `optimize_ast` treats as the same.
+     */
+    [[nodiscard]]
+    static constexpr ::pltxt2htm::NodeType elision_kind_(::pltxt2htm::NodeType node_type) noexcept {
+        switch (node_type) {
+        case ::pltxt2htm::NodeType::pl_a:
+            return ::pltxt2htm::NodeType::pl_color;
+        case ::pltxt2htm::NodeType::pl_b:
+            return ::pltxt2htm::NodeType::html_strong;
+        case ::pltxt2htm::NodeType::pl_i:
+            return ::pltxt2htm::NodeType::html_em;
+        default:
+            return node_type;
+        }
+    }
+
+    /**
+     * @brief Whether `frame` is elided as the child of `parent`.
+     */
+    [[nodiscard]]
+    static constexpr bool is_elided_(Frame const& parent, Frame const& frame) noexcept {
+        auto const kind = elision_kind_(frame.node_type);
+        if (elision_kind_(parent.node_type) != kind) {
+            return false;
+        }
+        switch (kind) {
+        case ::pltxt2htm::NodeType::pl_color:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_experiment:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_discussion:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_user:
+            return parent.str == frame.str;
+        case ::pltxt2htm::NodeType::pl_size:
+            return parent.num == frame.num;
+        case ::pltxt2htm::NodeType::html_strong:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::html_em:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::html_del:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    [[nodiscard]]
+    constexpr bool is_optimizing_(this DirectRenderer const& self) noexcept {
+        return !self.halted_ && self.raw_depth_ == 0;
+    }
+
+    /**
+     * @brief Write the pending opening tags, since a child which survives the optimization is coming.
+     */
+    constexpr void flush_(this DirectRenderer& self) noexcept {
+        auto const size = self.frames_.size();
+        for (auto i = self.opened_depth_; i < size; ++i) {
+            auto&& frame = self.frames_.index_unchecked(i);
+            if (frame.state == FrameState::pending) {
+                self.emitter_.open_tag(frame.node_type, frame.str, frame.num, self.result_);
+                frame.state = FrameState::opened;
+            }
+        }
+        self.opened_depth_ = size;
+    }
+
+    /**
+     * @brief Decide the undecided top frame.
+     * @param merged_child: The open event of the only child which is merged, nullptr if not merged.
+     */
+    constexpr void resolve_(this DirectRenderer& self, Event const* merged_child) noexcept {
+        auto&& frame = self.frames_.top();
+        if (merged_child != nullptr) {
+            // move assigning the child copies its type
+            frame.node_type = merged_child->node_type;
+            frame.str = merged_child->str;
+            frame.num = merged_child->num;
+        }
+        if (is_elided_(self.frames_.index_unchecked(self.frames_.size() - 2), frame)) {
+            // an elided tag is replaced by its children, which survive
+            frame.state = FrameState::elided;
+            ++self.raw_depth_;
+            self.flush_();
+        } else {
+            frame.state = FrameState::pending;
+        }
+    }
+
+    /**
+     * @param lookahead: Whether the merge is decided by the following events, otherwise by `merged_child`.
+     * @return Whether the tag is merged with its only child.
+     */
+    constexpr bool open_(this DirectRenderer& self, Event const& event, bool lookahead,
+                         Event const* merged_child) noexcept {
+        if (bool const optimizing{self.is_optimizing_()}; !optimizing || is_block_(event.node_type)) {
+            self.flush_();
+            self.emitter_.open_tag(event.node_type, event.str, event.num, self.result_);
+            self.frames_.emplace(Frame{event.node_type, FrameState::opened, optimizing, event.str, event.num});
+            self.opened_depth_ = self.frames_.size();
+            return false;
+        }
+        self.frames_.emplace(Frame{event.node_type, FrameState::undecided, false, event.str, event.num});
+        if (is_mergeable_(event.node_type, ::pltxt2htm::NodeType::pl_color) ||
+            is_mergeable_(event.node_type, event.node_type)) {
+            if (lookahead) {
+                self.lookahead_ = Lookahead::deciding;
+                return false;
+            }
+            self.resolve_(merged_child);
+            return merged_child != nullptr;
+        }
+        self.resolve_(nullptr);
+        return false;
+    }
+
+    constexpr void close_(this DirectRenderer& self) noexcept {
+        auto const frame = self.frames_.top();
+        self.frames_.pop();
+        if (self.opened_depth_ > self.frames_.size()) {
+            self.opened_depth_ = self.frames_.size();
+        }
+        switch (frame.state) {
+        case FrameState::opened: {
+            self.emitter_.close_tag(frame.node_type, self.result_);
+            if (frame.halts) {
+                // `optimize_ast` returns after a block tag
+                self.halted_ = true;
+            }
+            break;
+        }
+        case FrameState::elided: {
+            --self.raw_depth_;
+            break;
+        }
+        case FrameState::pending:
+            // Optimization: the tag is empty, skip it
+            [[fallthrough]];
+        case FrameState::absorbed: {
+            break;
+        }
+        case FrameState::undecided:
+            [[fallthrough]];
+        default:
+            [[unlikely]] {
+                ::exception::unreachable<ndebug>();
+            }
+        }
+    }
+
+    /**
+     * @brief Handle an event whose merge, if any, is decided.
+     */
+    constexpr void process_(this DirectRenderer& self, Event const& event) noexcept {
+        switch (event.kind) {
+        case EventKind::leaf: {
+            self.flush_();
+            self.emitter_.leaf(event.node_type, self.result_);
+            break;
+        }
+        case EventKind::text: {
+            self.flush_();
+            self.result_.append(event.str);
+            break;
+        }
+        case EventKind::open: {
+            self.open_(event, true, nullptr);
+            break;
+        }
+        case EventKind::close: {
+            self.close_();
+            break;
+        }
+        default:
+            [[unlikely]] {
+                ::exception::unreachable<ndebug>();
+            }
+        }
+    }
+
+    constexpr void record_(this DirectRenderer& self, Event event) noexcept {
+        auto const index = self.events_.size();
+        if (event.kind == EventKind::open) {
+            self.open_events_.push_back(index);
+        } else if (event.kind == EventKind::close) {
+            auto const open_index = self.open_events_.back_unchecked();
+            self.open_events_.pop_back_unchecked();
+            event.num = open_index;
+            // merged if the first child is the same kind of tag and closed right before
+            auto&& open_event = self.events_.index_unchecked(open_index);
+            if (open_index + 1 < index) {
+                auto const& first_child = self.events_.index_unchecked(open_index + 1);
+                auto const& last_event = self.events_.index_unchecked(index - 1);
+                open_event.merge = first_child.kind == EventKind::open &&
+                                   is_mergeable_(open_event.node_type, first_child.node_type) &&
+                                   last_event.kind == EventKind::close && last_event.num == open_index + 1;
+            }
+            if (self.open_events_.empty()) {
+                self.lookahead_ = Lookahead::recorded;
+            }
+        }
+        self.events_.push_back(event);
+    }
+
+    /**
+     * @brief Handle the recorded events, the merge of the tags among them is known.
+     * @param merged: Whether the first recorded tag is merged into the top frame.
+     */
+    constexpr void replay_(this DirectRenderer& self, bool merged) noexcept {
+        auto events{::std::move(self.events_)};
+        bool absorb_next{merged};
+        for (::std::size_t i{}; i < events.size(); ++i) {
+            auto const& event = events.index_unchecked(i);
+            if (event.kind != EventKind::open) {
+                self.process_(event);
+            } else if (absorb_next) {
+                auto const& top = self.frames_.top();
+                self.frames_.emplace(Frame{top.node_type, FrameState::absorbed, false, top.str, top.num});
+                absorb_next = false;
+            } else {
+                absorb_next = self.open_(event, false, event.merge ? &events.index_unchecked(i + 1) : nullptr);
+            }
+        }
+        // reuse the capacity
+        events.clear();
+        self.events_ = ::std::move(events);
+    }
+
+    constexpr void feed_(this DirectRenderer& self, Event const& event) noexcept {
+        switch (self.lookahead_) {
+        case Lookahead::none: {
+            break;
+        }
+        case Lookahead::deciding: {
+            self.lookahead_ = Lookahead::none;
+            if (event.kind == EventKind::open && is_mergeable_(self.frames_.top().node_type, event.node_type)) {
+                self.lookahead_ = Lookahead::recording;
+                self.record_(event);
+                return;
+            }
+            self.resolve_(nullptr);
+            break;
+        }
+        case Lookahead::recording: {
+            self.record_(event);
+            return;
+        }
+        case Lookahead::recorded: {
+            self.lookahead_ = Lookahead::none;
+            // the first child is the only child if the tag is closed right after it
+            bool const merged{event.kind == EventKind::close};
+            self.resolve_(merged ? &self.events_.index_unchecked(0) : nullptr);
+            self.replay_(merged);
+            break;
+        }
+        default:
+            [[unlikely]] {
+                ::exception::unreachable<ndebug>();
+            }
+        }
+        self.process_(event);
+    }
+
+public:
+    constexpr DirectRenderer(Emitter const& emitter, Sink& result) noexcept
+        : emitter_{emitter},
+          result_{result} {
+        this->frames_.emplace(
+            Frame{::pltxt2htm::NodeType::base, FrameState::opened, false, ::fast_io::u8string_view{}, 0});
+    }
+
+    DirectRenderer(DirectRenderer const&) = delete;
+    DirectRenderer& operator=(DirectRenderer const&) = delete;
+
+    [[nodiscard]]
+    static constexpr bool exhausted() noexcept {
+        return false;
+    }
+
+    /**
+     * @brief Write a node without children.
+     */
+    template<typename Node>
+    constexpr void push(this DirectRenderer& self, children_type&) noexcept {
+        constexpr ::pltxt2htm::NodeType node_type{Node{}.node_type()};
+        self.feed_(Event{EventKind::leaf, node_type, false, ::fast_io::u8string_view{}, 0});
+    }
+
+    constexpr void push_text_run(this DirectRenderer& self, ::fast_io::u8string_view const& pltext,
+                                 ::std::size_t begin, ::std::size_t length, children_type&) noexcept {
+        self.feed_(Event{EventKind::text, ::pltxt2htm::NodeType::text_run, false,
+                         ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, begin, length), 0});
+    }
+
+    /**
+     * @brief Notes are not rendered, but they are children which survive the optimization.
+     */
+    constexpr void push_note(this DirectRenderer& self, children_type&, ::fast_io::u8string_view) noexcept {
+        self.feed_(Event{EventKind::leaf, ::pltxt2htm::NodeType::html_note, false, ::fast_io::u8string_view{}, 0});
+    }
+
+    template<typename... Args>
+    constexpr void open_frame(this DirectRenderer& self, call_stack_type& call_stack, Args&&... args) noexcept {
+        call_stack.emplace(::std::forward<Args>(args)...);
+        auto const& frame = call_stack.top();
+        Event event{EventKind::open, frame.nested_tag_type, false, ::fast_io::u8string_view{}, 0};
+        switch (frame.nested_tag_type) {
+        case ::pltxt2htm::NodeType::pl_color:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_experiment:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_discussion:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_user: {
+            event.str = frame.id;
+            break;
+        }
+        case ::pltxt2htm::NodeType::pl_a: {
+            // the color of `::pltxt2htm::A`
+            event.str = ::fast_io::u8string_view{u8"#0000AA"};
+            break;
+        }
+        case ::pltxt2htm::NodeType::pl_size: {
+            event.num = frame.size;
+            break;
+        }
+        default: {
+            break;
+        }
+        }
+        self.feed_(event);
+    }
+
+    template<bool closed_by_tag>
+    constexpr void close_frame(this DirectRenderer& self, call_stack_type& call_stack) noexcept {
+        // <strong> closed by the end of the text is <b>, which has the same html
+        call_stack.pop();
+        self.feed_(Event{EventKind::close, ::pltxt2htm::NodeType::base, false, ::fast_io::u8string_view{}, 0});
+    }
+
+    constexpr void push_md_atx_heading(this DirectRenderer& self, children_type&, ::pltxt2htm::NodeType,
+                                       children_type&&) noexcept {
+        self.feed_(Event{EventKind::close, ::pltxt2htm::NodeType::base, false, ::fast_io::u8string_view{}, 0});
+    }
+
+    constexpr void append(this DirectRenderer&, children_type&, children_type&&) noexcept {
+    }
+};
+
+/**
+ * @brief Parse pl-text and write the html to `result` in a single pass, without the ast.
+ * @tparam optimize: Whether the html is the same as rendering the optimized ast.
+ * @param emitter: `AdvancedHtmlEmitter` or `CommonHtmlEmitter`.
+ */
+template<bool ndebug, bool optimize, typename Emitter, ::pltxt2htm::html_sink Sink>
+constexpr void direct_render(::fast_io::u8string_view pltext, Emitter const& emitter, Sink& result)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    ::pltxt2htm::details::DirectRenderer<ndebug, optimize, Emitter, Sink> renderer{emitter, result};
+    [[maybe_unused]] auto children = ::pltxt2htm::details::parse_pltxt<ndebug>(pltext, renderer);
+}
+
+} // namespace pltxt2htm::details
@@ -0,0 +1,353 @@
+#pragma once
+
+/**
+ * @file flat_ast.hh
+ * @brief Compact structure-of-arrays layout of the ast, which is the layout of stored images
+ * @note The parser and the optimizer build and rewrite the pointer ast, a FlatAst is only made from the optimized
+ *       ast by `flatten_ast`. Rendering it is not faster than rendering the ast (see bench/flat_ast.cc), so the
+ *       conversions render the ast and a FlatAst is only made to be stored (see pltxt2htm/flat_ast_image.hh).
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <concepts>
+#include <fast_io/fast_io_dsal/vector.h>
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <exception/exception.hh>
+#include "utils.hh"
+#include "astnode/node_type.hh"
+#include "astnode/basic.hh"
+#include "astnode/html_node.hh"
+#include "astnode/markdown_node.hh"
+#include "astnode/physics_lab_node.hh"
+
+namespace pltxt2htm {
+
+static_assert(static_cast<::std::uint_least32_t>(::pltxt2htm::NodeType::md_code_fence) <= UINT_LEAST8_MAX,
+              "NodeType must be narrowed to std::uint_least8_t by FlatAst");
+
+/**
+ * @brief Payload of a node of FlatAst.
+ * @details - borrowed string payloads (text, color, id) are `strings[begin]`, whose size is `FlatAst::npos`
+ *          - copied string payloads (lang) are `[begin, begin + size)` of the string pool
+ *          - number payloads (u8char, size) are `numbers[begin]`
+ */
+struct FlatPayload {
+    ::std::uint_least32_t begin;
+    ::std::uint_least32_t size;
+};
+
+/**
+ * @brief Flat ast, nodes are stored in pre-order in parallel arrays and
+ *        children are linked by index instead of pointer.
+ * @note The node at index 0 is the root whose type is NodeType::base.
+ *       Like the ast, the FlatAst borrows the text, colors and ids from the pl-text, so the pl-text must outlive
+ *       it. Only the lang of code fences, which the node owns, is copied.
+ */
+class FlatAst {
+public:
+    using index_type = ::std::uint_least32_t;
+    static constexpr index_type npos{UINT_LEAST32_MAX};
+
+private:
+    ::fast_io::vector<::std::uint_least8_t> node_types_;
+    ::fast_io::vector<index_type> first_child_;
+    ::fast_io::vector<index_type> next_sibling_;
+    ::fast_io::vector<::pltxt2htm::FlatPayload> payloads_;
+    ::fast_io::vector<::std::size_t> numbers_;
+    ::fast_io::vector<::fast_io::u8string_view> strings_;
+    ::fast_io::u8string string_pool_;
+
+public:
+    constexpr FlatAst() noexcept = default;
+    constexpr FlatAst(::pltxt2htm::FlatAst const&) noexcept = default;
+    constexpr FlatAst(::pltxt2htm::FlatAst&&) noexcept = default;
+    constexpr ~FlatAst() noexcept = default;
+    constexpr ::pltxt2htm::FlatAst& operator=(::pltxt2htm::FlatAst const&) noexcept = default;
+    constexpr ::pltxt2htm::FlatAst& operator=(::pltxt2htm::FlatAst&&) noexcept = default;
+
+    /**
+     * @brief Append a node without payload.
+     * @return index of the node
+     */
+    constexpr index_type push_node(this FlatAst& self, ::pltxt2htm::NodeType node_type) noexcept {
+        auto const index = self.node_types_.size();
+        if (index >= ::pltxt2htm::FlatAst::npos) [[unlikely]] {
+            // too many nodes is the same as bad alloc
+            ::exception::terminate();
+        }
+        self.node_types_.push_back(static_cast<::std::uint_least8_t>(node_type));
+        self.first_child_.push_back(::pltxt2htm::FlatAst::npos);
+        self.next_sibling_.push_back(::pltxt2htm::FlatAst::npos);
+        self.payloads_.push_back(::pltxt2htm::FlatPayload{});
+        return static_cast<index_type>(index);
+    }
+
+    /**
+     * @brief Append a node whose payload is a string, which is borrowed.
+     * @param str: Must outlive the FlatAst, e.g. a view into the pl-text.
+     */
+    constexpr index_type push_node(this FlatAst& self, ::pltxt2htm::NodeType node_type,
+                                   ::fast_io::u8string_view str) noexcept {
+        auto const index = self.push_node(node_type);
+        self.payloads_.index_unchecked(index) = ::pltxt2htm::FlatPayload{
+            static_cast<::std::uint_least32_t>(self.strings_.size()), ::pltxt2htm::FlatAst::npos};
+        self.strings_.push_back(str);
+        return index;
+    }
+
+    /**
+     * @brief Append a node whose payload is a string, which is copied to the string pool.
+     * @note Only for strings which do not live in the pl-text, i.e. the lang of code fences.
+     */
+    constexpr index_type push_node_copy(this FlatAst& self, ::pltxt2htm::NodeType node_type,
+                                        ::fast_io::u8string_view str) noexcept {
+        auto const index = self.push_node(node_type);
+        if (self.string_pool_.size() + str.size() >= ::pltxt2htm::FlatAst::npos) [[unlikely]] {
+            ::exception::terminate();
+        }
+        self.payloads_.index_unchecked(index) =
+            ::pltxt2htm::FlatPayload{static_cast<::std::uint_least32_t>(self.string_pool_.size()),
+                                     static_cast<::std::uint_least32_t>(str.size())};
+        self.string_pool_.append(str);
+        return index;
+    }
+
+    /**
+     * @brief Append a node whose payload is a number.
+     */
+    constexpr index_type push_node(this FlatAst& self, ::pltxt2htm::NodeType node_type, ::std::size_t num) noexcept {
+        auto const index = self.push_node(node_type);
+        self.payloads_.index_unchecked(index) =
+            ::pltxt2htm::FlatPayload{static_cast<::std::uint_least32_t>(self.numbers_.size()), 0};
+        self.numbers_.push_back(num);
+        return index;
+    }
+
+    /**
+     * @brief Append `child` to the children of `parent`.
+     * @param last_child: The last child of `parent` before appending, npos if `parent` has no child.
+     */
+    constexpr void link(this FlatAst& self, index_type parent, index_type last_child, index_type child) noexcept {
+        if (last_child == ::pltxt2htm::FlatAst::npos) {
+            self.first_child_.index_unchecked(parent) = child;
+        } else {
+            self.next_sibling_.index_unchecked(last_child) = child;
+        }
+    }
+
+    /**
+     * @brief Remove all nodes and strings, the capacity is kept to be reused by the next document.
+     */
+    constexpr void clear(this FlatAst& self) noexcept {
+        self.node_types_.clear();
+        self.first_child_.clear();
+        self.next_sibling_.clear();
+        self.payloads_.clear();
+        self.numbers_.clear();
+        self.strings_.clear();
+        self.string_pool_.clear();
+    }
+
+    [[nodiscard]]
+    constexpr ::std::size_t size(this FlatAst const& self) noexcept {
+        return self.node_types_.size();
+    }
+
+    [[nodiscard]]
+    constexpr ::pltxt2htm::NodeType node_type(this FlatAst const& self, index_type index) noexcept {
+        return static_cast<::pltxt2htm::NodeType>(self.node_types_.index_unchecked(index));
+    }
+
+    [[nodiscard]]
+    constexpr index_type first_child(this FlatAst const& self, index_type index) noexcept {
+        return self.first_child_.index_unchecked(index);
+    }
+
+    [[nodiscard]]
+    constexpr index_type next_sibling(this FlatAst const& self, index_type index) noexcept {
+        return self.next_sibling_.index_unchecked(index);
+    }
+
+    /**
+     * @brief Get the string payload of text_run, pl_color, pl_a, pl_experiment, pl_discussion, pl_user and
+     *        md_code_fence
+     */
+    [[nodiscard]]
+    constexpr ::fast_io::u8string_view get_str(this FlatAst const& self, index_type index) noexcept {
+        auto const payload = self.payloads_.index_unchecked(index);
+        if (payload.size == ::pltxt2htm::FlatAst::npos) [[likely]] {
+            return self.strings_.index_unchecked(payload.begin);
+        }
+        return ::fast_io::u8string_view{self.string_pool_.data() + payload.begin, payload.size};
+    }
+
+    /**
+     * @brief Get the number payload of u8char and pl_size
+     */
+    [[nodiscard]]
+    constexpr ::std::size_t get_num(this FlatAst const& self, index_type index) noexcept {
+        return self.numbers_.index_unchecked(self.payloads_.index_unchecked(index).begin);
+    }
+};
+
+/**
+ * @brief Flat ast which the backends render, i.e. FlatAst or FlatAstView (see pltxt2htm/flat_ast_image.hh).
+ */
+template<typename T>
+concept flat_ast_like = requires(T const& ast, ::pltxt2htm::FlatAst::index_type index) {
+    { ast.size() } -> ::std::convertible_to<::std::size_t>;
+    { ast.node_type(index) } -> ::std::same_as<::pltxt2htm::NodeType>;
+    { ast.first_child(index) } -> ::std::same_as<::pltxt2htm::FlatAst::index_type>;
+    { ast.next_sibling(index) } -> ::std::same_as<::pltxt2htm::FlatAst::index_type>;
+    { ast.get_str(index) } -> ::std::same_as<::fast_io::u8string_view>;
+    { ast.get_num(index) } -> ::std::same_as<::std::size_t>;
+};
+
+namespace details {
+
+/**
+ * @brief Frame of flatten_ast
+ */
+class FlattenFrameContext {
+public:
+    ::pltxt2htm::Ast const& ast_;
+    ::pltxt2htm::FlatAst::index_type const parent_;
+    ::pltxt2htm::FlatAst::index_type last_child_;
+    ::std::size_t current_index_;
+
+    FlattenFrameContext(::pltxt2htm::Ast const& ast, ::pltxt2htm::FlatAst::index_type const parent) noexcept
+        : ast_(ast),
+          parent_{parent},
+          last_child_{::pltxt2htm::FlatAst::npos},
+          current_index_{} {
+    }
+
+    constexpr FlattenFrameContext(::pltxt2htm::details::FlattenFrameContext const&) noexcept = default;
+    constexpr FlattenFrameContext(::pltxt2htm::details::FlattenFrameContext&&) noexcept = default;
+
+    constexpr ~FlattenFrameContext() noexcept = default;
+
+    // const reference do not support operator=
+    constexpr ::pltxt2htm::details::FlattenFrameContext& operator=(
+        ::pltxt2htm::details::FlattenFrameContext const&) noexcept = delete;
+    constexpr ::pltxt2htm::details::FlattenFrameContext& operator=(
+        ::pltxt2htm::details::FlattenFrameContext&&) noexcept = delete;
+};
+
+} // namespace details
+
+/**
+ * @brief Convert the ast to FlatAst in one linear pass.
+ * @param [out] result: Cleared before flattening, so that its capacity can be reused across documents
+ * @note To avoid stack overflow, this function manage `call_stack` by hand.
+ *       The FlatAst borrows the pl-text of `ast_init` but not the ast, which can be destroyed before rendering.
+ */
+template<bool ndebug>
+constexpr void flatten_ast(::pltxt2htm::Ast const& ast_init, ::pltxt2htm::FlatAst& result)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    result.clear();
+    ::pltxt2htm::details::FrameStack<::pltxt2htm::details::FlattenFrameContext> call_stack{};
+    call_stack.emplace(ast_init, result.push_node(::pltxt2htm::NodeType::base));
+
+restart:
+    auto&& frame = call_stack.top();
+    for (; frame.current_index_ < frame.ast_.size(); ++frame.current_index_) {
+        auto&& node = ::pltxt2htm::details::vector_index<ndebug>(frame.ast_, frame.current_index_);
+        auto const node_type = node->node_type();
+
+        ::pltxt2htm::FlatAst::index_type index;
+        switch (node_type) {
+        case ::pltxt2htm::NodeType::u8char: {
+            index = result.push_node(node_type,
+                                     reinterpret_cast<::pltxt2htm::U8Char const*>(node.release_imul())->get_u8char());
+            break;
+        }
+        case ::pltxt2htm::NodeType::text_run: {
+            auto const text_run = reinterpret_cast<::pltxt2htm::TextRun const*>(node.release_imul());
+            index = result.push_node(node_type, text_run->get_text());
+            break;
+        }
+        case ::pltxt2htm::NodeType::pl_color:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::pl_a: {
+            // <a> and <color> is the same tag&struct in fact
+            auto const color = reinterpret_cast<::pltxt2htm::Color const*>(node.release_imul());
+            index = result.push_node(node_type, color->get_color());
+            break;
+        }
+        case ::pltxt2htm::NodeType::pl_experiment: {
+            auto const experiment = reinterpret_cast<::pltxt2htm::Experiment const*>(node.release_imul());
+            index = result.push_node(node_type, experiment->get_id());
+            break;
+        }
+        case ::pltxt2htm::NodeType::pl_discussion: {
+            auto const discussion = reinterpret_cast<::pltxt2htm::Discussion const*>(node.release_imul());
+            index = result.push_node(node_type, discussion->get_id());
+            break;
+        }
+        case ::pltxt2htm::NodeType::pl_user: {
+            auto const user = reinterpret_cast<::pltxt2htm::User const*>(node.release_imul());
+            index = result.push_node(node_type, user->get_id());
+            break;
+        }
+        case ::pltxt2htm::NodeType::pl_size: {
+            auto const size = reinterpret_cast<::pltxt2htm::Size const*>(node.release_imul());
+            index = result.push_node(node_type, size->get_id());
+            break;
+        }
+        case ::pltxt2htm::NodeType::md_code_fence: {
+            auto&& lang = reinterpret_cast<::pltxt2htm::MdCodeFence const*>(node.release_imul())->get_lang();
+            if (lang.has_value()) {
+                index = result.push_node_copy(node_type, ::fast_io::mnp::os_c_str(lang.template value<ndebug>()));
+            } else {
+                index = result.push_node(node_type);
+            }
+            break;
+        }
+        default: {
+            index = result.push_node(node_type);
+            break;
+        }
+        }
+        result.link(frame.parent_, frame.last_child_, index);
+        frame.last_child_ = index;
+
+        if (::pltxt2htm::details::is_paired_tag(node_type)) {
+            auto const paired_tag = reinterpret_cast<::pltxt2htm::details::PairedTagBase const*>(node.release_imul());
+            auto&& subast = paired_tag->get_subast();
+            if (!subast.empty()) {
+                ++frame.current_index_;
+                call_stack.emplace(subast, index);
+                goto restart;
+            }
+        }
+    }
+
+    call_stack.pop();
+    if (call_stack.empty()) {
+        return;
+    }
+    goto restart;
+}
+
+/**
+ * @brief Convert the ast to a new FlatAst.
+ */
+template<bool ndebug>
+[[nodiscard]]
+constexpr auto flatten_ast(::pltxt2htm::Ast const& ast)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+    -> ::pltxt2htm::FlatAst {
+    ::pltxt2htm::FlatAst result{};
+    ::pltxt2htm::flatten_ast<ndebug>(ast, result);
+    return result;
+}
+
+} // namespace pltxt2htm
@@ -0,0 +1,354 @@
+#pragma once
+
+/**
+ * @file flat_ast_image.hh
+ * @brief Versioned binary image of FlatAst, which can be stored to disk, mapped back and rendered in place
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <fast_io/fast_io_dsal/vector.h>
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <exception/exception.hh>
+#include "sink.hh"
+#include "flat_ast.hh"
+#include "astnode/node_type.hh"
+
+namespace pltxt2htm {
+
+/**
+ * @brief Version of the layout of the image, bumped whenever the layout changes.
+ * @note Changes of `NodeType` are detected by the number of node types stored in the image instead.
+ */
+inline constexpr ::std::uint_least32_t flat_ast_image_version{1};
+
+namespace details {
+
+/**
+ * @brief Header of the image, each field is a little endian u32 after the magic.
+ * @details The image is the header followed by the arrays of FlatAst without padding:
+ *          node types (u8 x nodes), first children (u32 x nodes), next siblings (u32 x nodes),
+ *          payloads (u32 begin + u32 size x nodes), numbers (u64 x numbers), strings (bytes).
+ *          Nodes are linked by index, therefore the image is relocatable and needs no fixup after mapping.
+ */
+inline constexpr ::fast_io::u8string_view flat_ast_image_magic{u8"PLTXTAST"};
+inline constexpr ::std::size_t flat_ast_image_header_size{8 + 4 * 5};
+inline constexpr ::std::uint_least32_t flat_ast_image_node_type_count{
+    static_cast<::std::uint_least32_t>(::pltxt2htm::NodeType::md_code_fence) + 1};
+
+enum class FlatPayloadKind : ::std::uint_least8_t {
+    none,
+    string,
+    number
+};
+
+/**
+ * @brief Which payload the nodes of `node_type` have, see `FlatAst::get_str` and `FlatAst::get_num`.
+ */
+[[nodiscard]]
+constexpr ::pltxt2htm::details::FlatPayloadKind flat_payload_kind(::pltxt2htm::NodeType node_type) noexcept {
+    switch (node_type) {
+    case ::pltxt2htm::NodeType::text_run:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::pl_color:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::pl_a:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::pl_experiment:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::pl_discussion:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::pl_user:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::md_code_fence: {
+        return ::pltxt2htm::details::FlatPayloadKind::string;
+    }
+    case ::pltxt2htm::NodeType::u8char:
+        [[fallthrough]];
+    case ::pltxt2htm::NodeType::pl_size: {
+        return ::pltxt2htm::details::FlatPayloadKind::number;
+    }
+    default: {
+        return ::pltxt2htm::details::FlatPayloadKind::none;
+    }
+    }
+}
+
+/**
+ * @brief Read a little endian integer at any alignment, compilers fold it into one load on little endian targets.
+ */
+template<typename UInt>
+[[nodiscard]]
+constexpr UInt load_le(char8_t const* ptr) noexcept {
+    UInt value{};
+    for (::std::size_t i{}; i < sizeof(UInt); ++i) {
+        value |= static_cast<UInt>(static_cast<UInt>(ptr[i]) << (i * 8));
+    }
+    return value;
+}
+
+template<typename UInt, ::pltxt2htm::html_sink Sink>
+constexpr void store_le(UInt value, Sink& sink)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    for (::std::size_t i{}; i < sizeof(UInt); ++i) {
+        sink.push_back(static_cast<char8_t>(value >> (i * 8)));
+    }
+}
+
+} // namespace details
+
+/**
+ * @brief Read only FlatAst over an image made by `serialize_flat_ast`, e.g. a mapped file.
+ *        The backends render it in place like FlatAst, see `flat_ast_like`.
+ * @note Created by `load_flat_ast`, the view borrows the image, therefore the image must outlive the view.
+ */
+class FlatAstView {
+    char8_t const* node_types_{};
+    char8_t const* first_child_{};
+    char8_t const* next_sibling_{};
+    char8_t const* payloads_{};
+    char8_t const* numbers_{};
+    char8_t const* strings_{};
+    ::std::size_t size_{};
+
+    friend constexpr auto load_flat_ast(::fast_io::u8string_view image) noexcept
+        -> ::exception::optional<::pltxt2htm::FlatAstView>;
+
+public:
+    using index_type = ::pltxt2htm::FlatAst::index_type;
+
+    constexpr FlatAstView() noexcept = default;
+
+    [[nodiscard]]
+    constexpr ::std::size_t size(this FlatAstView const& self) noexcept {
+        return self.size_;
+    }
+
+    [[nodiscard]]
+    constexpr ::pltxt2htm::NodeType node_type(this FlatAstView const& self, index_type index) noexcept {
+        return static_cast<::pltxt2htm::NodeType>(self.node_types_[index]);
+    }
+
+    [[nodiscard]]
+    constexpr index_type first_child(this FlatAstView const& self, index_type index) noexcept {
+        return ::pltxt2htm::details::load_le<index_type>(self.first_child_ + ::std::size_t{4} * index);
+    }
+
+    [[nodiscard]]
+    constexpr index_type next_sibling(this FlatAstView const& self, index_type index) noexcept {
+        return ::pltxt2htm::details::load_le<index_type>(self.next_sibling_ + ::std::size_t{4} * index);
+    }
+
+    [[nodiscard]]
+    constexpr ::fast_io::u8string_view get_str(this FlatAstView const& self, index_type index) noexcept {
+        auto const payload = self.payloads_ + ::std::size_t{8} * index;
+        auto const begin = ::pltxt2htm::details::load_le<::std::uint_least32_t>(payload);
+        auto const size = ::pltxt2htm::details::load_le<::std::uint_least32_t>(payload + 4);
+        return ::fast_io::u8string_view{self.strings_ + begin, size};
+    }
+
+    [[nodiscard]]
+    constexpr ::std::size_t get_num(this FlatAstView const& self, index_type index) noexcept {
+        auto const payload = self.payloads_ + ::std::size_t{8} * index;
+        auto const begin = ::pltxt2htm::details::load_le<::std::uint_least32_t>(payload);
+        return static_cast<::std::size_t>(
+            ::pltxt2htm::details::load_le<::std::uint_least64_t>(self.numbers_ + ::std::size_t{8} * begin));
+    }
+};
+
+/**
+ * @brief Write the image of `flat_ast` to `sink`, see `details::flat_ast_image_header_size` for the layout.
+ * @note Strings and numbers are written in the order of the nodes, so the image is deterministic.
+ */
+template<::pltxt2htm::html_sink Sink>
+constexpr void serialize_flat_ast(::pltxt2htm::FlatAst const& flat_ast, Sink& sink)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    auto const size = static_cast<::pltxt2htm::FlatAst::index_type>(flat_ast.size());
+    ::std::uint_least32_t number_count{};
+    ::std::size_t total_string_size{};
+    for (::pltxt2htm::FlatAst::index_type i{}; i < size; ++i) {
+        switch (::pltxt2htm::details::flat_payload_kind(flat_ast.node_type(i))) {
+        case ::pltxt2htm::details::FlatPayloadKind::string: {
+            total_string_size += flat_ast.get_str(i).size();
+            break;
+        }
+        case ::pltxt2htm::details::FlatPayloadKind::number: {
+            ++number_count;
+            break;
+        }
+        default: {
+            break;
+        }
+        }
+    }
+    // the FlatAst borrows its strings, which are only bounded by the u32 offsets of the image here
+    if (total_string_size > UINT_LEAST32_MAX) [[unlikely]] {
+        // too many strings is the same as bad alloc
+        ::exception::terminate();
+    }
+    auto const string_size = static_cast<::std::uint_least32_t>(total_string_size);
+
+    sink.append(::pltxt2htm::details::flat_ast_image_magic);
+    ::pltxt2htm::details::store_le(::pltxt2htm::flat_ast_image_version, sink);
+    ::pltxt2htm::details::store_le(::pltxt2htm::details::flat_ast_image_node_type_count, sink);
+    ::pltxt2htm::details::store_le(size, sink);
+    ::pltxt2htm::details::store_le(number_count, sink);
+    ::pltxt2htm::details::store_le(string_size, sink);
+
+    for (::pltxt2htm::FlatAst::index_type i{}; i < size; ++i) {
+        sink.push_back(static_cast<char8_t>(flat_ast.node_type(i)));
+    }
+    for (::pltxt2htm::FlatAst::index_type i{}; i < size; ++i) {
+        ::pltxt2htm::details::store_le(flat_ast.first_child(i), sink);
+    }
+    for (::pltxt2htm::FlatAst::index_type i{}; i < size; ++i) {
+        ::pltxt2htm::details::store_le(flat_ast.next_sibling(i), sink);
+    }
+    // the payloads are renumbered, because strings and numbers are written in the order of the nodes
+    ::std::uint_least32_t string_begin{};
+    ::std::uint_least32_t number_begin{};
+    for (::pltxt2htm::FlatAst::index_type i{}; i < size; ++i) {
+        switch (::pltxt2htm::details::flat_payload_kind(flat_ast.node_type(i))) {
+        case ::pltxt2htm::details::FlatPayloadKind::string: {
+            auto const str_size = static_cast<::std::uint_least32_t>(flat_ast.get_str(i).size());
+            ::pltxt2htm::details::store_le(string_begin, sink);
+            ::pltxt2htm::details::store_le(str_size, sink);
+            string_begin += str_size;
+            break;
+        }
+        case ::pltxt2htm::details::FlatPayloadKind::number: {
+            ::pltxt2htm::details::store_le(number_begin++, sink);
+            ::pltxt2htm::details::store_le(::std::uint_least32_t{}, sink);
+            break;
+        }
+        default: {
+            ::pltxt2htm::details::store_le(::std::uint_least64_t{}, sink);
+            break;
+        }
+        }
+    }
+    for (::pltxt2htm::FlatAst::index_type i{}; i < size; ++i) {
+        if (::pltxt2htm::details::flat_payload_kind(flat_ast.node_type(i)) ==
+            ::pltxt2htm::details::FlatPayloadKind::number) {
+            ::pltxt2htm::details::store_le(static_cast<::std::uint_least64_t>(flat_ast.get_num(i)), sink);
+        }
+    }
+    for (::pltxt2htm::FlatAst::index_type i{}; i < size; ++i) {
+        if (::pltxt2htm::details::flat_payload_kind(flat_ast.node_type(i)) ==
+            ::pltxt2htm::details::FlatPayloadKind::string) {
+            sink.append(flat_ast.get_str(i));
+        }
+    }
+}
+
+/**
+ * @brief Serialize `flat_ast` to a new image.
+ */
+[[nodiscard]]
+constexpr auto serialize_flat_ast(::pltxt2htm::FlatAst const& flat_ast)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+    -> ::fast_io::u8string {
+    ::fast_io::u8string image{};
+    ::pltxt2htm::serialize_flat_ast(flat_ast, image);
+    return image;
+}
+
+/**
+ * @brief View the image made by `serialize_flat_ast`.
+ * @param image: Any bytes, e.g. a mapped file, which needs no alignment.
+ * @return nullopt if `image` is not an image of this version or of this `NodeType`, or if it is malformed.
+ * @note The image is validated in O(n) so that rendering an untrusted image stays in bounds and visits every node
+ *       once: the nodes form a tree in pre-order like FlatAst does, and every payload is in range.
+ */
+[[nodiscard]]
+constexpr auto load_flat_ast(::fast_io::u8string_view image) noexcept
+    -> ::exception::optional<::pltxt2htm::FlatAstView> {
+    if (image.size() < ::pltxt2htm::details::flat_ast_image_header_size ||
+        !image.starts_with(::pltxt2htm::details::flat_ast_image_magic)) {
+        return ::exception::nullopt_t{};
+    }
+    auto const header = image.data() + ::pltxt2htm::details::flat_ast_image_magic.size();
+    auto const version = ::pltxt2htm::details::load_le<::std::uint_least32_t>(header);
+    auto const node_type_count = ::pltxt2htm::details::load_le<::std::uint_least32_t>(header + 4);
+    ::std::uint_least64_t const size{::pltxt2htm::details::load_le<::std::uint_least32_t>(header + 8)};
+    ::std::uint_least64_t const number_count{::pltxt2htm::details::load_le<::std::uint_least32_t>(header + 12)};
+    ::std::uint_least64_t const string_size{::pltxt2htm::details::load_le<::std::uint_least32_t>(header + 16)};
+    if (version != ::pltxt2htm::flat_ast_image_version ||
+        node_type_count != ::pltxt2htm::details::flat_ast_image_node_type_count || size == 0 ||
+        size == ::pltxt2htm::FlatAst::npos ||
+        image.size() != ::pltxt2htm::details::flat_ast_image_header_size + size * (1 + 4 + 4 + 8) +
+                            number_count * 8 + string_size) {
+        return ::exception::nullopt_t{};
+    }
+
+    ::pltxt2htm::FlatAstView view{};
+    view.size_ = static_cast<::std::size_t>(size);
+    view.node_types_ = image.data() + ::pltxt2htm::details::flat_ast_image_header_size;
+    view.first_child_ = view.node_types_ + size;
+    view.next_sibling_ = view.first_child_ + size * 4;
+    view.payloads_ = view.next_sibling_ + size * 4;
+    view.numbers_ = view.payloads_ + size * 8;
+    view.strings_ = view.numbers_ + number_count * 8;
+
+    if (view.node_type(0) != ::pltxt2htm::NodeType::base ||
+        view.next_sibling(0) != ::pltxt2htm::FlatAst::npos) {
+        return ::exception::nullopt_t{};
+    }
+    // Forward links alone still allow a dag, e.g. both links of every node pointing to the next node, which
+    // renders exponentially many nodes. Every node except the root must be linked exactly once, and the first
+    // child must follow its parent, which makes the image a tree in pre-order like the one of `flatten_ast`.
+    ::fast_io::vector<bool> linked(static_cast<::std::size_t>(size));
+    for (::pltxt2htm::FlatAst::index_type i{}; i < size; ++i) {
+        auto const node_type = static_cast<::std::uint_least32_t>(view.node_type(i));
+        if (node_type >= ::pltxt2htm::details::flat_ast_image_node_type_count || (i != 0 && node_type == 0) ||
+            (i != 0 && !linked.index_unchecked(i))) {
+            return ::exception::nullopt_t{};
+        }
+        auto const first_child = view.first_child(i);
+        if (first_child != ::pltxt2htm::FlatAst::npos && first_child != i + 1) {
+            return ::exception::nullopt_t{};
+        }
+        for (auto const link : {first_child, view.next_sibling(i)}) {
+            if (link == ::pltxt2htm::FlatAst::npos) {
+                continue;
+            }
+            if (link <= i || link >= size || linked.index_unchecked(link)) {
+                return ::exception::nullopt_t{};
+            }
+            linked.index_unchecked(link) = true;
+        }
+        auto const payload = view.payloads_ + ::std::size_t{8} * i;
+        ::std::uint_least64_t const begin{::pltxt2htm::details::load_le<::std::uint_least32_t>(payload)};
+        ::std::uint_least64_t const length{::pltxt2htm::details::load_le<::std::uint_least32_t>(payload + 4)};
+        switch (::pltxt2htm::details::flat_payload_kind(view.node_type(i))) {
+        case ::pltxt2htm::details::FlatPayloadKind::string: {
+            if (begin + length > string_size) {
+                return ::exception::nullopt_t{};
+            }
+            break;
+        }
+        case ::pltxt2htm::details::FlatPayloadKind::number: {
+            if (begin >= number_count) {
+                return ::exception::nullopt_t{};
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+        }
+    }
+    return view;
+}
+
+} // namespace pltxt2htm
@@ -0,0 +1,125 @@
+#pragma once
+
+/**
+ * @file frame_stack.hh
+ * @brief Contiguous call stack for the iterative traversals of parser, optimizer and backends
+ */
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <fast_io/fast_io_core.h>
+
+namespace pltxt2htm::details {
+
+/**
+ * @brief A stack whose frames are stored contiguously.
+ * @tparam T: Type of frames.
+ * @tparam inline_capacity: Number of frames stored inside the object, pushing more frames moves all
+ *                          frames to the heap and the capacity grows geometrically.
+ * @note Typical documents nest less than `inline_capacity` tags, therefore need no heap allocation.
+ *       Pushing a frame may move the others, do not keep references to frames across `emplace`.
+ */
+template<typename T, ::std::size_t inline_capacity = 16>
+class FrameStack {
+    static_assert(inline_capacity != 0);
+
+    T* frames_;
+    ::std::size_t size_{};
+    ::std::size_t capacity_{inline_capacity};
+
+    union {
+        T inline_frames_[inline_capacity];
+    };
+
+    [[nodiscard]]
+    constexpr bool is_inline_(this FrameStack const& self) noexcept {
+        return self.frames_ == self.inline_frames_;
+    }
+
+public:
+    constexpr FrameStack() noexcept
+        : frames_{inline_frames_} {
+    }
+
+    constexpr FrameStack(FrameStack const&) noexcept = delete;
+    constexpr FrameStack(FrameStack&&) noexcept = delete;
+    constexpr FrameStack& operator=(FrameStack const&) noexcept = delete;
+    constexpr FrameStack& operator=(FrameStack&&) noexcept = delete;
+
+    constexpr ~FrameStack() noexcept {
+        ::std::destroy_n(this->frames_, this->size_);
+        if (!this->is_inline_()) {
+            ::fast_io::native_global_allocator::deallocate(this->frames_);
+        }
+    }
+
+    /**
+     * @brief Construct a frame on the top of the stack.
+     * @note `args` may refer to frames of this stack.
+     */
+    template<typename... Args>
+    constexpr void emplace(this FrameStack& self, Args&&... args) noexcept {
+        if (self.size_ != self.capacity_) [[likely]] {
+            ::std::construct_at(self.frames_ + self.size_, ::std::forward<Args>(args)...);
+            ++self.size_;
+            return;
+        }
+
+        ::std::size_t const new_capacity{self.capacity_ * 2};
+        // the allocator terminates on bad alloc, and implicitly starts lifetime of the array like ::std::malloc
+        auto const new_frames =
+            reinterpret_cast<T*>(::fast_io::native_global_allocator::allocate(sizeof(T) * new_capacity));
+        // construct the new frame first, `args` may refer to the old frames
+        ::std::construct_at(new_frames + self.size_, ::std::forward<Args>(args)...);
+        for (::std::size_t i{}; i < self.size_; ++i) {
+            ::std::construct_at(new_frames + i, ::std::move(self.frames_[i]));
+            ::std::destroy_at(self.frames_ + i);
+        }
+        if (!self.is_inline_()) {
+            ::fast_io::native_global_allocator::deallocate(self.frames_);
+        }
+        self.frames_ = new_frames;
+        self.capacity_ = new_capacity;
+        ++self.size_;
+    }
+
+    /**
+     * @brief Destroy the top frame.
+     * @note The stack must not be empty.
+     */
+    constexpr void pop(this FrameStack& self) noexcept {
+        --self.size_;
+        ::std::destroy_at(self.frames_ + self.size_);
+    }
+
+    /**
+     * @brief The top frame.
+     * @note The stack must not be empty.
+     */
+    [[nodiscard]]
+    constexpr auto&& top(this auto&& self) noexcept {
+        return ::std::forward_like<decltype(self)>(self.frames_[self.size_ - 1]);
+    }
+
+    /**
+     * @brief The `index`-th frame from the bottom.
+     * @note `index` must be less than `size()`.
+     */
+    [[nodiscard]]
+    constexpr auto&& index_unchecked(this auto&& self, ::std::size_t index) noexcept {
+        return ::std::forward_like<decltype(self)>(self.frames_[index]);
+    }
+
+    [[nodiscard]]
+    constexpr bool empty(this FrameStack const& self) noexcept {
+        return self.size_ == 0;
+    }
+
+    [[nodiscard]]
+    constexpr ::std::size_t size(this FrameStack const& self) noexcept {
+        return self.size_;
+    }
+};
+
+} // namespace pltxt2htm::details
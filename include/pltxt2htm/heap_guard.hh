@@ -1,12 +1,13 @@
 #pragma once
 
-#include <cstdlib>
 #include <memory>
 #include <utility>
 #include <ranges>
 #include <concepts>
 #include <type_traits>
+#include <fast_io/fast_io_core.h>
 #include <exception/exception.hh>
+#include "arena.hh"
 
 namespace pltxt2htm::details {
 
@@ -34,11 +35,35 @@ concept is_heap_guard = is_heap_guard_<::std::remove_cvref_t<T>>;
 
 /**
  * @brief RAII a heap allocated pointer, similar to std::unique_ptr
+ * @note If `current_node_arena` is set, the memory comes from the arena instead of ::fast_io::native_global_allocator.
+ *       `deleter_` both destroys the object and releases its memory.
  */
 template<typename T>
 class HeapGuard {
     T* ptr_;
 
+    /**
+     * @brief Set `ptr_` to uninitialized memory and `deleter_` to the matching deleter
+     */
+    constexpr void allocate_(this HeapGuard<T>& self) noexcept {
+        auto const arena = ::pltxt2htm::details::current_node_arena;
+        if (arena != nullptr) {
+            self.ptr_ = reinterpret_cast<T*>(arena->allocate(sizeof(T), alignof(T)));
+            self.deleter_ = [](T* ptr) static constexpr noexcept {
+                ptr->~T();
+                ::pltxt2htm::details::NodeArena::deallocate(ptr);
+            };
+        } else {
+            // the allocator terminates on bad alloc, and implicitly starts lifetime of ptr like ::std::malloc
+            // Therefore, should not call ::std::start_lifetime_as
+            self.ptr_ = reinterpret_cast<T*>(::fast_io::native_global_allocator::allocate(sizeof(T)));
+            self.deleter_ = [](T* ptr) static constexpr noexcept {
+                ptr->~T();
+                ::fast_io::native_global_allocator::deallocate(ptr);
+            };
+        }
+    }
+
 public:
     void (*deleter_)(T*);
     using value_type = T;
@@ -46,26 +71,14 @@ public:
     template<typename... Args>
         requires (((!::pltxt2htm::details::is_heap_guard<Args>) && ...) && ::std::constructible_from<T, Args...>)
     constexpr HeapGuard(Args&&... args) noexcept {
-        this->deleter_ = [](T* self) static constexpr noexcept { self->~T(); };
-        this->ptr_ = reinterpret_cast<T*>(::std::malloc(sizeof(T)));
-        if (this->ptr_ == nullptr) [[unlikely]] {
-            // bad alloc should never be an exception or err_code
-            ::exception::terminate();
-        }
+        this->allocate_();
         ::std::construct_at(this->ptr_, ::std::forward<Args>(args)...);
     }
 
     constexpr HeapGuard(HeapGuard<T> const& other) noexcept
         requires (::std::is_copy_constructible_v<T>)
     {
-        this->deleter_ = other.deleter_;
-        // ::std::malloc will implicitly start lifetime of ptr
-        // Therefore, should not call ::std::start_lifetime_as
-        this->ptr_ = reinterpret_cast<T*>(::std::malloc(sizeof(T)));
-        if (this->ptr_ == nullptr) [[unlikely]] {
-            // bad alloc should never be an exception or err_code
-            ::exception::terminate();
-        }
+        this->allocate_();
         ::std::construct_at(this->ptr_, *other.release_imul());
     }
 
@@ -96,7 +109,6 @@ public:
     constexpr ~HeapGuard() noexcept {
         if (ptr_ != nullptr) {
             this->deleter_(this->ptr_);
-            ::std::free(this->ptr_);
         }
     }
 
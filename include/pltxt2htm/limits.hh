@@ -0,0 +1,310 @@
+#pragma once
+
+/**
+ * @file limits.hh
+ * @brief Budgets of converting untrusted pl-text, and the plain text html rendered when one runs out
+ */
+
+#include <cstddef>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include "sink.hh"
+#include "scanner.hh"
+#include "astnode/node_type.hh"
+
+namespace pltxt2htm {
+
+/**
+ * @brief Budgets of converting one pl-text, the default is unlimited.
+ * @note When a budget runs out, the conversion does not terminate: the whole pl-text is rendered as escaped plain
+ *       text instead (see `details::render_plain_text`), which takes O(n) and is cut at `max_output_size`.
+ */
+struct Limits {
+    /**
+     * @brief Nodes of the ast, which bounds the memory and the work of the optimizer and the backends
+     */
+    ::std::size_t max_nodes{::std::numeric_limits<::std::size_t>::max()};
+    /**
+     * @brief Nesting depth of tags
+     */
+    ::std::size_t max_depth{::std::numeric_limits<::std::size_t>::max()};
+    /**
+     * @brief Bytes of the html
+     */
+    ::std::size_t max_output_size{::std::numeric_limits<::std::size_t>::max()};
+    /**
+     * @brief The conversion gives up after it
+     */
+    ::std::chrono::steady_clock::time_point deadline{::std::chrono::steady_clock::time_point::max()};
+    /**
+     * @brief The conversion gives up once it is true, e.g. set by another thread when the client has gone
+     */
+    ::std::atomic<bool> const* cancelled{};
+
+    /**
+     * @brief Whether none of the budgets is set.
+     */
+    [[nodiscard]]
+    constexpr bool unlimited(this Limits const& self) noexcept {
+        return self.max_nodes == ::std::numeric_limits<::std::size_t>::max() &&
+               self.max_depth == ::std::numeric_limits<::std::size_t>::max() &&
+               self.max_output_size == ::std::numeric_limits<::std::size_t>::max() &&
+               self.deadline == ::std::chrono::steady_clock::time_point::max() && self.cancelled == nullptr;
+    }
+};
+
+namespace details {
+
+/**
+ * @brief Budget which never runs out, whose checks are compiled away.
+ */
+struct Unlimited {
+    [[nodiscard]]
+    static constexpr bool exhausted() noexcept {
+        return false;
+    }
+
+    [[nodiscard]]
+    static constexpr bool tick() noexcept {
+        return false;
+    }
+};
+
+/**
+ * @brief What is left of the budgets of `Limits` during a conversion.
+ * @note The clock and the cancellation flag are polled once every `poll_interval` steps of work, which keeps them
+ *       out of the hot loops.
+ */
+class Budget {
+    ::pltxt2htm::Limits const& limits_;
+    ::std::size_t nodes_{};
+    ::std::size_t ticks_{};
+    bool exhausted_{};
+
+    void poll_(this Budget& self) noexcept {
+        if (self.limits_.cancelled != nullptr && self.limits_.cancelled->load(::std::memory_order_relaxed)) {
+            self.exhausted_ = true;
+        } else if (self.limits_.deadline != ::std::chrono::steady_clock::time_point::max() &&
+                   ::std::chrono::steady_clock::now() >= self.limits_.deadline) {
+            self.exhausted_ = true;
+        }
+    }
+
+public:
+    static constexpr ::std::size_t poll_interval{256};
+
+    explicit Budget(::pltxt2htm::Limits const& limits) noexcept
+        : limits_{limits} {
+        // cancelled or late before starting
+        this->poll_();
+    }
+
+    Budget(Budget const&) = delete;
+    Budget& operator=(Budget const&) = delete;
+
+    [[nodiscard]]
+    ::pltxt2htm::Limits const& limits(this Budget const& self) noexcept {
+        return self.limits_;
+    }
+
+    [[nodiscard]]
+    bool exhausted(this Budget const& self) noexcept {
+        return self.exhausted_;
+    }
+
+    void exhaust(this Budget& self) noexcept {
+        self.exhausted_ = true;
+    }
+
+    /**
+     * @brief Count a step of work.
+     * @return Whether the budget has run out
+     */
+    bool tick(this Budget& self) noexcept {
+        if (++self.ticks_ % ::pltxt2htm::details::Budget::poll_interval == 0) {
+            self.poll_();
+        }
+        return self.exhausted_;
+    }
+
+    /**
+     * @brief Count a node of the ast.
+     * @return Whether the budget has run out
+     */
+    bool add_node(this Budget& self) noexcept {
+        if (++self.nodes_ > self.limits_.max_nodes) {
+            self.exhausted_ = true;
+        }
+        return self.tick();
+    }
+
+    /**
+     * @brief Check the nesting depth of a tag which is opened.
+     * @return Whether the budget has run out
+     */
+    bool enter(this Budget& self, ::std::size_t depth) noexcept {
+        if (depth > self.limits_.max_depth) {
+            self.exhausted_ = true;
+        }
+        return self.exhausted_;
+    }
+};
+
+/**
+ * @brief Pass the html to `Sink` until `max_output_size` of the budget, or until the budget runs out.
+ * @note A piece which does not fit is dropped as a whole and exhausts the budget, so that an entity is never cut.
+ */
+template<::pltxt2htm::html_sink Sink>
+class LimitedSink {
+    Sink& sink_;
+    ::pltxt2htm::details::Budget& budget_;
+    ::std::size_t size_{};
+
+public:
+    constexpr LimitedSink(Sink& sink, ::pltxt2htm::details::Budget& budget) noexcept
+        : sink_{sink},
+          budget_{budget} {
+    }
+
+    /**
+     * @brief Bytes which can still be written.
+     */
+    [[nodiscard]]
+    constexpr ::std::size_t remaining(this LimitedSink const& self) noexcept {
+        return self.budget_.exhausted() ? 0 : self.budget_.limits().max_output_size - self.size_;
+    }
+
+    void append(this LimitedSink& self, ::fast_io::u8string_view str)
+#if __cpp_exceptions < 199711L
+        noexcept
+#endif
+    {
+        if (self.budget_.tick()) {
+            return;
+        }
+        if (str.size() > self.budget_.limits().max_output_size - self.size_) {
+            self.budget_.exhaust();
+            return;
+        }
+        self.size_ += str.size();
+        self.sink_.append(str);
+    }
+
+    void push_back(this LimitedSink& self, char8_t chr)
+#if __cpp_exceptions < 199711L
+        noexcept
+#endif
+    {
+        if (self.budget_.tick()) {
+            return;
+        }
+        if (self.size_ == self.budget_.limits().max_output_size) {
+            self.budget_.exhaust();
+            return;
+        }
+        ++self.size_;
+        self.sink_.push_back(chr);
+    }
+};
+
+/**
+ * @brief Render `pltext` as if it had no tag: text is escaped by `emitter` like the text of the document, control
+ *        chars are dropped and invalid utf-8 is replaced. It is the html when a budget of `limits` runs out.
+ * @param emitter: `AdvancedHtmlEmitter` or `CommonHtmlEmitter` of the target.
+ * @note Only `limits.max_output_size` is obeyed, because this takes O(n) without allocating. The html is cut
+ *       before the first char which does not fit.
+ */
+template<typename Emitter, ::pltxt2htm::html_sink Sink>
+inline void render_plain_text(::fast_io::u8string_view pltext, Emitter const& emitter,
+                              ::pltxt2htm::Limits const& limits, Sink& sink)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    ::pltxt2htm::Limits const output_limits{.max_output_size = limits.max_output_size};
+    ::pltxt2htm::details::Budget budget{output_limits};
+    ::pltxt2htm::details::LimitedSink<Sink> limited_sink{sink, budget};
+
+    bool const utf8_validated{::pltxt2htm::details::is_valid_utf8(pltext)};
+    auto first = pltext.data();
+    auto const last = pltext.data() + pltext.size();
+    while (first != last && !budget.exhausted()) {
+        auto const run_end = utf8_validated ? ::pltxt2htm::details::find_plain_text_end<true>(first, last)
+                                            : ::pltxt2htm::details::find_plain_text_end<false>(first, last);
+        if (run_end != first) {
+            auto const run_size = static_cast<::std::size_t>(run_end - first);
+            auto size = run_size < limited_sink.remaining() ? run_size : limited_sink.remaining();
+            if (size != run_size) {
+                // never cut a utf-8 sequence
+                while (size != 0 && (first[size] & 0xC0) == 0x80) {
+                    --size;
+                }
+            }
+            limited_sink.append(::fast_io::u8string_view{first, size});
+            if (size != run_size) {
+                return;
+            }
+            first = run_end;
+            continue;
+        }
+
+        switch (*first) {
+        case u8'\n': {
+            emitter.leaf(::pltxt2htm::NodeType::line_break, limited_sink);
+            break;
+        }
+        case u8' ': {
+            emitter.leaf(::pltxt2htm::NodeType::space, limited_sink);
+            break;
+        }
+        case u8'\t': {
+            emitter.leaf(::pltxt2htm::NodeType::tab, limited_sink);
+            break;
+        }
+        case u8'&': {
+            emitter.leaf(::pltxt2htm::NodeType::ampersand, limited_sink);
+            break;
+        }
+        case u8'\'': {
+            emitter.leaf(::pltxt2htm::NodeType::single_quote, limited_sink);
+            break;
+        }
+        case u8'\"': {
+            emitter.leaf(::pltxt2htm::NodeType::double_quote, limited_sink);
+            break;
+        }
+        case u8'<': {
+            emitter.leaf(::pltxt2htm::NodeType::less_than, limited_sink);
+            break;
+        }
+        case u8'>': {
+            emitter.leaf(::pltxt2htm::NodeType::greater_than, limited_sink);
+            break;
+        }
+        case u8'\\': {
+            limited_sink.push_back(u8'\\');
+            break;
+        }
+        default: {
+            if (*first > 0x7f) {
+                auto const length = ::pltxt2htm::details::utf8_sequence_length(first, last);
+                if (length == 0) {
+                    emitter.leaf(::pltxt2htm::NodeType::invalid_u8char, limited_sink);
+                } else {
+                    limited_sink.append(::fast_io::u8string_view{first, length});
+                    first += length - 1;
+                }
+            }
+            // control chars are dropped
+            break;
+        }
+        }
+        ++first;
+    }
+}
+
+} // namespace details
+
+} // namespace pltxt2htm
@@ -2,10 +2,11 @@
 
 #include <cstddef>
 #include <iterator>
-#include <fast_io/fast_io_dsal/list.h>
-#include <fast_io/fast_io_dsal/stack.h>
+#include <fast_io/fast_io_dsal/string_view.h>
 #include "utils.hh"
 #include "heap_guard.hh"
+#include "frame_stack.hh"
+#include "limits.hh"
 #include "astnode/basic.hh"
 #include "astnode/node_type.hh"
 #include "astnode/physics_lab_node.hh"
@@ -14,6 +15,12 @@ namespace pltxt2htm {
 
 namespace details {
 
+/**
+ * @brief Frame of the optimizer's call stack.
+ * @note The attribute of the tag is a union selected by `nested_tag_type`:
+ *       - pl_color, pl_experiment, pl_discussion, pl_user: `id`
+ *       - pl_size: `size`
+ */
 template<::std::forward_iterator Iter>
 class OptimizerContext {
 public:
@@ -21,10 +28,32 @@ public:
     ::pltxt2htm::NodeType const nested_tag_type;
     Iter iter;
 
+    union {
+        ::fast_io::u8string_view id;
+        ::std::size_t size;
+    };
+
     OptimizerContext(::pltxt2htm::Ast* ast_, ::pltxt2htm::NodeType const nested_tag_type_, Iter&& iter_) noexcept
         : ast(ast_),
           nested_tag_type{nested_tag_type_},
-          iter{iter_} {
+          iter{iter_},
+          size{} {
+    }
+
+    OptimizerContext(::pltxt2htm::Ast* ast_, ::pltxt2htm::NodeType const nested_tag_type_, Iter&& iter_,
+                     ::fast_io::u8string_view id_) noexcept
+        : ast(ast_),
+          nested_tag_type{nested_tag_type_},
+          iter{iter_},
+          id{id_} {
+    }
+
+    OptimizerContext(::pltxt2htm::Ast* ast_, ::pltxt2htm::NodeType const nested_tag_type_, Iter&& iter_,
+                     ::std::size_t size_) noexcept
+        : ast(ast_),
+          nested_tag_type{nested_tag_type_},
+          iter{iter_},
+          size{size_} {
     }
 
     constexpr OptimizerContext(::pltxt2htm::details::OptimizerContext<Iter> const&) noexcept = default;
@@ -33,85 +62,38 @@ public:
 
     constexpr ~OptimizerContext() noexcept = default;
 
+    // const member do not support operator=
     constexpr ::pltxt2htm::details::OptimizerContext<Iter>& operator=(
-        ::pltxt2htm::details::OptimizerContext<Iter> const&) noexcept = default;
+        ::pltxt2htm::details::OptimizerContext<Iter> const&) noexcept = delete;
 
     constexpr ::pltxt2htm::details::OptimizerContext<Iter>& operator=(
-        ::pltxt2htm::details::OptimizerContext<Iter>&&) noexcept = default;
-};
-
-template<::std::forward_iterator Iter>
-class OptimizerEqualSignTagContext : public ::pltxt2htm::details::OptimizerContext<Iter> {
-public:
-    ::fast_io::u8string_view id_;
-
-    OptimizerEqualSignTagContext(::pltxt2htm::Ast* ast, ::pltxt2htm::NodeType const nested_tag_type, Iter&& iter,
-                                 ::fast_io::u8string_view id) noexcept
-        : ::pltxt2htm::details::OptimizerContext<Iter>(ast, nested_tag_type, ::std::move(iter)),
-          id_{id} {
-    }
-
-    constexpr OptimizerEqualSignTagContext(::pltxt2htm::details::OptimizerEqualSignTagContext<Iter> const&) noexcept =
-        default;
-    constexpr OptimizerEqualSignTagContext(::pltxt2htm::details::OptimizerEqualSignTagContext<Iter>&&) noexcept =
-        default;
-
-    constexpr ~OptimizerEqualSignTagContext() noexcept = default;
-
-    // const reference do not support operator=
-    constexpr ::pltxt2htm::details::OptimizerEqualSignTagContext<Iter>& operator=(
-        ::pltxt2htm::details::OptimizerEqualSignTagContext<Iter> const&) noexcept = delete;
-    constexpr ::pltxt2htm::details::OptimizerEqualSignTagContext<Iter>& operator=(
-        ::pltxt2htm::details::OptimizerEqualSignTagContext<Iter>&&) noexcept = delete;
-};
-
-template<::std::forward_iterator Iter>
-class OptimizerPlSizeTagContext : public ::pltxt2htm::details::OptimizerContext<Iter> {
-public:
-    ::std::size_t id_;
-
-    OptimizerPlSizeTagContext(::pltxt2htm::Ast* ast, ::pltxt2htm::NodeType const nested_tag_type, Iter&& iter,
-                              ::std::size_t id) noexcept
-        : ::pltxt2htm::details::OptimizerContext<Iter>(ast, nested_tag_type, ::std::move(iter)),
-          id_{id} {
-    }
-
-    constexpr OptimizerPlSizeTagContext(::pltxt2htm::details::OptimizerPlSizeTagContext<Iter> const&) noexcept =
-        default;
-
-    constexpr OptimizerPlSizeTagContext(::pltxt2htm::details::OptimizerPlSizeTagContext<Iter>&&) noexcept = default;
-
-    constexpr ~OptimizerPlSizeTagContext() noexcept = default;
-
-    // const reference do not support operator=
-    constexpr ::pltxt2htm::details::OptimizerPlSizeTagContext<Iter>& operator=(
-        ::pltxt2htm::details::OptimizerPlSizeTagContext<Iter> const&) noexcept = delete;
-
-    constexpr ::pltxt2htm::details::OptimizerPlSizeTagContext<Iter>& operator=(
-        ::pltxt2htm::details::OptimizerPlSizeTagContext<Iter>&&) noexcept = delete;
+        ::pltxt2htm::details::OptimizerContext<Iter>&&) noexcept = delete;
 };
 
-} // namespace details
-
-template<bool ndebug>
-constexpr void optimize_ast(::pltxt2htm::Ast& ast_init) noexcept {
-    ::fast_io::stack<
-        ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>,
-        ::fast_io::list<
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>>>
-        call_stack{};
-    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>{
-        ::std::addressof(ast_init), ::pltxt2htm::NodeType::base, ast_init.begin()});
+/**
+ * @brief Impl of `optimize_ast`.
+ * @param budget: `Unlimited`, or `Budget` (see pltxt2htm/limits.hh) whose run out stops the optimization.
+ *                The ast is consistent after every step, so it is valid but only partly optimized then.
+ */
+template<bool ndebug, typename Budget>
+constexpr void optimize_ast(::pltxt2htm::Ast& ast_init, Budget& budget) noexcept {
+    ::pltxt2htm::details::FrameStack<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>> call_stack{};
+    call_stack.emplace(::std::addressof(ast_init), ::pltxt2htm::NodeType::base, ast_init.begin());
 
 restart:
-    auto&& ast = *(call_stack.top()->ast);
-    auto&& current_iter = call_stack.top()->iter;
+    auto&& ast = *(call_stack.top().ast);
+    auto&& current_iter = call_stack.top().iter;
     for (; current_iter != ast.end(); ++current_iter) {
+        if (budget.tick()) {
+            return;
+        }
         auto&& node = *current_iter;
 
         switch (node->node_type()) {
         case ::pltxt2htm::NodeType::u8char:
             [[fallthrough]];
+        case ::pltxt2htm::NodeType::text_run:
+            [[fallthrough]];
         case ::pltxt2htm::NodeType::invalid_u8char:
             [[fallthrough]];
         case ::pltxt2htm::NodeType::space:
@@ -142,9 +124,7 @@ restart:
         case ::pltxt2htm::NodeType::text: {
             auto text = reinterpret_cast<::pltxt2htm::details::PairedTagBase*>(node.get_unsafe());
             auto&& subast = text->get_subast();
-            call_stack.push(
-                ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>(
-                    ::std::addressof(subast), ::pltxt2htm::NodeType::text, subast.begin()));
+            call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::text, subast.begin());
             goto restart;
         }
         case ::pltxt2htm::NodeType::pl_color:
@@ -163,22 +143,16 @@ restart:
                     }
                 }
             }
-            auto&& nested_tag_type = call_stack.top()->nested_tag_type;
+            auto&& nested_tag_type = call_stack.top().nested_tag_type;
             // Optimization: If the color is the same as the parent node, then ignore the nested tag.
             bool const is_not_same_tag =
                 (nested_tag_type != ::pltxt2htm::NodeType::pl_color &&
                  nested_tag_type != ::pltxt2htm::NodeType::pl_a) ||
-                color->get_color() !=
-                    reinterpret_cast<
-                        ::pltxt2htm::details::OptimizerEqualSignTagContext<::pltxt2htm::Ast::iterator> const*>(
-                        call_stack.top().release_imul())
-                        ->id_;
+                color->get_color() != call_stack.top().id;
             if (is_not_same_tag) {
                 auto&& subast = color->get_subast();
-                call_stack.push(::pltxt2htm::details::HeapGuard<
-                                ::pltxt2htm::details::OptimizerEqualSignTagContext<::pltxt2htm::Ast::iterator>>(
-                    ::std::addressof(subast), ::pltxt2htm::NodeType::pl_color, subast.begin(),
-                    ::fast_io::mnp::os_c_str(color->get_color())));
+                call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::pl_color, subast.begin(),
+                                   color->get_color());
                 goto restart;
             } else {
                 // Optimization: If the color is the same as the parent node, then ignore the nested tag.
@@ -202,21 +176,14 @@ restart:
                     }
                 }
             }
-            auto&& nested_tag_type = call_stack.top()->nested_tag_type;
+            auto&& nested_tag_type = call_stack.top().nested_tag_type;
             // Optimization: If the experiment is the same as the parent node, then ignore the nested tag.
             bool const is_not_same_tag =
-                nested_tag_type != ::pltxt2htm::NodeType::pl_experiment ||
-                experiment->get_id() !=
-                    reinterpret_cast<
-                        ::pltxt2htm::details::OptimizerEqualSignTagContext<::pltxt2htm::Ast::iterator> const*>(
-                        call_stack.top().release_imul())
-                        ->id_;
+                nested_tag_type != ::pltxt2htm::NodeType::pl_experiment || experiment->get_id() != call_stack.top().id;
             if (is_not_same_tag) {
                 auto&& subast = experiment->get_subast();
-                call_stack.push(::pltxt2htm::details::HeapGuard<
-                                ::pltxt2htm::details::OptimizerEqualSignTagContext<::pltxt2htm::Ast::iterator>>(
-                    ::std::addressof(subast), ::pltxt2htm::NodeType::pl_experiment, subast.begin(),
-                    ::fast_io::mnp::os_c_str(experiment->get_id())));
+                call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::pl_experiment, subast.begin(),
+                                   experiment->get_id());
                 goto restart;
             } else {
                 node = static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
@@ -241,21 +208,14 @@ restart:
                     }
                 }
             }
-            auto&& nested_tag_type = call_stack.top()->nested_tag_type;
+            auto&& nested_tag_type = call_stack.top().nested_tag_type;
             // Optimization: If the discussion is the same as the parent node, then ignore the nested tag.
             bool const is_not_same_tag =
-                nested_tag_type != ::pltxt2htm::NodeType::pl_discussion ||
-                discussion->get_id() !=
-                    reinterpret_cast<
-                        ::pltxt2htm::details::OptimizerEqualSignTagContext<::pltxt2htm::Ast::iterator> const*>(
-                        call_stack.top().release_imul())
-                        ->id_;
+                nested_tag_type != ::pltxt2htm::NodeType::pl_discussion || discussion->get_id() != call_stack.top().id;
             if (is_not_same_tag) {
                 auto&& subast = discussion->get_subast();
-                call_stack.push(::pltxt2htm::details::HeapGuard<
-                                ::pltxt2htm::details::OptimizerEqualSignTagContext<::pltxt2htm::Ast::iterator>>(
-                    ::std::addressof(subast), ::pltxt2htm::NodeType::pl_discussion, subast.begin(),
-                    ::fast_io::mnp::os_c_str(discussion->get_id())));
+                call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::pl_discussion, subast.begin(),
+                                   discussion->get_id());
                 goto restart;
             } else {
                 node = static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
@@ -276,21 +236,14 @@ restart:
                     }
                 }
             }
-            auto&& nested_tag_type = call_stack.top()->nested_tag_type;
+            auto&& nested_tag_type = call_stack.top().nested_tag_type;
             // Optimization: If the user is the same as the parent node, then ignore the nested tag.
             bool const is_not_same_tag =
-                nested_tag_type != ::pltxt2htm::NodeType::pl_user ||
-                user->get_id() !=
-                    reinterpret_cast<
-                        ::pltxt2htm::details::OptimizerEqualSignTagContext<::pltxt2htm::Ast::iterator> const*>(
-                        call_stack.top().get_unsafe())
-                        ->id_;
+                nested_tag_type != ::pltxt2htm::NodeType::pl_user || user->get_id() != call_stack.top().id;
             if (is_not_same_tag) {
                 auto&& subast = user->get_subast();
-                call_stack.push(::pltxt2htm::details::HeapGuard<
-                                ::pltxt2htm::details::OptimizerEqualSignTagContext<::pltxt2htm::Ast::iterator>>(
-                    ::std::addressof(subast), ::pltxt2htm::NodeType::pl_user, subast.begin(),
-                    ::fast_io::mnp::os_c_str(user->get_id())));
+                call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::pl_user, subast.begin(),
+                                   user->get_id());
                 goto restart;
             } else {
                 node = static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
@@ -311,20 +264,14 @@ restart:
                     }
                 }
             }
-            auto&& nested_tag_type = call_stack.top()->nested_tag_type;
+            auto&& nested_tag_type = call_stack.top().nested_tag_type;
             // Optimization: If the size is the same as the parent node, then ignore the nested tag.
             bool const is_not_same_tag =
-                nested_tag_type != ::pltxt2htm::NodeType::pl_size ||
-                size->get_id() !=
-                    reinterpret_cast<
-                        ::pltxt2htm::details::OptimizerPlSizeTagContext<::pltxt2htm::Ast::iterator> const*>(
-                        call_stack.top().release_imul())
-                        ->id_;
+                nested_tag_type != ::pltxt2htm::NodeType::pl_size || size->get_id() != call_stack.top().size;
             if (is_not_same_tag) {
                 auto&& subast = size->get_subast();
-                call_stack.push(::pltxt2htm::details::HeapGuard<
-                                ::pltxt2htm::details::OptimizerPlSizeTagContext<::pltxt2htm::Ast::iterator>>(
-                    ::std::addressof(subast), ::pltxt2htm::NodeType::pl_size, subast.begin(), size->get_id()));
+                call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::pl_size, subast.begin(),
+                                   size->get_id());
                 goto restart;
             } else {
                 node = static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
@@ -336,14 +283,12 @@ restart:
             [[fallthrough]];
         case ::pltxt2htm::NodeType::pl_b: {
             auto b = reinterpret_cast<::pltxt2htm::details::PairedTagBase*>(node.get_unsafe());
-            auto&& nested_tag_type = call_stack.top()->nested_tag_type;
+            auto&& nested_tag_type = call_stack.top().nested_tag_type;
             bool const is_not_same_tag =
                 nested_tag_type != ::pltxt2htm::NodeType::pl_b && nested_tag_type != ::pltxt2htm::NodeType::html_strong;
             if (is_not_same_tag) {
                 auto&& subast = b->get_subast();
-                call_stack.push(
-                    ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>(
-                        ::std::addressof(subast), ::pltxt2htm::NodeType::html_strong, subast.begin()));
+                call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::html_strong, subast.begin());
                 goto restart;
             } else {
                 node = static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
@@ -354,9 +299,7 @@ restart:
         case ::pltxt2htm::NodeType::html_p: {
             auto p = reinterpret_cast<::pltxt2htm::details::PairedTagBase*>(node.get_unsafe());
             auto&& subast = p->get_subast();
-            call_stack.push(
-                ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>(
-                    ::std::addressof(subast), ::pltxt2htm::NodeType::html_p, subast.begin()));
+            call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::html_p, subast.begin());
             goto restart;
         }
         case ::pltxt2htm::NodeType::line_break:
@@ -370,9 +313,7 @@ restart:
             auto h1 = reinterpret_cast<::pltxt2htm::details::PairedTagBase*>(node.get_unsafe());
             // NOTE: All optimization to h1 has side effect
             auto&& subast = h1->get_subast();
-            call_stack.push(
-                ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>(
-                    ::std::addressof(subast), ::pltxt2htm::NodeType::html_h1, subast.begin()));
+            call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::html_h1, subast.begin());
             goto restart;
         }
         case ::pltxt2htm::NodeType::html_h2:
@@ -380,9 +321,7 @@ restart:
         case ::pltxt2htm::NodeType::md_atx_h2: {
             auto h2 = reinterpret_cast<::pltxt2htm::details::PairedTagBase*>(node.get_unsafe());
             auto&& subast = h2->get_subast();
-            call_stack.push(
-                ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>(
-                    ::std::addressof(subast), ::pltxt2htm::NodeType::html_h2, subast.begin()));
+            call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::html_h2, subast.begin());
             goto restart;
         }
         case ::pltxt2htm::NodeType::html_h3:
@@ -390,9 +329,7 @@ restart:
         case ::pltxt2htm::NodeType::md_atx_h3: {
             auto h3 = reinterpret_cast<::pltxt2htm::details::PairedTagBase*>(node.get_unsafe());
             auto&& subast = h3->get_subast();
-            call_stack.push(
-                ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>(
-                    ::std::addressof(subast), ::pltxt2htm::NodeType::html_h3, subast.begin()));
+            call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::html_h3, subast.begin());
             goto restart;
         }
         case ::pltxt2htm::NodeType::html_h4:
@@ -400,9 +337,7 @@ restart:
         case ::pltxt2htm::NodeType::md_atx_h4: {
             auto h4 = reinterpret_cast<::pltxt2htm::details::PairedTagBase*>(node.get_unsafe());
             auto&& subast = h4->get_subast();
-            call_stack.push(
-                ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>(
-                    ::std::addressof(subast), ::pltxt2htm::NodeType::html_h4, subast.begin()));
+            call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::html_h4, subast.begin());
             goto restart;
         }
         case ::pltxt2htm::NodeType::html_h5:
@@ -410,9 +345,7 @@ restart:
         case ::pltxt2htm::NodeType::md_atx_h5: {
             auto h5 = reinterpret_cast<::pltxt2htm::details::PairedTagBase*>(node.get_unsafe());
             auto&& subast = h5->get_subast();
-            call_stack.push(
-                ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>(
-                    ::std::addressof(subast), ::pltxt2htm::NodeType::html_h5, subast.begin()));
+            call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::html_h5, subast.begin());
             goto restart;
         }
         case ::pltxt2htm::NodeType::html_h6:
@@ -420,20 +353,16 @@ restart:
         case ::pltxt2htm::NodeType::md_atx_h6: {
             auto h6 = reinterpret_cast<::pltxt2htm::details::PairedTagBase*>(node.get_unsafe());
             auto&& subast = h6->get_subast();
-            call_stack.push(
-                ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>(
-                    ::std::addressof(subast), ::pltxt2htm::NodeType::html_h6, subast.begin()));
+            call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::html_h6, subast.begin());
             goto restart;
         }
         case ::pltxt2htm::NodeType::html_del: {
             auto del = reinterpret_cast<::pltxt2htm::details::PairedTagBase*>(node.get_unsafe());
-            auto&& nested_tag_type = call_stack.top()->nested_tag_type;
+            auto&& nested_tag_type = call_stack.top().nested_tag_type;
             bool const is_not_same_tag{nested_tag_type != ::pltxt2htm::NodeType::html_del};
             if (is_not_same_tag) {
                 auto&& subast = del->get_subast();
-                call_stack.push(
-                    ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>(
-                        ::std::addressof(subast), ::pltxt2htm::NodeType::html_del, subast.begin()));
+                call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::html_del, subast.begin());
                 goto restart;
             } else {
                 node = static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
@@ -445,14 +374,12 @@ restart:
             [[fallthrough]];
         case ::pltxt2htm::NodeType::html_em: {
             auto em = reinterpret_cast<::pltxt2htm::details::PairedTagBase*>(node.get_unsafe());
-            auto&& nested_tag_type = call_stack.top()->nested_tag_type;
+            auto&& nested_tag_type = call_stack.top().nested_tag_type;
             bool const is_not_same_tag{nested_tag_type != ::pltxt2htm::NodeType::html_em &&
                                        nested_tag_type != ::pltxt2htm::NodeType::pl_i};
             if (is_not_same_tag) {
                 auto&& subast = em->get_subast();
-                call_stack.push(
-                    ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>(
-                        ::std::addressof(subast), ::pltxt2htm::NodeType::html_em, subast.begin()));
+                call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::html_em, subast.begin());
             } else {
                 node = static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
                     ::pltxt2htm::details::HeapGuard<::pltxt2htm::Text>(::std::move(em->get_subast())));
@@ -470,39 +397,31 @@ restart:
         }
         case ::pltxt2htm::NodeType::html_ul: {
             //     auto ul = reinterpret_cast<::pltxt2htm::details::PairedTagBase const*>(node.release_imul());
-            //     auto&& nested_tag_type = call_stack.top()->nested_tag_type_;
+            //     auto&& nested_tag_type = call_stack.top().nested_tag_type_;
             //     bool const is_not_same_tag{nested_tag_type != ::pltxt2htm::NodeType::html_ul};
             auto ul = reinterpret_cast<::pltxt2htm::details::PairedTagBase*>(node.get_unsafe());
             auto&& subast = ul->get_subast();
-            call_stack.push(
-                ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>(
-                    ::std::addressof(subast), ::pltxt2htm::NodeType::html_ul, subast.begin()));
+            call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::html_ul, subast.begin());
             goto restart;
         }
         case ::pltxt2htm::NodeType::html_li: {
             auto li = reinterpret_cast<::pltxt2htm::details::PairedTagBase*>(node.get_unsafe());
-            //     auto&& nested_tag_type = call_stack.top()->nested_tag_type_;
+            //     auto&& nested_tag_type = call_stack.top().nested_tag_type_;
             //     bool const is_not_same_tag{nested_tag_type != ::pltxt2htm::NodeType::html_li};
             auto&& subast = li->get_subast();
-            call_stack.push(
-                ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>(
-                    ::std::addressof(subast), ::pltxt2htm::NodeType::html_li, subast.begin()));
+            call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::html_li, subast.begin());
             goto restart;
         }
         case ::pltxt2htm::NodeType::html_code: {
             auto code = reinterpret_cast<::pltxt2htm::details::PairedTagBase*>(node.get_unsafe());
             auto&& subast = code->get_subast();
-            call_stack.push(
-                ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>(
-                    ::std::addressof(subast), ::pltxt2htm::NodeType::html_code, subast.begin()));
+            call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::html_code, subast.begin());
             goto restart;
         }
         case ::pltxt2htm::NodeType::html_pre: {
             auto pre = reinterpret_cast<::pltxt2htm::details::PairedTagBase*>(node.get_unsafe());
             auto&& subast = pre->get_subast();
-            call_stack.push(
-                ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::OptimizerContext<::pltxt2htm::Ast::iterator>>(
-                    ::std::addressof(subast), ::pltxt2htm::NodeType::html_pre, subast.begin()));
+            call_stack.emplace(::std::addressof(subast), ::pltxt2htm::NodeType::html_pre, subast.begin());
             goto restart;
         }
         case ::pltxt2htm::NodeType::md_escape_backslash:
@@ -580,7 +499,7 @@ restart:
         if (call_stack.empty()) {
             return;
         } else {
-            switch (top_frame->nested_tag_type) {
+            switch (top_frame.nested_tag_type) {
             case ::pltxt2htm::NodeType::pl_a:
                 [[fallthrough]];
             case ::pltxt2htm::NodeType::pl_color:
@@ -602,11 +521,11 @@ restart:
             case ::pltxt2htm::NodeType::pl_i:
                 [[fallthrough]];
             case ::pltxt2htm::NodeType::html_del: {
-                if (top_frame->ast->empty()) {
+                if (top_frame.ast->empty()) {
                     // Optimization: if the tag is empty, we can skip it
-                    call_stack.top()->ast->erase(call_stack.top()->iter);
+                    call_stack.top().ast->erase(call_stack.top().iter);
                 } else {
-                    ++(call_stack.top()->iter);
+                    ++(call_stack.top().iter);
                 }
                 goto restart;
             }
@@ -644,4 +563,12 @@ restart:
     }
 }
 
+} // namespace details
+
+template<bool ndebug>
+constexpr void optimize_ast(::pltxt2htm::Ast& ast_init) noexcept {
+    ::pltxt2htm::details::Unlimited budget{};
+    ::pltxt2htm::details::optimize_ast<ndebug>(ast_init, budget);
+}
+
 } // namespace pltxt2htm
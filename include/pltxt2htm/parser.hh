@@ -4,13 +4,16 @@
     #include <ranges>
 #endif
 #include <cstddef>
-#include <fast_io/fast_io_dsal/list.h>
-#include <fast_io/fast_io_dsal/stack.h>
 #include <fast_io/fast_io_dsal/vector.h>
 #include <fast_io/fast_io_dsal/string.h>
 #include <fast_io/fast_io_dsal/string_view.h>
 #include <exception/exception.hh>
 #include "utils.hh"
+#include "arena.hh"
+#include "frame_stack.hh"
+#include "tag_name.hh"
+#include "scanner.hh"
+#include "limits.hh"
 #include "heap_guard.hh"
 #include "astnode/node_type.hh"
 #include "astnode/basic.hh"
@@ -49,7 +52,19 @@ constexpr bool is_prefix_match(::fast_io::u8string_view str)
         return false;
     }
 
-    // Return whether the `prefix_str` is a prefix of the str.
+    // Compare 8 bytes at a time: letters are case folded by the mask, then one comparison per word.
+    constexpr ::std::size_t word_count{(sizeof...(prefix_str) + 7) / 8};
+    if (str.size() >= word_count * 8) [[likely]] {
+        return [str]<::std::size_t... Is>(::std::index_sequence<Is...>) {
+            return ((((::pltxt2htm::details::load_word(str.data() + Is * 8) |
+                       ::pltxt2htm::details::name_fold_mask<Is * 8, prefix_str...>()) &
+                      ::pltxt2htm::details::low_bytes_mask(sizeof...(prefix_str) - Is * 8)) ==
+                     ::pltxt2htm::details::name_word<Is * 8, prefix_str...>()) &&
+                    ...);
+        }(::std::make_index_sequence<word_count>{});
+    }
+
+    // Near the end of the text, compare byte by byte.
 #if __cpp_expansion_statements >= 202506L
     template for (constexpr ::std::size_t I : ::std::ranges::views::iota(::std::size_t{}, sizeof...(prefix_str))) {
 #else
@@ -82,11 +97,33 @@ constexpr bool is_prefix_match(::fast_io::u8string_view str)
 #endif
 }
 
+/**
+ * @brief Append `length` bytes of `pltext` starting from `begin` to `result` as plain text.
+ * @note If the last node of `result` is a TextRun ending right before `begin`, the run is
+ *       extended instead of appending a new node.
+ */
+template<bool ndebug>
+constexpr void push_text_run(::fast_io::u8string_view const& pltext, ::std::size_t begin, ::std::size_t length,
+                             ::pltxt2htm::Ast& result) noexcept {
+    auto const text = ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, begin, length);
+    if (!result.empty()) {
+        auto&& last = result.back_unchecked();
+        if (last->node_type() == ::pltxt2htm::NodeType::text_run) {
+            auto run = reinterpret_cast<::pltxt2htm::TextRun*>(last.get_unsafe());
+            if (auto const run_text = run->get_text(); run_text.data() + run_text.size() == text.data()) {
+                run->extend(length);
+                return;
+            }
+        }
+    }
+    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::TextRun>{text});
+}
+
 /**
  * @brief Parse a single UTF-8 code point and append the corresponding AST node(s).
  *
  * This function reads the character at `current_index` and, if it forms a valid
- * UTF-8 sequence, appends the appropriate node(s) to `result` and advances
+ * UTF-8 sequence, appends it to the trailing `TextRun` of `result` and advances
  * `current_index` by the number of consumed bytes.  On any invalid sequence it
  * appends an `::pltxt2htm::details::HeapGuard<::pltxt2htm::InvalidU8Char>` node
  * and advances by one byte only.
@@ -94,11 +131,12 @@ constexpr bool is_prefix_match(::fast_io::u8string_view str)
  * @tparam ndebug  When `true`, runtime assertions are disabled.
  * @param pltext   The complete input text being parsed.
  * @param[in,out] current_index  Byte index into `pltext`.  Updated on exit.
+ * @param builder                Builder which the nodes are reported to, see `AstBuilder`.
  * @param[out] result            AST container to which new nodes are appended.
  */
-template<bool ndebug>
+template<bool ndebug, typename Builder>
 constexpr void parse_utf8_code_point(::fast_io::u8string_view const& pltext, ::std::size_t& current_index,
-                                     ::pltxt2htm::Ast& result) {
+                                     Builder& builder, typename Builder::children_type& result) {
     ::std::size_t const pltext_size{pltext.size()};
     char8_t const chr{::pltxt2htm::details::u8string_view_index<ndebug>(pltext, current_index)};
 
@@ -107,98 +145,92 @@ constexpr void parse_utf8_code_point(::fast_io::u8string_view const& pltext, ::s
     }
     if ((chr & 0x80) == 0) {
         // normal utf-8 characters
-        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::U8Char>{chr});
+        builder.push_text_run(pltext, current_index, 1, result);
         return;
     } else if ((chr & 0xE0) == 0xC0) {
         if (current_index + 1 >= pltext_size) {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::InvalidU8Char>{});
+            builder.template push<::pltxt2htm::InvalidU8Char>(result);
             return;
         }
         auto next_char = ::pltxt2htm::details::u8string_view_index<ndebug>(pltext, current_index + 1);
         if ((next_char & 0xC0) != 0x80) {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::InvalidU8Char>{});
+            builder.template push<::pltxt2htm::InvalidU8Char>(result);
             return;
         }
         char32_t combine{static_cast<char32_t>(chr & 0x1F) << 6 | static_cast<char32_t>(next_char & 0x3F)};
         if (combine < 0x80 || combine > 0x7FF) {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::InvalidU8Char>{});
+            builder.template push<::pltxt2htm::InvalidU8Char>(result);
             return;
         }
 
-        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::U8Char>{chr});
-        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::U8Char>{next_char});
+        builder.push_text_run(pltext, current_index, 2, result);
         current_index += 1;
         return;
     } else if ((chr & 0xF0) == 0xE0) {
         if (current_index + 2 >= pltext_size) {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::InvalidU8Char>{});
+            builder.template push<::pltxt2htm::InvalidU8Char>(result);
             return;
         }
         auto next_char = ::pltxt2htm::details::u8string_view_index<ndebug>(pltext, current_index + 1);
         if ((next_char & 0xC0) != 0x80) {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::InvalidU8Char>{});
+            builder.template push<::pltxt2htm::InvalidU8Char>(result);
             return;
         }
         auto next_char2 = ::pltxt2htm::details::u8string_view_index<ndebug>(pltext, current_index + 2);
         if ((next_char2 & 0xC0) != 0x80) {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::InvalidU8Char>{});
+            builder.template push<::pltxt2htm::InvalidU8Char>(result);
             return;
         }
         char32_t combine{static_cast<char32_t>(chr & 0x0f) << 12 | static_cast<char32_t>(next_char & 0x3f) << 6 |
                          static_cast<char32_t>(next_char2 & 0x3f)};
         if (combine < 0x800 || combine > 0xffff) {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::InvalidU8Char>{});
+            builder.template push<::pltxt2htm::InvalidU8Char>(result);
             return;
         }
         if (0xd800 <= combine && combine <= 0xdfff) {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::InvalidU8Char>{});
+            builder.template push<::pltxt2htm::InvalidU8Char>(result);
             return;
         }
 
-        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::U8Char>{chr});
-        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::U8Char>{next_char});
-        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::U8Char>{next_char2});
+        builder.push_text_run(pltext, current_index, 3, result);
         current_index += 2;
         return;
     } else if ((chr & 0xF8) == 0xF0) {
         if (current_index + 3 >= pltext_size) {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::InvalidU8Char>{});
+            builder.template push<::pltxt2htm::InvalidU8Char>(result);
             return;
         }
         auto next_char = ::pltxt2htm::details::u8string_view_index<ndebug>(pltext, current_index + 1);
         if ((next_char & 0xC0) != 0x80) {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::InvalidU8Char>{});
+            builder.template push<::pltxt2htm::InvalidU8Char>(result);
             return;
         }
         auto next_char2 = ::pltxt2htm::details::u8string_view_index<ndebug>(pltext, current_index + 2);
         if ((next_char & 0xC0) != 0x80) {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::InvalidU8Char>{});
+            builder.template push<::pltxt2htm::InvalidU8Char>(result);
             return;
         }
         auto next_char3 = ::pltxt2htm::details::u8string_view_index<ndebug>(pltext, current_index + 3);
         if ((next_char3 & 0xC0) != 0x80) {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::InvalidU8Char>{});
+            builder.template push<::pltxt2htm::InvalidU8Char>(result);
             return;
         }
         char32_t combine{static_cast<char32_t>(chr & 0x07) << 18 | static_cast<char32_t>(next_char & 0x3F) << 12 |
                          static_cast<char32_t>(next_char2 & 0x3F) << 6 | static_cast<char32_t>(next_char3 & 0x3F)};
         if (combine < 0x10000 || combine > 0x10FFFF) {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::InvalidU8Char>{});
+            builder.template push<::pltxt2htm::InvalidU8Char>(result);
             return;
         }
         if (0xd800 <= combine && combine <= 0xdfff) {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::InvalidU8Char>{});
+            builder.template push<::pltxt2htm::InvalidU8Char>(result);
             return;
         }
 
-        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::U8Char>{chr});
-        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::U8Char>{next_char});
-        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::U8Char>{next_char2});
-        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::U8Char>{next_char3});
+        builder.push_text_run(pltext, current_index, 4, result);
         current_index += 3;
         return;
     } else {
-        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::InvalidU8Char>{});
+        builder.template push<::pltxt2htm::InvalidU8Char>(result);
         return;
     }
 }
@@ -209,6 +241,8 @@ constexpr void parse_utf8_code_point(::fast_io::u8string_view const& pltext, ::s
  * @tparam tag_name: The prefix string.
  * @param pltext: The string to be checked.
  * @return Whether the string is a prefix of the pl-text.
+ * @note Only spaces are scanned after `tag_name`, therefore scans started at different `<` never overlap and the
+ *       total work of the parser stays linear, even if `>` never comes.
  */
 template<bool ndebug, char8_t... tag_name>
 [[nodiscard]]
@@ -234,8 +268,10 @@ constexpr auto try_parse_bare_tag(::fast_io::u8string_view pltext)
 
 /**
  * @brief parsing `Tag=$1>`
- * @param[out] substr: str of $1
- * @param func: Check whether the character append to substr is valid
+ * @param[out] substr: str of $1, which is a view of `pltext`
+ * @param func: Check whether the character of substr is valid
+ * @note The scan stops at the first character rejected by `func` (`<` is always rejected) or at the first non-space
+ *       after the spaces, so that `<color=aaaa` without `>` is not scanned again from the next `<`.
  */
 template<bool ndebug, char8_t... prefix_str, typename Func>
     requires requires(Func&& func, char8_t chr) {
@@ -243,7 +279,7 @@ template<bool ndebug, char8_t... prefix_str, typename Func>
     }
 [[nodiscard]]
 constexpr bool try_parse_equal_sign_tag(::fast_io::u8string_view pltext, ::std::size_t& extern_index,
-                                        ::fast_io::u8string& substr, Func&& func)
+                                        ::fast_io::u8string_view& substr, Func&& func)
 #if __cpp_exceptions < 199711L
     noexcept
 #endif
@@ -252,10 +288,13 @@ constexpr bool try_parse_equal_sign_tag(::fast_io::u8string_view pltext, ::std::
         return false;
     }
 
-    for (::std::size_t forward_index{sizeof...(prefix_str) + 1}; forward_index < pltext.size(); ++forward_index) {
+    constexpr ::std::size_t substr_begin{sizeof...(prefix_str) + 1};
+    for (::std::size_t forward_index{substr_begin}; forward_index < pltext.size(); ++forward_index) {
         char8_t const forward_chr{::pltxt2htm::details::u8string_view_index<ndebug>(pltext, forward_index)};
         if (forward_chr == u8'>') {
             extern_index = forward_index;
+            substr = ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, substr_begin,
+                                                                         forward_index - substr_begin);
             if (substr.empty()) {
                 // test/0030.fuzzing-crassh1.cc
                 // <size=>text
@@ -263,6 +302,8 @@ constexpr bool try_parse_equal_sign_tag(::fast_io::u8string_view pltext, ::std::
             }
             return true;
         } else if (forward_chr == u8' ') {
+            substr = ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, substr_begin,
+                                                                         forward_index - substr_begin);
             while (true) {
                 if (forward_index + 1 >= pltext.size()) {
                     return false;
@@ -282,9 +323,7 @@ constexpr bool try_parse_equal_sign_tag(::fast_io::u8string_view pltext, ::std::
                     return false;
                 }
             }
-        } else if (func(forward_chr)) {
-            substr.push_back(forward_chr);
-        } else {
+        } else if (!func(forward_chr)) {
             return false;
         }
     }
@@ -294,6 +333,7 @@ constexpr bool try_parse_equal_sign_tag(::fast_io::u8string_view pltext, ::std::
 /**
  * @brief try to parsing `<tag_name>` or `<tag_name/>`
  * @param[in] pltext: source text
+ * @note Like `try_parse_bare_tag`, only spaces and `/` are scanned after `tag_name`.
  */
 template<bool ndebug, char8_t... tag_name>
 [[nodiscard]]
@@ -403,7 +443,8 @@ constexpr bool try_parse_md_atx_heading(::fast_io::u8string_view pltext, ::std::
         }
         ++start_index;
     }
-    // end of the atx header
+    // end of the atx header, the heading may run to the end of the text
+    ending_type.ending_type = ::pltxt2htm::details::MdAtxHeadingEndingType::no_ending;
     ::std::size_t sublength{start_index};
     for (; sublength < pltext_size; ++sublength) {
         if (::pltxt2htm::details::u8string_view_index<ndebug>(pltext, sublength) == u8'\n') {
@@ -551,234 +592,486 @@ constexpr auto switch_md_atx_header(::pltxt2htm::NodeType md_atx_heading_type, :
 
 /**
  * @brief Switch to a markdown punctuation character.
+ * @param func: Invoked as `func.template operator()<Node>()` with the node of the escaped character.
+ * @return Whether `u8char` can be escaped.
  */
-constexpr ::exception::optional<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>> switch_escape_char(
-    char8_t u8char) noexcept {
+template<typename Func>
+constexpr bool visit_escape_char(char8_t u8char, Func&& func)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
     switch (u8char) {
     case u8'\\': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeBackslash>{});
+        func.template operator()<::pltxt2htm::EscapeBackslash>();
+        return true;
     }
     case u8'!': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeExclamation>{});
+        func.template operator()<::pltxt2htm::EscapeExclamation>();
+        return true;
     }
     case u8'\"': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeDoubleQuote>{});
+        func.template operator()<::pltxt2htm::EscapeDoubleQuote>();
+        return true;
     }
     case u8'#': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeHash>{});
+        func.template operator()<::pltxt2htm::EscapeHash>();
+        return true;
     }
     case u8'$': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeDollar>{});
+        func.template operator()<::pltxt2htm::EscapeDollar>();
+        return true;
     }
     case u8'%': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapePercent>{});
+        func.template operator()<::pltxt2htm::EscapePercent>();
+        return true;
     }
     case u8'&': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeAmpersand>{});
+        func.template operator()<::pltxt2htm::EscapeAmpersand>();
+        return true;
     }
     case u8'\'': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeSingleQuote>{});
+        func.template operator()<::pltxt2htm::EscapeSingleQuote>();
+        return true;
     }
     case u8'(': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeLeftParen>{});
+        func.template operator()<::pltxt2htm::EscapeLeftParen>();
+        return true;
     }
     case u8')': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeRightParen>{});
+        func.template operator()<::pltxt2htm::EscapeRightParen>();
+        return true;
     }
     case u8'*': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeAsterisk>{});
+        func.template operator()<::pltxt2htm::EscapeAsterisk>();
+        return true;
     }
     case u8'+': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapePlus>{});
+        func.template operator()<::pltxt2htm::EscapePlus>();
+        return true;
     }
     case u8',': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeComma>{});
+        func.template operator()<::pltxt2htm::EscapeComma>();
+        return true;
     }
     case u8'-': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeHyphen>{});
+        func.template operator()<::pltxt2htm::EscapeHyphen>();
+        return true;
     }
     case u8'.': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeDot>{});
+        func.template operator()<::pltxt2htm::EscapeDot>();
+        return true;
     }
     case u8'/': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeSlash>{});
+        func.template operator()<::pltxt2htm::EscapeSlash>();
+        return true;
     }
     case u8':': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeColon>{});
+        func.template operator()<::pltxt2htm::EscapeColon>();
+        return true;
     }
     case u8';': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeSemicolon>{});
+        func.template operator()<::pltxt2htm::EscapeSemicolon>();
+        return true;
     }
     case u8'<': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeLessThan>{});
+        func.template operator()<::pltxt2htm::EscapeLessThan>();
+        return true;
     }
     case u8'=': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeEquals>{});
+        func.template operator()<::pltxt2htm::EscapeEquals>();
+        return true;
     }
     case u8'>': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeGreaterThan>{});
+        func.template operator()<::pltxt2htm::EscapeGreaterThan>();
+        return true;
     }
     case u8'?': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeQuestion>{});
+        func.template operator()<::pltxt2htm::EscapeQuestion>();
+        return true;
     }
     case u8'@': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeAt>{});
+        func.template operator()<::pltxt2htm::EscapeAt>();
+        return true;
     }
     case u8'[': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeLeftBracket>{});
+        func.template operator()<::pltxt2htm::EscapeLeftBracket>();
+        return true;
     }
     case u8']': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeRightBracket>{});
+        func.template operator()<::pltxt2htm::EscapeRightBracket>();
+        return true;
     }
     case u8'^': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeCaret>{});
+        func.template operator()<::pltxt2htm::EscapeCaret>();
+        return true;
     }
     case u8'_': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeUnderscore>{});
+        func.template operator()<::pltxt2htm::EscapeUnderscore>();
+        return true;
     }
     case u8'`': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeBacktick>{});
+        func.template operator()<::pltxt2htm::EscapeBacktick>();
+        return true;
     }
     case u8'{': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeLeftBrace>{});
+        func.template operator()<::pltxt2htm::EscapeLeftBrace>();
+        return true;
     }
     case u8'|': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapePipe>{});
+        func.template operator()<::pltxt2htm::EscapePipe>();
+        return true;
     }
     case u8'}': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeRightBrace>{});
+        func.template operator()<::pltxt2htm::EscapeRightBrace>();
+        return true;
     }
     case u8'~': {
-        return static_cast<::pltxt2htm::details::HeapGuard<::pltxt2htm::PlTxtNode>>(
-            ::pltxt2htm::details::HeapGuard<::pltxt2htm::EscapeTilde>{});
+        func.template operator()<::pltxt2htm::EscapeTilde>();
+        return true;
     }
     default:
-        return ::exception::nullopt_t{};
+        return false;
     }
 }
 
+/**
+ * @brief Frame of the parser's call stack.
+ * @tparam Children: `children_type` of the builder, see `AstBuilder`.
+ * @note The attribute of the tag is a union selected by `nested_tag_type`:
+ *       - pl_color, pl_a, pl_experiment, pl_discussion, pl_user: `id`
+ *       - pl_size: `size`
+ *       - md_atx_h1 ~ md_atx_h6: `ending_type`
+ */
+template<typename Children>
 class BasicFrameContext {
 public:
     ::fast_io::u8string_view pltext;
     ::pltxt2htm::NodeType const nested_tag_type;
     ::std::size_t current_index{};
-    ::pltxt2htm::Ast subast{};
+    Children subast{};
 
-    constexpr ~BasicFrameContext() noexcept = default;
+    union {
+        ::std::size_t size;
+        ::fast_io::u8string_view id;
+        ::pltxt2htm::details::MdAtxEndingType ending_type;
+    };
 
-protected:
     constexpr BasicFrameContext(::fast_io::u8string_view pltext_, ::pltxt2htm::NodeType const nested_tag_type_) noexcept
         : pltext(pltext_),
-          nested_tag_type{nested_tag_type_} {
+          nested_tag_type{nested_tag_type_},
+          size{} {
     }
-};
 
-class BareTagContext : public ::pltxt2htm::details::BasicFrameContext {
-public:
-    constexpr BareTagContext(::fast_io::u8string_view pltext_, ::pltxt2htm::NodeType const nested_tag_type_) noexcept
-        : ::pltxt2htm::details::BasicFrameContext(pltext_, nested_tag_type_) {
+    constexpr BasicFrameContext(::fast_io::u8string_view pltext_, ::pltxt2htm::NodeType const nested_tag_type_,
+                                ::fast_io::u8string_view id_) noexcept
+        : pltext(pltext_),
+          nested_tag_type{nested_tag_type_},
+          id{id_} {
     }
 
-    constexpr ~BareTagContext() noexcept = default;
-};
-
-class MdAtxHeadingContext : public ::pltxt2htm::details::BasicFrameContext {
-public:
-    ::pltxt2htm::details::MdAtxEndingType ending_type;
+    constexpr BasicFrameContext(::fast_io::u8string_view pltext_, ::pltxt2htm::NodeType const nested_tag_type_,
+                                ::std::size_t size_) noexcept
+        : pltext(pltext_),
+          nested_tag_type{nested_tag_type_},
+          size{size_} {
+    }
 
-    constexpr MdAtxHeadingContext(::fast_io::u8string_view pltext_, ::pltxt2htm::NodeType const nested_tag_type_,
-                                  ::pltxt2htm::details::MdAtxEndingType ending_type_) noexcept
-        : ::pltxt2htm::details::BasicFrameContext(pltext_, nested_tag_type_),
+    constexpr BasicFrameContext(::fast_io::u8string_view pltext_, ::pltxt2htm::NodeType const nested_tag_type_,
+                                ::pltxt2htm::details::MdAtxEndingType ending_type_) noexcept
+        : pltext(pltext_),
+          nested_tag_type{nested_tag_type_},
           ending_type{ending_type_} {
     }
 
-    constexpr ~MdAtxHeadingContext() noexcept = default;
+    constexpr BasicFrameContext(::pltxt2htm::details::BasicFrameContext<Children>&&) noexcept = default;
+
+    constexpr ~BasicFrameContext() noexcept = default;
 };
 
-class EqualSignTagContext : public ::pltxt2htm::details::BasicFrameContext {
+/**
+ * @brief The parser reports the nodes it parsed to a builder, this one builds the ast of them.
+ * @tparam keep_comments: Whether the body of `<!--$comment-->` is kept as the child of the Note.
+ * @note `DirectRenderer` (see direct_render.hh) is the other builder, which renders html without the ast.
+ */
+template<bool ndebug, bool keep_comments = false>
+class AstBuilder {
 public:
-    ::fast_io::u8string id;
+    using children_type = ::pltxt2htm::Ast;
+    using call_stack_type = ::pltxt2htm::details::FrameStack<::pltxt2htm::details::BasicFrameContext<children_type>>;
+
+    /**
+     * @brief Whether the parser should stop, see `LimitedAstBuilder`.
+     */
+    [[nodiscard]]
+    static constexpr bool exhausted() noexcept {
+        return false;
+    }
+
+    /**
+     * @brief Append a node without children.
+     */
+    template<typename Node>
+    constexpr void push(this AstBuilder&, ::pltxt2htm::Ast& children) noexcept {
+        children.push_back(::pltxt2htm::details::HeapGuard<Node>{});
+    }
+
+    constexpr void push_text_run(this AstBuilder&, ::fast_io::u8string_view const& pltext, ::std::size_t begin,
+                                 ::std::size_t length, ::pltxt2htm::Ast& children) noexcept {
+        ::pltxt2htm::details::push_text_run<ndebug>(pltext, begin, length, children);
+    }
+
+    /**
+     * @brief Append `<!--$comment-->`.
+     * @note The backends never render the comment, so its body is only kept as a TextRun if `keep_comments`.
+     *       The empty Note is still pushed, because it makes its parent survive `optimize_ast`.
+     */
+    constexpr void push_note(this AstBuilder&, ::pltxt2htm::Ast& children, ::fast_io::u8string_view comment) noexcept {
+        ::pltxt2htm::Ast subast{};
+        if constexpr (keep_comments) {
+            if (!comment.empty()) {
+                subast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::TextRun>(comment));
+            }
+        } else {
+            static_cast<void>(comment);
+        }
+        children.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Note>(::std::move(subast)));
+    }
+
+    /**
+     * @brief Push the frame of an opening tag.
+     */
+    template<typename... Args>
+    constexpr void open_frame(this AstBuilder&, call_stack_type& call_stack, Args&&... args) noexcept {
+        call_stack.emplace(::std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Pop the top frame and append the node of the tag to the frame below.
+     * @tparam closed_by_tag: Whether the tag is closed by its closing tag rather than the end of the text.
+     */
+    template<bool closed_by_tag>
+    constexpr void close_frame(this AstBuilder&, call_stack_type& call_stack) noexcept {
+        auto frame{::std::move(call_stack.top())};
+        call_stack.pop();
+        auto&& subast = frame.subast;
+        auto&& superast = call_stack.top().subast;
+        switch (frame.nested_tag_type) {
+        case ::pltxt2htm::NodeType::pl_color: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Color>(::std::move(subast), frame.id));
+            break;
+        }
+        case ::pltxt2htm::NodeType::pl_a: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::A>(::std::move(subast)));
+            break;
+        }
+        case ::pltxt2htm::NodeType::pl_experiment: {
+            superast.push_back(
+                ::pltxt2htm::details::HeapGuard<::pltxt2htm::Experiment>(::std::move(subast), frame.id));
+            break;
+        }
+        case ::pltxt2htm::NodeType::pl_discussion: {
+            superast.push_back(
+                ::pltxt2htm::details::HeapGuard<::pltxt2htm::Discussion>(::std::move(subast), frame.id));
+            break;
+        }
+        case ::pltxt2htm::NodeType::pl_user: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::User>(::std::move(subast), frame.id));
+            break;
+        }
+        case ::pltxt2htm::NodeType::pl_size: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Size>(::std::move(subast), frame.size));
+            break;
+        }
+        case ::pltxt2htm::NodeType::html_strong: {
+            // <strong> without closing tag is the same as <b>
+            if constexpr (closed_by_tag) {
+                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Strong>(::std::move(subast)));
+            } else {
+                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::B>(::std::move(subast)));
+            }
+            break;
+        }
+        case ::pltxt2htm::NodeType::pl_b: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::B>(::std::move(subast)));
+            break;
+        }
+        case ::pltxt2htm::NodeType::pl_i: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::I>(::std::move(subast)));
+            break;
+        }
+        case ::pltxt2htm::NodeType::html_p: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::P>(::std::move(subast)));
+            break;
+        }
+        case ::pltxt2htm::NodeType::html_h1: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::H1>(::std::move(subast)));
+            break;
+        }
+        case ::pltxt2htm::NodeType::html_h2: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::H2>(::std::move(subast)));
+            break;
+        }
+        case ::pltxt2htm::NodeType::html_h3: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::H3>(::std::move(subast)));
+            break;
+        }
+        case ::pltxt2htm::NodeType::html_h4: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::H4>(::std::move(subast)));
+            break;
+        }
+        case ::pltxt2htm::NodeType::html_h5: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::H5>(::std::move(subast)));
+            break;
+        }
+        case ::pltxt2htm::NodeType::html_h6: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::H6>(::std::move(subast)));
+            break;
+        }
+        case ::pltxt2htm::NodeType::html_del: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Del>(::std::move(subast)));
+            break;
+        }
+        case ::pltxt2htm::NodeType::html_em: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Em>(::std::move(subast)));
+            break;
+        }
+        case ::pltxt2htm::NodeType::html_ul: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Ul>(::std::move(subast)));
+            break;
+        }
+        case ::pltxt2htm::NodeType::html_li: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Li>(::std::move(subast)));
+            break;
+        }
+        case ::pltxt2htm::NodeType::html_code: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Code>(::std::move(subast)));
+            break;
+        }
+        case ::pltxt2htm::NodeType::html_pre: {
+            superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Pre>(::std::move(subast)));
+            break;
+        }
+        case ::pltxt2htm::NodeType::md_atx_h1:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_atx_h2:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_atx_h3:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_atx_h4:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_atx_h5:
+            [[fallthrough]];
+        case ::pltxt2htm::NodeType::md_atx_h6: {
+            superast.push_back(
+                ::pltxt2htm::details::switch_md_atx_header<ndebug>(frame.nested_tag_type, ::std::move(subast)));
+            break;
+        }
+        default:
+            [[unlikely]] {
+                ::exception::unreachable<ndebug>();
+            }
+        }
+    }
 
-    constexpr EqualSignTagContext(::fast_io::u8string_view pltext_, ::pltxt2htm::NodeType const nested_tag_type_,
-                                  ::fast_io::u8string&& id_) noexcept
-        : ::pltxt2htm::details::BasicFrameContext{pltext_, nested_tag_type_},
-          id(::std::move(id_)) {
+    /**
+     * @brief Append the markdown atx heading at the beginning of the text, its frame is the bottom of the call
+     *        stack and has been popped by the parser.
+     */
+    constexpr void push_md_atx_heading(this AstBuilder&, ::pltxt2htm::Ast& children,
+                                       ::pltxt2htm::NodeType md_atx_heading_type, ::pltxt2htm::Ast&& subast) noexcept {
+        children.push_back(
+            ::pltxt2htm::details::switch_md_atx_header<ndebug>(md_atx_heading_type, ::std::move(subast)));
     }
 
-    constexpr ~EqualSignTagContext() noexcept = default;
+    /**
+     * @brief Append nodes of `subast` to `children`.
+     */
+    constexpr void append(this AstBuilder&, ::pltxt2htm::Ast& children, ::pltxt2htm::Ast&& subast) noexcept {
+        for (auto&& node : subast) {
+            children.push_back(::std::move(node));
+        }
+    }
 };
 
-class PlSizeTagContext : public ::pltxt2htm::details::BasicFrameContext {
+/**
+ * @brief `AstBuilder` which counts the nodes and the nesting depth against `budget`, the parser stops once the
+ *        budget runs out.
+ */
+template<bool ndebug>
+class LimitedAstBuilder : public ::pltxt2htm::details::AstBuilder<ndebug> {
+    using base_type = ::pltxt2htm::details::AstBuilder<ndebug>;
+
+    ::pltxt2htm::details::Budget& budget_;
+
 public:
-    ::std::size_t id;
+    using typename base_type::call_stack_type;
+    using typename base_type::children_type;
 
-    constexpr PlSizeTagContext(::fast_io::u8string_view pltext_, ::pltxt2htm::NodeType const nested_tag_type_,
-                               ::std::size_t id_) noexcept
-        : ::pltxt2htm::details::BasicFrameContext{pltext_, nested_tag_type_},
-          id(::std::move(id_)) {
+    explicit LimitedAstBuilder(::pltxt2htm::details::Budget& budget) noexcept
+        : budget_{budget} {
     }
 
-    constexpr ~PlSizeTagContext() noexcept = default;
+    [[nodiscard]]
+    bool exhausted(this LimitedAstBuilder const& self) noexcept {
+        return self.budget_.exhausted();
+    }
+
+    template<typename Node>
+    void push(this LimitedAstBuilder& self, ::pltxt2htm::Ast& children) noexcept {
+        static_cast<base_type&>(self).template push<Node>(children);
+        self.budget_.add_node();
+    }
+
+    void push_text_run(this LimitedAstBuilder& self, ::fast_io::u8string_view const& pltext, ::std::size_t begin,
+                       ::std::size_t length, ::pltxt2htm::Ast& children) noexcept {
+        static_cast<base_type&>(self).push_text_run(pltext, begin, length, children);
+        self.budget_.add_node();
+    }
+
+    void push_note(this LimitedAstBuilder& self, ::pltxt2htm::Ast& children,
+                   ::fast_io::u8string_view comment) noexcept {
+        static_cast<base_type&>(self).push_note(children, comment);
+        self.budget_.add_node();
+    }
+
+    template<typename... Args>
+    void open_frame(this LimitedAstBuilder& self, call_stack_type& call_stack, Args&&... args) noexcept {
+        static_cast<base_type&>(self).open_frame(call_stack, ::std::forward<Args>(args)...);
+        // The node of the tag is counted when it is opened, so that `max_nodes` bounds the depth as well.
+        // The bottom frame is the document itself.
+        self.budget_.add_node();
+        self.budget_.enter(call_stack.size() - 1);
+    }
 };
 
 /**
  * @brief Parse pl-text to nodes.
  * @tparam ndebug: Whether disables all debug checks.
  * @param call_stack: use `call_stack` + `goto restart` to avoid stack overflow.
- * @return Quantum-Physics text's ast.
+ * @param builder: Builder which the parsed nodes are reported to, see `AstBuilder`.
+ * @param utf8_validated: Whether the whole pl-text is valid utf-8, see `is_valid_utf8`.
+ * @return Children of the bottom frame of `call_stack`.
  */
-template<bool ndebug>
+template<bool ndebug, typename Builder>
 [[nodiscard]]
-constexpr auto parse_pltxt(
-    ::fast_io::stack<::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BasicFrameContext>,
-                     ::fast_io::list<::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BasicFrameContext>>>&
-        call_stack)
+constexpr auto parse_pltxt(typename Builder::call_stack_type& call_stack, Builder& builder, bool const utf8_validated)
 #if __cpp_exceptions < 199711L
     noexcept
 #endif
-    -> ::pltxt2htm::Ast {
+    -> typename Builder::children_type {
 restart:
-    auto&& current_index = call_stack.top()->current_index;
-    auto&& pltext = call_stack.top()->pltext;
-    auto&& result = call_stack.top()->subast;
+    auto&& current_index = call_stack.top().current_index;
+    auto&& pltext = call_stack.top().pltext;
+    auto&& result = call_stack.top().subast;
     ::std::size_t const pltext_size{pltext.size()};
 
-    for (; current_index < pltext_size; ++current_index) {
+    // Once the builder is exhausted, the remaining text is skipped and the open tags are closed.
+    for (; current_index < pltext_size && !builder.exhausted(); ++current_index) {
         char8_t const chr{::pltxt2htm::details::u8string_view_index<ndebug>(pltext, current_index)};
 
         if (chr == u8'\n') {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LineBreak>{});
+            builder.template push<::pltxt2htm::LineBreak>(result);
 
 #if __has_cpp_attribute(indeterminate)
             ::std::size_t start_index [[indeterminate]];
@@ -796,16 +1089,13 @@ restart:
                 ::pltxt2htm::details::try_parse_md_atx_heading<ndebug>(
                     ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 1), start_index,
                     sublength, md_atx_heading_type, ending_type)) {
-                ::pltxt2htm::Ast subast{};
                 current_index += start_index + 1;
                 if (current_index < pltext_size) {
                     auto subtext =
                         ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index, sublength);
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::MdAtxHeadingContext>(
-                        subtext, md_atx_heading_type, ending_type));
+                    builder.open_frame(call_stack, subtext, md_atx_heading_type, ending_type);
                 } else {
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::MdAtxHeadingContext>(
-                        ::fast_io::u8string_view{}, md_atx_heading_type, ending_type));
+                    builder.open_frame(call_stack, ::fast_io::u8string_view{}, md_atx_heading_type, ending_type);
                 }
                 goto restart;
             } else if (auto opt_len = ::pltxt2htm::details::try_parse_md_thematic_break<ndebug>(
@@ -813,46 +1103,45 @@ restart:
                        opt_len.has_value()) {
                 auto&& [index, end_type] = opt_len.template value<ndebug>();
                 current_index += index;
-                result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::MdHr>{});
+                builder.template push<::pltxt2htm::MdHr>(result);
                 if (end_type == ::pltxt2htm::details::EndType::br_tag) {
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Br>{});
+                    builder.template push<::pltxt2htm::Br>(result);
                 } else if (end_type == ::pltxt2htm::details::EndType::line_break) {
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LineBreak>{});
+                    builder.template push<::pltxt2htm::LineBreak>(result);
                 }
                 continue;
             }
             continue;
         } else if (chr == u8' ') {
             // TODO should we delete tail space?
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Space>{});
+            builder.template push<::pltxt2htm::Space>(result);
             continue;
         } else if (chr == u8'&') {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Ampersand>{});
+            builder.template push<::pltxt2htm::Ampersand>(result);
             continue;
         } else if (chr == u8'\'') {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::SingleQuotationMark>{});
+            builder.template push<::pltxt2htm::SingleQuotationMark>(result);
             continue;
         } else if (chr == u8'\"') {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::DoubleQuotationMark>{});
+            builder.template push<::pltxt2htm::DoubleQuotationMark>(result);
             continue;
         } else if (chr == u8'>') {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::GreaterThan>{});
+            builder.template push<::pltxt2htm::GreaterThan>(result);
             continue;
         } else if (chr == u8'\t') {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Tab>{});
+            builder.template push<::pltxt2htm::Tab>(result);
             continue;
         } else if (chr == u8'\\') {
             if (current_index + 1 == pltext_size) {
-                result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::U8Char>{u8'\\'});
+                builder.push_text_run(pltext, current_index, 1, result);
                 continue;
             }
-            auto escape_node = ::pltxt2htm::details::switch_escape_char(
-                ::pltxt2htm::details::u8string_view_index<ndebug>(pltext, current_index + 1));
-            if (escape_node.has_value()) {
-                result.push_back(::std::move(escape_node.template value<ndebug>()));
+            if (::pltxt2htm::details::visit_escape_char(
+                    ::pltxt2htm::details::u8string_view_index<ndebug>(pltext, current_index + 1),
+                    [&builder, &result]<typename Node>() { builder.template push<Node>(result); })) {
                 ++current_index;
             } else {
-                result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::U8Char>{u8'\\'});
+                builder.push_text_run(pltext, current_index, 1, result);
             }
             continue;
         } else if (chr == u8'<') {
@@ -860,971 +1149,289 @@ restart:
             pltxt2htm_assert(current_index < pltext_size, u8"Index of parser out of bound");
 
             if (current_index + 1 == pltext_size) {
-                result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
+                builder.template push<::pltxt2htm::LessThan>(result);
                 continue;
             }
 
-            // a trie for tags
             switch (::pltxt2htm::details::u8string_view_index<ndebug>(pltext, current_index + 1)) {
-            case u8'a':
-                [[fallthrough]];
-            case u8'A': {
-                // parsing pl <a>$1</a> tag (not html <a> tag)
-                if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                    opt_tag_len.has_value()) {
-                    current_index += opt_tag_len.template value<ndebug>() + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::pl_a));
-                    goto restart;
-                } else {
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                    continue;
-                }
-            }
-
-            case u8'b':
-                [[fallthrough]];
-            case u8'B': {
-                if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                    opt_tag_len.has_value()) {
-                    // parsing pl&html <b> tag
-                    current_index += opt_tag_len.template value<ndebug>() + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::pl_b));
-                    goto restart;
-                } else if (auto opt_br_tag_len = ::pltxt2htm::details::try_parse_self_closing_tag<ndebug, u8'r'>(
-                               ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                           opt_br_tag_len.has_value()) {
-                    current_index += opt_br_tag_len.template value<ndebug>() + 2;
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Br>(::pltxt2htm::Br()));
-
-#if __has_cpp_attribute(indeterminate)
-                    ::std::size_t start_index [[indeterminate]];
-                    ::std::size_t end_index [[indeterminate]];
-                    ::pltxt2htm::NodeType md_atx_heading_type [[indeterminate]];
-                    ::pltxt2htm::details::MdAtxEndingType ending_type [[indeterminate]];
-#else
-                    ::std::size_t start_index;
-                    ::std::size_t sublength;
-                    ::pltxt2htm::NodeType md_atx_heading_type;
-                    ::pltxt2htm::details::MdAtxEndingType ending_type;
-#endif
-                    // try parsing markdown atx header
-                    if (current_index + 1 < pltext_size &&
-                        ::pltxt2htm::details::try_parse_md_atx_heading<ndebug>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 1), start_index,
-                            sublength, md_atx_heading_type, ending_type)) {
-                        ::pltxt2htm::Ast subast{};
-                        current_index += start_index + 1;
-                        if (current_index < pltext_size) {
-                            auto subtext =
-                                ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index, sublength);
-                            call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::MdAtxHeadingContext>(
-                                subtext, md_atx_heading_type, ending_type));
-                        } else {
-                            call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::MdAtxHeadingContext>(
-                                ::fast_io::u8string_view{}, md_atx_heading_type, ending_type));
-                        }
-                        goto restart;
-                    } else if (auto opt_len = ::pltxt2htm::details::try_parse_md_thematic_break<ndebug>(
-                                   ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 1));
-                               opt_len.has_value()) {
-                        auto&& [index, end_type] = opt_len.template value<ndebug>();
-                        current_index += index;
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::MdHr>{});
-                        if (end_type == ::pltxt2htm::details::EndType::br_tag) {
-                            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Br>{});
-                        } else if (end_type == ::pltxt2htm::details::EndType::line_break) {
-                            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LineBreak>{});
-                        }
-                        continue;
+            case u8'!': {
+                // parsing: <!--$1-->
+                if (::pltxt2htm::details::is_prefix_match<ndebug, u8'-', u8'-'>(
+                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2))) {
+                    // Find the closing -->, without it the rest of the text is the comment, so that the scan
+                    // never runs again for the following `<!--`
+                    ::std::size_t const comment_begin{current_index + 4}; // Position after <!--
+                    ::std::size_t const comment_end{static_cast<::std::size_t>(
+                        ::pltxt2htm::details::find_comment_end(pltext.data() + comment_begin,
+                                                               pltext.data() + pltext_size) -
+                        pltext.data())};
+                    ::fast_io::u8string_view comment{};
+                    if (comment_end > comment_begin) {
+                        comment = ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, comment_begin,
+                                                                                      comment_end - comment_begin);
                     }
-                    continue;
-                } else {
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                    continue;
-                }
-            }
 
-            case u8'c':
-                [[fallthrough]];
-            case u8'C': {
-#if __has_cpp_attribute(indeterminate)
-                ::std::size_t tag_len [[indeterminate]];
-#else
-                ::std::size_t tag_len;
-#endif
-                // parsing: <color=$1>$2</color>
-                ::fast_io::u8string color;
-                if (::pltxt2htm::details::try_parse_equal_sign_tag<ndebug, u8'o', u8'l', u8'o', u8'r'>(
-                        u8string_view_subview<ndebug>(pltext, current_index + 2), tag_len, color,
-                        [](char8_t u8chr) static constexpr noexcept {
-                            return (u8'0' <= u8chr && u8chr <= u8'9') || (u8'a' <= u8chr && u8chr <= u8'z') ||
-                                   (u8'A' <= u8chr && u8chr <= u8'Z') || u8chr == u8'#';
-                        })) {
-                    current_index += tag_len + 3;
-                    // parsing start tag <color> successed
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::EqualSignTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::pl_color, ::std::move(color)));
-                    goto restart;
-                } else if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'o', u8'd', u8'e'>(
-                               ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                           opt_tag_len.has_value()) {
-                    // parsing html <code> tag
-                    current_index += opt_tag_len.template value<ndebug>() + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::html_code));
-                    goto restart;
-                } else {
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
+                    current_index = comment_end + 2; // Point to '>'
+                    builder.push_note(result, comment);
                     continue;
-                }
-            }
-
-            case u8'd':
-                [[fallthrough]];
-            case u8'D': {
-#if __has_cpp_attribute(indeterminate)
-                ::std::size_t tag_len [[indeterminate]];
-#else
-                ::std::size_t tag_len;
-#endif
-                if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'e', u8'l'>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                    opt_tag_len.has_value()) {
-                    // parsing <del>$1</del>
-                    current_index += opt_tag_len.template value<ndebug>() + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::html_del));
-                    goto restart;
-                }
-                // parsing: <discussion=$1>$2</discussion>
-                ::fast_io::u8string id{};
-                if (::pltxt2htm::details::try_parse_equal_sign_tag<ndebug, u8'i', u8's', u8'c', u8'u', u8's', u8's',
-                                                                   u8'i', u8'o', u8'n'>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2), tag_len, id,
-                        [](char8_t u8chr) static constexpr noexcept {
-                            return (u8'a' <= u8chr && u8chr <= u8'z') || (u8'0' <= u8chr && u8chr <= u8'9');
-                        })) {
-                    current_index += tag_len + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::EqualSignTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::pl_discussion, ::std::move(id)));
-                    goto restart;
                 } else {
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
+                    builder.template push<::pltxt2htm::LessThan>(result);
                     continue;
                 }
             }
 
-            case u8'e':
-                [[fallthrough]];
-            case u8'E': {
+            case u8'/': {
+                // parsing closing tags, e.g. </b>, only the tag of the innermost frame can be closed
 #if __has_cpp_attribute(indeterminate)
-                ::std::size_t tag_len [[indeterminate]];
+                ::std::size_t name_size [[indeterminate]];
 #else
-                ::std::size_t tag_len;
+                ::std::size_t name_size;
 #endif
-                // parsing: <experiment=$1>$2</experiment>
-                ::fast_io::u8string id{};
-                if (::pltxt2htm::details::try_parse_equal_sign_tag<ndebug, u8'x', u8'p', u8'e', u8'r', u8'i', u8'm',
-                                                                   u8'e', u8'n', u8't'>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2), tag_len, id,
-                        [](char8_t u8chr) static constexpr noexcept {
-                            return (u8'a' <= u8chr && u8chr <= u8'z') || (u8'0' <= u8chr && u8chr <= u8'9');
-                        })) {
-                    current_index += tag_len + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::EqualSignTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::pl_experiment, ::std::move(id)));
-                    goto restart;
-                } else if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'm'>(
-                               ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                           opt_tag_len.has_value()) {
-                    current_index += opt_tag_len.template value<ndebug>() + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::html_em));
-                    goto restart;
-                } else {
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
+                auto const opt_tag_type = ::pltxt2htm::details::recognize_tag_name<ndebug>(
+                    ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2), name_size);
+                if (!opt_tag_type.has_value() ||
+                    opt_tag_type.template value<ndebug>() != call_stack.top().nested_tag_type) {
+                    builder.template push<::pltxt2htm::LessThan>(result);
                     continue;
                 }
-            }
-
-            case u8'h':
-                [[fallthrough]];
-            case u8'H': {
-                if (auto opt_h1_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'1'>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                    opt_h1_tag_len.has_value()) {
-                    // parsing html <h1> tag
-                    current_index += opt_h1_tag_len.template value<ndebug>() + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::html_h1));
-                    goto restart;
-                } else if (auto opt_h2_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'2'>(
-                               ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                           opt_h2_tag_len.has_value()) {
-                    // parsing html <h2> tag
-                    current_index += opt_h2_tag_len.template value<ndebug>() + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::html_h2));
-                    goto restart;
-                } else if (auto opt_h3_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'3'>(
-                               ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                           opt_h3_tag_len.has_value()) {
-                    // parsing html <h3> tag
-                    current_index += opt_h3_tag_len.template value<ndebug>() + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::html_h3));
-                    goto restart;
-                } else if (auto opt_h4_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'4'>(
-                               ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                           opt_h4_tag_len.has_value()) {
-                    // parsing html <h4> tag
-                    current_index += opt_h4_tag_len.template value<ndebug>() + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::html_h4));
-                    goto restart;
-                } else if (auto opt_h5_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'5'>(
-                               ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                           opt_h5_tag_len.has_value()) {
-                    // parsing html <h5> tag
-                    current_index += opt_h5_tag_len.template value<ndebug>() + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::html_h5));
-                    goto restart;
-                } else if (auto opt_h6_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'6'>(
-                               ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                           opt_h6_tag_len.has_value()) {
-                    // parsing html <h6> tag
-                    current_index += opt_h6_tag_len.template value<ndebug>() + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::html_h6));
-                    goto restart;
-                } else if (auto opt_tag_len = ::pltxt2htm::details::try_parse_self_closing_tag<ndebug, u8'r'>(
-                               ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                           opt_tag_len.has_value()) {
-                    current_index += opt_tag_len.template value<ndebug>() + 2;
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Hr>());
-                    continue;
-                } else {
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                    continue;
-                }
-            }
-
-            case u8'i':
-                [[fallthrough]];
-            case u8'I': {
-                // parsing pl&html <i>$1</i> tag
                 if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                    opt_tag_len.has_value()) {
-                    current_index += opt_tag_len.template value<ndebug>() + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::pl_i));
-                    goto restart;
-                } else {
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                    continue;
-                }
-            }
-
-            case u8'l':
-                [[fallthrough]];
-            case u8'L': {
-                if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'i'>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
+                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2 + name_size));
                     opt_tag_len.has_value()) {
-                    current_index += opt_tag_len.template value<ndebug>() + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::html_li));
+                    // Whether or not the index is out of range, extern for loop will handle it correctly.
+                    ::std::size_t const staged_index{current_index};
+                    builder.template close_frame<true>(call_stack);
+                    call_stack.top().current_index +=
+                        staged_index + name_size + opt_tag_len.template value<ndebug>() + 3;
                     goto restart;
-                } else {
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                    continue;
-                }
-            }
-
-            case u8'p':
-                [[fallthrough]];
-            case u8'P': {
-                // parsing html <p></p> tag
-                if (auto opt_p_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                    opt_p_tag_len.has_value()) {
-                    current_index += opt_p_tag_len.template value<ndebug>() + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::html_p));
-                    goto restart;
-                } else if (auto opt_pre_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'r', u8'e'>(
-                               ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                           opt_pre_tag_len.has_value()) {
-                    current_index += opt_pre_tag_len.template value<ndebug>() + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::html_pre));
-                    goto restart;
-                } else {
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                    continue;
                 }
+                builder.template push<::pltxt2htm::LessThan>(result);
+                continue;
             }
 
-            case u8's':
-                [[fallthrough]];
-            case u8'S': {
-// parsing pl <size=$1>$2</size> tag
+            default: {
+                // parsing opening tags, the name of the tag is recognized at once
 #if __has_cpp_attribute(indeterminate)
+                ::std::size_t name_size [[indeterminate]];
                 ::std::size_t tag_len [[indeterminate]];
 #else
+                ::std::size_t name_size;
                 ::std::size_t tag_len;
 #endif
-                ::fast_io::u8string id_{};
-                if (::pltxt2htm::details::try_parse_equal_sign_tag<ndebug, u8'i', u8'z', u8'e'>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2), tag_len, id_,
-                        [](char8_t u8chr) static constexpr noexcept { return u8'0' <= u8chr && u8chr <= u8'9'; })) {
-                    auto id{::pltxt2htm::details::u8str2size_t(::fast_io::mnp::os_c_str(id_))};
-                    if (!id.has_value()) [[unlikely]] {
-                        ::exception::unreachable<ndebug>();
-                    }
-
-                    current_index += tag_len + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::PlSizeTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::pl_size, id.template value<ndebug>()));
-                    goto restart;
-                } else if (auto opt_tag_len =
-                               ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8't', u8'r', u8'o', u8'n', u8'g'>(
-                                   ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                           opt_tag_len.has_value()) {
-                    // HTML <strong> tag
-                    current_index += opt_tag_len.template value<ndebug>() + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::html_strong));
-                    goto restart;
-                } else {
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
+                auto const opt_tag_type = ::pltxt2htm::details::recognize_tag_name<ndebug>(
+                    ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 1), name_size);
+                if (!opt_tag_type.has_value()) {
+                    builder.template push<::pltxt2htm::LessThan>(result);
                     continue;
                 }
-            }
+                auto const tag_type = opt_tag_type.template value<ndebug>();
+                // text after the name of the tag
+                auto const tag_rest =
+                    ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 1 + name_size);
+
+                switch (tag_type) {
+                case ::pltxt2htm::NodeType::pl_a:
+                    [[fallthrough]];
+                case ::pltxt2htm::NodeType::pl_b:
+                    [[fallthrough]];
+                case ::pltxt2htm::NodeType::pl_i:
+                    [[fallthrough]];
+                case ::pltxt2htm::NodeType::html_p:
+                    [[fallthrough]];
+                case ::pltxt2htm::NodeType::html_em:
+                    [[fallthrough]];
+                case ::pltxt2htm::NodeType::html_h1:
+                    [[fallthrough]];
+                case ::pltxt2htm::NodeType::html_h2:
+                    [[fallthrough]];
+                case ::pltxt2htm::NodeType::html_h3:
+                    [[fallthrough]];
+                case ::pltxt2htm::NodeType::html_h4:
+                    [[fallthrough]];
+                case ::pltxt2htm::NodeType::html_h5:
+                    [[fallthrough]];
+                case ::pltxt2htm::NodeType::html_h6:
+                    [[fallthrough]];
+                case ::pltxt2htm::NodeType::html_li:
+                    [[fallthrough]];
+                case ::pltxt2htm::NodeType::html_ul:
+                    [[fallthrough]];
+                case ::pltxt2htm::NodeType::html_del:
+                    [[fallthrough]];
+                case ::pltxt2htm::NodeType::html_pre:
+                    [[fallthrough]];
+                case ::pltxt2htm::NodeType::html_code:
+                    [[fallthrough]];
+                case ::pltxt2htm::NodeType::html_strong: {
+                    // parsing pl&html bare tags, e.g. <b>$1</b>
+                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug>(tag_rest);
+                        opt_tag_len.has_value()) {
+                        current_index += name_size + opt_tag_len.template value<ndebug>() + 2;
+                        builder.open_frame(
+                            call_stack, ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
+                            tag_type);
+                        goto restart;
+                    }
+                    break;
+                }
+                case ::pltxt2htm::NodeType::html_br: {
+                    if (auto opt_br_tag_len = ::pltxt2htm::details::try_parse_self_closing_tag<ndebug>(tag_rest);
+                        opt_br_tag_len.has_value()) {
+                        current_index += name_size + opt_br_tag_len.template value<ndebug>() + 1;
+                        builder.template push<::pltxt2htm::Br>(result);
 
-            case u8'u':
-                [[fallthrough]];
-            case u8'U': {
-// parsing pl <user=$1>$2</user> tag
 #if __has_cpp_attribute(indeterminate)
-                ::std::size_t tag_len [[indeterminate]];
+                        ::std::size_t start_index [[indeterminate]];
+                        ::std::size_t end_index [[indeterminate]];
+                        ::pltxt2htm::NodeType md_atx_heading_type [[indeterminate]];
+                        ::pltxt2htm::details::MdAtxEndingType ending_type [[indeterminate]];
 #else
-                ::std::size_t tag_len;
+                        ::std::size_t start_index;
+                        ::std::size_t sublength;
+                        ::pltxt2htm::NodeType md_atx_heading_type;
+                        ::pltxt2htm::details::MdAtxEndingType ending_type;
 #endif
-                ::fast_io::u8string id{};
-                if (::pltxt2htm::details::try_parse_equal_sign_tag<ndebug, u8's', u8'e', u8'r'>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2), tag_len, id,
-                        [](char8_t u8chr) static constexpr noexcept {
-                            return (u8'a' <= u8chr && u8chr <= u8'z') || (u8'0' <= u8chr && u8chr <= u8'9');
-                        })) {
-                    current_index += tag_len + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::EqualSignTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::pl_user, ::std::move(id)));
-                    goto restart;
-                } else if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'l'>(
-                               ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                           opt_tag_len.has_value()) {
-                    current_index += opt_tag_len.template value<ndebug>() + 3;
-                    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
-                        ::pltxt2htm::NodeType::html_ul));
-                    goto restart;
-                } else {
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                    continue;
-                }
-            }
-
-            case u8'!': {
-                // parsing: <!--$1-->
-                if (::pltxt2htm::details::is_prefix_match<ndebug, u8'-', u8'-'>(
-                        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2))) {
-                    // Find the closing -->
-                    ::std::size_t comment_end{current_index + 4}; // Position after <!--
-                    ::pltxt2htm::Ast subast{};
-
-                    for (; comment_end < pltext_size; ++comment_end) {
-                        if (::pltxt2htm::details::is_prefix_match<ndebug, u8'-', u8'-', u8'>'>(
-                                ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, comment_end))) {
-                            break;
+                        // try parsing markdown atx header
+                        if (current_index + 1 < pltext_size &&
+                            ::pltxt2htm::details::try_parse_md_atx_heading<ndebug>(
+                                ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 1),
+                                start_index, sublength, md_atx_heading_type, ending_type)) {
+                            current_index += start_index + 1;
+                            if (current_index < pltext_size) {
+                                auto subtext = ::pltxt2htm::details::u8string_view_subview<ndebug>(
+                                    pltext, current_index, sublength);
+                                builder.open_frame(call_stack, subtext, md_atx_heading_type, ending_type);
+                            } else {
+                                builder.open_frame(call_stack, ::fast_io::u8string_view{}, md_atx_heading_type,
+                                                   ending_type);
+                            }
+                            goto restart;
+                        } else if (auto opt_len = ::pltxt2htm::details::try_parse_md_thematic_break<ndebug>(
+                                       ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 1));
+                                   opt_len.has_value()) {
+                            auto&& [index, end_type] = opt_len.template value<ndebug>();
+                            current_index += index;
+                            builder.template push<::pltxt2htm::MdHr>(result);
+                            if (end_type == ::pltxt2htm::details::EndType::br_tag) {
+                                builder.template push<::pltxt2htm::Br>(result);
+                            } else if (end_type == ::pltxt2htm::details::EndType::line_break) {
+                                builder.template push<::pltxt2htm::LineBreak>(result);
+                            }
+                            continue;
                         }
-                        subast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::U8Char>(
-                            ::pltxt2htm::details::u8string_view_index<ndebug>(pltext, comment_end)));
-                    }
-
-                    current_index = comment_end + 2; // Point to '>'
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Note>(::std::move(subast)));
-                    continue;
-                } else {
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                    continue;
-                }
-            }
-
-            case u8'/': {
-                switch (call_stack.top()->nested_tag_type) {
-                case ::pltxt2htm::NodeType::pl_color: {
-                    if (auto opt_tag_len =
-                            ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'c', u8'o', u8'l', u8'o', u8'r'>(
-                                ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // parsing end tag </color> successed
-                        auto frame =
-                            reinterpret_cast<::pltxt2htm::details::EqualSignTagContext*>(call_stack.top().get_unsafe());
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::Color staged_node(::std::move(result), ::std::move(frame->id));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::Color>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
                         continue;
                     }
+                    break;
                 }
-                case ::pltxt2htm::NodeType::pl_a: {
-                    // parsing </a>
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'a'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
+                case ::pltxt2htm::NodeType::html_hr: {
+                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_self_closing_tag<ndebug>(tag_rest);
                         opt_tag_len.has_value()) {
-                        // parsing end tag </a> successed
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::A staged_node(::std::move(result));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::A>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
-                    }
-                }
-                case ::pltxt2htm::NodeType::pl_experiment: {
-                    // parsing </experiment>
-                    if (auto opt_tag_len =
-                            ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'e', u8'x', u8'p', u8'e', u8'r', u8'i',
-                                                                     u8'm', u8'e', u8'n', u8't'>(
-                                ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // Whether or not extern_index is out of range, extern for loop will handle it correctly.
-                        auto frame =
-                            reinterpret_cast<::pltxt2htm::details::EqualSignTagContext*>(call_stack.top().get_unsafe());
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::Experiment staged_node(::std::move(result), ::std::move(frame->id));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::Experiment>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
+                        current_index += name_size + opt_tag_len.template value<ndebug>() + 1;
+                        builder.template push<::pltxt2htm::Hr>(result);
                         continue;
                     }
+                    break;
                 }
-                case ::pltxt2htm::NodeType::pl_discussion: {
-                    // parsing </discussion>
-                    if (auto opt_tag_len =
-                            ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'd', u8'i', u8's', u8'c', u8'u', u8's',
-                                                                     u8's', u8'i', u8'o', u8'n'>(
-                                ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // Whether or not extern_index is out of range, extern for loop will handle it correctly.
-                        auto frame =
-                            reinterpret_cast<::pltxt2htm::details::EqualSignTagContext*>(call_stack.top().get_unsafe());
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::Discussion staged_node(::std::move(result), ::std::move(frame->id));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::Discussion>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
+                case ::pltxt2htm::NodeType::pl_color: {
+                    // parsing: <color=$1>$2</color>
+                    ::fast_io::u8string_view color;
+                    if (::pltxt2htm::details::try_parse_equal_sign_tag<ndebug>(
+                            tag_rest, tag_len, color, [](char8_t u8chr) static constexpr noexcept {
+                                return (u8'0' <= u8chr && u8chr <= u8'9') || (u8'a' <= u8chr && u8chr <= u8'z') ||
+                                       (u8'A' <= u8chr && u8chr <= u8'Z') || u8chr == u8'#';
+                            })) {
+                        current_index += name_size + tag_len + 2;
+                        builder.open_frame(
+                            call_stack, ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
+                            ::pltxt2htm::NodeType::pl_color, color);
                         goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
                     }
+                    break;
                 }
+                case ::pltxt2htm::NodeType::pl_experiment:
+                    [[fallthrough]];
+                case ::pltxt2htm::NodeType::pl_discussion:
+                    [[fallthrough]];
                 case ::pltxt2htm::NodeType::pl_user: {
-                    // parsing </user>
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'u', u8's', u8'e', u8'r'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        auto frame =
-                            reinterpret_cast<::pltxt2htm::details::EqualSignTagContext*>(call_stack.top().get_unsafe());
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::User staged_node(::std::move(result), ::std::move(frame->id));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::User>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
+                    // parsing: <experiment=$1>$2</experiment>, <discussion=$1>$2</discussion>, <user=$1>$2</user>
+                    ::fast_io::u8string_view id{};
+                    if (::pltxt2htm::details::try_parse_equal_sign_tag<ndebug>(
+                            tag_rest, tag_len, id, [](char8_t u8chr) static constexpr noexcept {
+                                return (u8'a' <= u8chr && u8chr <= u8'z') || (u8'0' <= u8chr && u8chr <= u8'9');
+                            })) {
+                        current_index += name_size + tag_len + 2;
+                        builder.open_frame(
+                            call_stack, ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
+                            tag_type, id);
                         goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
                     }
+                    break;
                 }
                 case ::pltxt2htm::NodeType::pl_size: {
-                    // parsing </size>
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8's', u8'i', u8'z', u8'e'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        auto frame = reinterpret_cast<::pltxt2htm::details::PlSizeTagContext const*>(
-                            call_stack.top().release_imul());
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::Size staged_node(::std::move(result), frame->id);
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::Size>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
-                    }
-                }
-                case ::pltxt2htm::NodeType::pl_b: {
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'b'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // parsing end tag </b> successed
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::B staged_node(::std::move(result));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::B>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
-                    }
-                }
-                case ::pltxt2htm::NodeType::pl_i: {
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'i'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // parsing end tag </a> successed
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::I staged_node(::std::move(result));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::I>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
-                    }
-                }
-                case ::pltxt2htm::NodeType::html_p: {
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'p'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // parsing end tag </p> successed
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::P staged_node(::std::move(result));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::P>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
-                    }
-                }
-                case ::pltxt2htm::NodeType::html_h1: {
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'h', u8'1'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // parsing end tag </h1> successed
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::H1 staged_node(::std::move(result));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::H1>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
-                    }
-                }
-                case ::pltxt2htm::NodeType::html_h2: {
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'h', u8'2'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // parsing end tag </h2> successed
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::H2 staged_node(::std::move(result));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::H2>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
-                    }
-                }
-                case ::pltxt2htm::NodeType::html_h3: {
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'h', u8'3'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // parsing end tag </h3> successed
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::H3 staged_node(::std::move(result));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::H3>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
-                    }
-                }
-                case ::pltxt2htm::NodeType::html_h4: {
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'h', u8'4'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // parsing end tag </h4> successed
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::H4 staged_node(::std::move(result));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::H4>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
-                    }
-                }
-                case ::pltxt2htm::NodeType::html_h5: {
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'h', u8'5'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // parsing end tag </h5> successed
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::H5 staged_node(::std::move(result));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::H5>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
-                    }
-                }
-                case ::pltxt2htm::NodeType::html_h6: {
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'h', u8'6'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // parsing end tag </h6> successed
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::H6 staged_node(::std::move(result));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::H6>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
-                    }
-                }
-                case ::pltxt2htm::NodeType::html_del: {
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'd', u8'e', u8'l'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // parsing end tag </del> successed
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::Del staged_node(::std::move(result));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::Del>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
-                    }
-                }
-                case ::pltxt2htm::NodeType::html_note: {
-                    ::exception::unreachable<ndebug>();
-                }
-                case ::pltxt2htm::NodeType::html_em: {
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'e', u8'm'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // parsing end tag </em> successed
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::Em staged_node(::std::move(result));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::Em>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
-                    }
-                }
-                case ::pltxt2htm::NodeType::html_strong: {
-                    if (auto opt_tag_len =
-                            ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8's', u8't', u8'r', u8'o', u8'n', u8'g'>(
-                                ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // parsing end tag </strong> successed
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::Strong staged_node(::std::move(result));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::Strong>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
-                    }
-                }
-                case ::pltxt2htm::NodeType::html_ul: {
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'u', u8'l'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // parsing end tag </ul> successed
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::Ul staged_node(::std::move(result));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::Ul>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
-                    }
-                }
-                case ::pltxt2htm::NodeType::html_li: {
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'l', u8'i'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // parsing end tag </li> successed
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::Li staged_node(::std::move(result));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::Li>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
-                    }
-                }
-                case ::pltxt2htm::NodeType::html_code: {
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'c', u8'o', u8'd', u8'e'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // parsing end tag </code> successed
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::Code staged_node(::std::move(result));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::Code>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
-                        goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
-                    }
-                }
-                case ::pltxt2htm::NodeType::html_pre: {
-                    if (auto opt_tag_len = ::pltxt2htm::details::try_parse_bare_tag<ndebug, u8'p', u8'r', u8'e'>(
-                            ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index + 2));
-                        opt_tag_len.has_value()) {
-                        // parsing end tag </pre> successed
-                        ::std::size_t const staged_index{current_index};
-                        ::pltxt2htm::Pre staged_node(::std::move(result));
-                        call_stack.pop();
-                        call_stack.top()->subast.push_back(
-                            ::pltxt2htm::details::HeapGuard<::pltxt2htm::Pre>(::std::move(staged_node)));
-                        call_stack.top()->current_index += staged_index + opt_tag_len.template value<ndebug>() + 3;
+                    // parsing pl <size=$1>$2</size> tag
+                    ::fast_io::u8string_view id_{};
+                    if (::pltxt2htm::details::try_parse_equal_sign_tag<ndebug>(
+                            tag_rest, tag_len, id_,
+                            [](char8_t u8chr) static constexpr noexcept { return u8'0' <= u8chr && u8chr <= u8'9'; })) {
+                        auto id{::pltxt2htm::details::u8str2size_t(id_)};
+                        if (!id.has_value()) [[unlikely]] {
+                            ::exception::unreachable<ndebug>();
+                        }
+
+                        current_index += name_size + tag_len + 2;
+                        builder.open_frame(
+                            call_stack, ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, current_index),
+                            ::pltxt2htm::NodeType::pl_size, id.template value<ndebug>());
                         goto restart;
-                    } else {
-                        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                        continue;
                     }
+                    break;
                 }
                 default:
-                    result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
-                    continue;
+                    [[unlikely]] {
+                        ::exception::unreachable<ndebug>();
+                    }
                 }
-                ::exception::unreachable<ndebug>();
-            }
-
-            default: {
-                result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LessThan>{});
+                builder.template push<::pltxt2htm::LessThan>(result);
                 continue;
             }
             }
 
             ::exception::unreachable<ndebug>();
+        } else if (::pltxt2htm::details::is_plain_char<false>(chr) ||
+                   (utf8_validated && ::pltxt2htm::details::is_plain_char<true>(chr))) {
+            // consume the whole run of plain text at once
+            auto const run_first = pltext.data() + current_index + 1;
+            auto const run_last = pltext.data() + pltext_size;
+            auto const run_end = utf8_validated
+                                     ? ::pltxt2htm::details::find_plain_text_end<true>(run_first, run_last)
+                                     : ::pltxt2htm::details::find_plain_text_end<false>(run_first, run_last);
+            auto const run_length = static_cast<::std::size_t>(run_end - pltext.data()) - current_index;
+            builder.push_text_run(pltext, current_index, run_length, result);
+            current_index += run_length - 1;
+            continue;
         } else {
-            ::pltxt2htm::details::parse_utf8_code_point<ndebug>(pltext, current_index, result);
+            ::pltxt2htm::details::parse_utf8_code_point<ndebug>(pltext, current_index, builder, result);
             continue;
         }
     }
 
     {
-        ::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BasicFrameContext> frame(::std::move(call_stack.top()));
         ::std::size_t const staged_index = pltext_size;
-        call_stack.pop();
-        if (call_stack.empty()) {
+        if (call_stack.size() == 1) {
             // Considering the following markdown:
             // ```md
             // <b>e</b>xample
             // ```
             // Text without any tag in the end will hit this branch.
-            return ::std::move(frame->subast);
+            auto subast{::std::move(call_stack.top().subast)};
+            call_stack.pop();
+            return subast;
         } else {
             // Considering the following markdown:
             // ```md
             // <b>example
             // ```
             // Any tag without a closing tag will hit this branch.
-            auto&& subast = frame->subast;
-            auto&& superast = call_stack.top()->subast;
-            auto&& super_index = call_stack.top()->current_index;
-            switch (frame->nested_tag_type) {
-            case ::pltxt2htm::NodeType::pl_color: {
-                auto&& id = reinterpret_cast<::pltxt2htm::details::EqualSignTagContext*>(frame.get_unsafe())->id;
-                superast.push_back(
-                    ::pltxt2htm::details::HeapGuard<::pltxt2htm::Color>(::std::move(subast), ::std::move(id)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::pl_a: {
-                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::A>(::std::move(subast)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::pl_experiment: {
-                auto&& id = reinterpret_cast<::pltxt2htm::details::EqualSignTagContext*>(frame.get_unsafe())->id;
-                superast.push_back(
-                    ::pltxt2htm::details::HeapGuard<::pltxt2htm::Experiment>(::std::move(subast), ::std::move(id)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::pl_discussion: {
-                auto&& id = reinterpret_cast<::pltxt2htm::details::EqualSignTagContext*>(frame.get_unsafe())->id;
-                superast.push_back(
-                    ::pltxt2htm::details::HeapGuard<::pltxt2htm::Discussion>(::std::move(subast), ::std::move(id)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::pl_user: {
-                auto&& id = reinterpret_cast<::pltxt2htm::details::EqualSignTagContext*>(frame.get_unsafe())->id;
-                superast.push_back(
-                    ::pltxt2htm::details::HeapGuard<::pltxt2htm::User>(::std::move(subast), ::std::move(id)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::pl_size: {
-                auto&& id = reinterpret_cast<::pltxt2htm::details::PlSizeTagContext const*>(frame.release_imul())->id;
-                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Size>(::std::move(subast), id));
-                break;
-            }
-            case ::pltxt2htm::NodeType::html_strong:
-                [[fallthrough]];
-            case ::pltxt2htm::NodeType::pl_b: {
-                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::B>(::std::move(subast)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::pl_i: {
-                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::I>(::std::move(subast)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::html_p: {
-                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::P>(::std::move(subast)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::html_h1: {
-                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::H1>(::std::move(subast)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::html_note: {
-                ::exception::unreachable<ndebug>();
-            }
-            case ::pltxt2htm::NodeType::html_h2: {
-                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::H2>(::std::move(subast)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::html_h3: {
-                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::H3>(::std::move(subast)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::html_h4: {
-                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::H4>(::std::move(subast)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::html_h5: {
-                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::H5>(::std::move(subast)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::html_h6: {
-                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::H6>(::std::move(subast)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::html_del: {
-                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Del>(::std::move(subast)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::html_em: {
-                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Em>(::std::move(subast)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::html_ul: {
-                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Ul>(::std::move(subast)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::html_li: {
-                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Li>(::std::move(subast)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::html_code: {
-                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Code>(::std::move(subast)));
-                break;
-            }
-            case ::pltxt2htm::NodeType::html_pre: {
-                superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Pre>(::std::move(subast)));
-                break;
-            }
+            switch (call_stack.top().nested_tag_type) {
             case ::pltxt2htm::NodeType::md_atx_h1:
                 [[fallthrough]];
             case ::pltxt2htm::NodeType::md_atx_h2:
@@ -1836,73 +1443,46 @@ restart:
             case ::pltxt2htm::NodeType::md_atx_h5:
                 [[fallthrough]];
             case ::pltxt2htm::NodeType::md_atx_h6: {
-                switch (frame->nested_tag_type) {
-                case ::pltxt2htm::NodeType::md_atx_h1:
-                    superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::AtxH1>(::std::move(subast)));
-                    break;
-                case ::pltxt2htm::NodeType::md_atx_h2:
-                    superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::AtxH2>(::std::move(subast)));
-                    break;
-                case ::pltxt2htm::NodeType::md_atx_h3:
-                    superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::AtxH3>(::std::move(subast)));
-                    break;
-                case ::pltxt2htm::NodeType::md_atx_h4:
-                    superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::AtxH4>(::std::move(subast)));
-                    break;
-                case ::pltxt2htm::NodeType::md_atx_h5:
-                    superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::AtxH5>(::std::move(subast)));
-                    break;
-                case ::pltxt2htm::NodeType::md_atx_h6:
-                    superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::AtxH6>(::std::move(subast)));
-                    break;
-                default:
-                    [[unlikely]] {
-                        ::exception::unreachable<ndebug>();
-                    }
-                }
-                super_index += frame->subast.size();
+                auto const ending_type = call_stack.top().ending_type;
+                builder.template close_frame<false>(call_stack);
                 // Handle the ending type
-                auto&& ending_type =
-                    reinterpret_cast<::pltxt2htm::details::MdAtxHeadingContext*>(frame.get_unsafe())->ending_type;
+                auto&& super_index = call_stack.top().current_index;
                 if (ending_type.ending_type == ::pltxt2htm::details::MdAtxHeadingEndingType::newline) {
-                    superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LineBreak>{});
+                    builder.template push<::pltxt2htm::LineBreak>(call_stack.top().subast);
                     super_index += 1;
                 } else if (ending_type.ending_type == ::pltxt2htm::details::MdAtxHeadingEndingType::br_tag) {
-                    superast.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Br>{});
+                    builder.template push<::pltxt2htm::Br>(call_stack.top().subast);
                     super_index += ending_type.br_len + 1;
                 }
                 break;
             }
-            default:
-                [[unlikely]] {
-                    ::exception::unreachable<ndebug>();
-                }
+            default: {
+                builder.template close_frame<false>(call_stack);
+                break;
+            }
             }
-            super_index += staged_index;
+            call_stack.top().current_index += staged_index;
             goto restart;
         }
     }
 }
 
-} // namespace details
-
 /**
- * @brief Impl of parse pl-text to nodes.
- * @tparam ndebug: Whether or not to disable debugging checks (like NDEBUG macro).
- * @param pltext: The text readed from Quantum-Physics.
+ * @brief Parse the whole pl-text and report the nodes to `builder`.
+ * @param builder: Builder which the parsed nodes are reported to, see `AstBuilder`.
+ * @return Children of the root.
  */
-template<bool ndebug>
+template<bool ndebug, typename Builder>
 [[nodiscard]]
-constexpr auto parse_pltxt(::fast_io::u8string_view pltext)
+constexpr auto parse_pltxt(::fast_io::u8string_view pltext, Builder& builder)
 #if __cpp_exceptions < 199711L
     noexcept
 #endif
-    -> ::pltxt2htm::Ast {
-    // fast_io::deque contains bug about RAII, use fast_io::list instead
-    ::fast_io::stack<::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BasicFrameContext>,
-                     ::fast_io::list<::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BasicFrameContext>>>
-        call_stack{};
-    ::pltxt2htm::Ast result{};
+    -> typename Builder::children_type {
+    // Valid utf-8 is the common case, validating it once lets the parser skip per code point checks.
+    bool const utf8_validated{::pltxt2htm::details::is_valid_utf8(pltext)};
+    typename Builder::call_stack_type call_stack{};
+    typename Builder::children_type result{};
 
     // Consider the following markdown
     // ```md
@@ -1922,41 +1502,89 @@ constexpr auto parse_pltxt(::fast_io::u8string_view pltext)
     // try parsing markdown atx header
     if (::pltxt2htm::details::try_parse_md_atx_heading<ndebug>(pltext, start_index, sublength, md_atx_heading_type,
                                                                ending_type)) {
-        ::pltxt2htm::Ast subast{};
         if (start_index < pltext.size()) {
             auto subtext = ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, start_index, sublength);
-            call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::MdAtxHeadingContext>(
-                subtext, md_atx_heading_type, ending_type));
-            subast = ::pltxt2htm::details::parse_pltxt<ndebug>(call_stack);
+            builder.open_frame(call_stack, subtext, md_atx_heading_type, ending_type);
+        } else {
+            builder.open_frame(call_stack, ::fast_io::u8string_view{}, md_atx_heading_type, ending_type);
         }
-        result.push_back(::pltxt2htm::details::switch_md_atx_header<ndebug>(md_atx_heading_type, ::std::move(subast)));
+        auto subast = ::pltxt2htm::details::parse_pltxt<ndebug>(call_stack, builder, utf8_validated);
+        builder.push_md_atx_heading(result, md_atx_heading_type, ::std::move(subast));
         // rectify the start index to the start of next text (aka. below common cases)
         start_index += sublength;
     }
 
     // other common cases
-    call_stack.push(::pltxt2htm::details::HeapGuard<::pltxt2htm::details::BareTagContext>(
-        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, start_index), ::pltxt2htm::NodeType::base));
+    call_stack.emplace(
+        ::pltxt2htm::details::u8string_view_subview<ndebug>(pltext, start_index), ::pltxt2htm::NodeType::base);
     if (auto opt_len = ::pltxt2htm::details::try_parse_md_thematic_break<ndebug>(pltext); opt_len.has_value()) {
         auto&& [index, end_type] = opt_len.template value<ndebug>();
-        call_stack.top()->current_index += index;
-        result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::MdHr>{});
+        call_stack.top().current_index += index;
+        builder.template push<::pltxt2htm::MdHr>(result);
         if (end_type == ::pltxt2htm::details::EndType::br_tag) {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::Br>{});
+            builder.template push<::pltxt2htm::Br>(result);
         } else if (end_type == ::pltxt2htm::details::EndType::line_break) {
-            result.push_back(::pltxt2htm::details::HeapGuard<::pltxt2htm::LineBreak>{});
+            builder.template push<::pltxt2htm::LineBreak>(result);
         }
     }
-    auto subast = ::pltxt2htm::details::parse_pltxt<ndebug>(call_stack);
-    for (auto&& node : subast) {
-        result.push_back(::std::move(node));
-    }
+    auto subast = ::pltxt2htm::details::parse_pltxt<ndebug>(call_stack, builder, utf8_validated);
+    builder.append(result, ::std::move(subast));
 
     pltxt2htm_assert(call_stack.empty(), u8"call_stack is not empty");
 
     return result;
 }
 
+} // namespace details
+
+/**
+ * @brief Impl of parse pl-text to nodes.
+ * @tparam ndebug: Whether or not to disable debugging checks (like NDEBUG macro).
+ * @tparam keep_comments: Whether the body of `<!--$comment-->` is kept in the ast, the backends never render it.
+ * @param pltext: The text readed from Quantum-Physics.
+ * @note Text and tag attributes of the result borrow `pltext`, therefore `pltext` must outlive the result.
+ * @note Nodes of the result share arena chunks whose reference count is not atomic. The ast may be moved to
+ *       another thread, but its nodes must never be destroyed by two threads concurrently.
+ */
+template<bool ndebug, bool keep_comments = false>
+[[nodiscard]]
+constexpr auto parse_pltxt(::fast_io::u8string_view pltext)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+    -> ::pltxt2htm::Ast {
+    // Nodes of the document are bump allocated from one arena instead of one malloc per node.
+    // The chunks of the arena are kept alive by the nodes, so returning the ast is safe.
+    ::pltxt2htm::details::NodeArena arena{};
+    ::pltxt2htm::details::NodeArenaScope const arena_scope{arena};
+    ::pltxt2htm::details::AstBuilder<ndebug, keep_comments> builder{};
+    return ::pltxt2htm::details::parse_pltxt<ndebug>(pltext, builder);
+}
+
+/**
+ * @brief Like `parse_pltxt`, but gives up once a budget of `limits` runs out.
+ * @param limits: `max_nodes`, `max_depth`, `deadline` and `cancelled` are obeyed, see pltxt2htm/limits.hh.
+ * @return nullopt if a budget runs out, the half built ast is released in O(n).
+ * @note The same thread rule of the ast as `parse_pltxt` without limits.
+ */
+template<bool ndebug>
+[[nodiscard]]
+inline auto parse_pltxt(::fast_io::u8string_view pltext, ::pltxt2htm::Limits const& limits)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+    -> ::exception::optional<::pltxt2htm::Ast> {
+    ::pltxt2htm::details::Budget budget{limits};
+    ::pltxt2htm::details::NodeArena arena{};
+    ::pltxt2htm::details::NodeArenaScope const arena_scope{arena};
+    ::pltxt2htm::details::LimitedAstBuilder<ndebug> builder{budget};
+    auto ast = ::pltxt2htm::details::parse_pltxt<ndebug>(pltext, builder);
+    if (budget.exhausted()) {
+        return ::exception::nullopt_t{};
+    }
+    return ast;
+}
+
 } // namespace pltxt2htm
 
 #include "pop_macro.hh"
@@ -5,10 +5,11 @@
  * @brief This file provides c pointer style interface wrapped ::pltxt2htm::pltxt2html
  */
 
+#include <cstddef>
 #include <cstdlib>
-#include <cstring>
 #include <utility>
 #include <concepts>
+#include <fast_io/fast_io_dsal/vector.h>
 #include <exception/exception.hh>
 #include "pltxt2htm.hh"
 
@@ -16,26 +17,138 @@ namespace pltxt2htm {
 
 namespace details {
 
-template<auto Func, typename... Args>
+/**
+ * @brief Parse and optimize `pltext` once, the returned callable renders it to an `html_sink`.
+ * @note The callable is invoked twice by `malloc_html` and `write_html`, to measure and to write the html. The
+ *       nodes of the ast borrow `pltext`, which must outlive the callable.
+ */
+template<bool ndebug, bool escape_less_than = true>
+[[nodiscard]]
+constexpr auto advanced_html_render(::fast_io::u8string_view pltext, ::fast_io::u8string_view host)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    auto ast = ::pltxt2htm::parse_pltxt<ndebug>(pltext);
+    ::pltxt2htm::optimize_ast<ndebug>(ast);
+    return [ast = ::std::move(ast), host](::pltxt2htm::html_sink auto& sink) {
+        ::pltxt2htm::details::ast2advanced_html<ndebug, escape_less_than>(ast, host, sink);
+    };
+}
+
+/**
+ * @brief Same as `advanced_html_render`, but renders common html.
+ */
+template<bool ndebug>
+[[nodiscard]]
+constexpr auto common_html_render(::fast_io::u8string_view pltext)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    return [ast = ::pltxt2htm::parse_pltxt<ndebug>(pltext)](::pltxt2htm::html_sink auto& sink) {
+        ::pltxt2htm::details::ast2common_html<ndebug>(ast, sink);
+    };
+}
+
+/**
+ * @brief Render the html into a null-terminated buffer allocated by `::std::malloc`.
+ * @note The html is measured first, so that it is written to the buffer directly, without a copy.
+ * @param [out] html_size: Length of the html excluding the null terminator, ignored if it is nullptr
+ */
+template<typename Render>
 [[nodiscard]]
-constexpr char8_t const* c_ptr_style_wrapper(Args&&... args) noexcept(
-    noexcept((Func(::std::forward<Args&&>(args)...)))) {
-    auto html = Func(::std::forward<Args&&>(args)...);
-    char8_t* result = reinterpret_cast<char8_t*>(::std::malloc(html.size() + 1));
+constexpr char8_t const* malloc_html(Render const& render, ::std::size_t* const html_size)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    ::pltxt2htm::details::MeasureSink measure_sink{};
+    render(measure_sink);
+    auto const size = measure_sink.size();
+    char8_t* result = reinterpret_cast<char8_t*>(::std::malloc(size + 1));
     if (result == nullptr) [[unlikely]] {
         // bad alloc error should never be an exception or err-code
         ::exception::terminate();
     }
-    ::std::memcpy(result, html.data(), html.size());
-    result[html.size()] = u8'\0';
+    ::pltxt2htm::details::UncheckedSink unchecked_sink{result};
+    render(unchecked_sink);
+    result[size] = u8'\0';
+    if (html_size != nullptr) {
+        *html_size = size;
+    }
     return result;
 }
 
+/**
+ * @brief Render the html into a buffer supplied by the caller.
+ * @return Length of the html excluding the null terminator.
+ * @note The html and a null terminator are written only if the returned length is less than `buffer_size`,
+ *       otherwise `buffer` is untouched, retry with a buffer of the returned length + 1.
+ */
+template<typename Render>
+[[nodiscard]]
+constexpr ::std::size_t write_html(Render const& render, char8_t* const buffer, ::std::size_t const buffer_size)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    ::pltxt2htm::details::MeasureSink measure_sink{};
+    render(measure_sink);
+    auto const size = measure_sink.size();
+    if (size < buffer_size) {
+        ::pltxt2htm::details::UncheckedSink unchecked_sink{buffer};
+        render(unchecked_sink);
+        buffer[size] = u8'\0';
+    }
+    return size;
+}
+
+/**
+ * @brief Convert `count` texts by `run_batch`, each html is allocated by `::std::malloc` and null-terminated.
+ */
+template<bool ndebug>
+void malloc_html_batch(char8_t const* const* const texts, ::std::size_t const* const text_sizes,
+                       ::std::size_t const count, ::fast_io::u8string_view host,
+                       ::pltxt2htm::BatchOptions const& options, char8_t const** const htmls,
+                       ::std::size_t* const html_sizes)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    ::fast_io::vector<::fast_io::u8string_view> pltexts{};
+    pltexts.reserve(count);
+    for (::std::size_t i{}; i < count; ++i) {
+        pltexts.emplace_back(texts[i], text_sizes[i]);
+    }
+    ::pltxt2htm::details::run_batch<ndebug>(
+        ::std::span<::fast_io::u8string_view const>{pltexts.data(), pltexts.size()}, host, options,
+        [htmls, html_sizes](::std::size_t index, ::fast_io::u8string_view html) {
+            char8_t* result = reinterpret_cast<char8_t*>(::std::malloc(html.size() + 1));
+            if (result == nullptr) [[unlikely]] {
+                ::exception::terminate();
+            }
+            ::std::copy_n(html.data(), html.size(), result);
+            result[html.size()] = u8'\0';
+            htmls[index] = result;
+            if (html_sizes != nullptr) {
+                html_sizes[index] = html.size();
+            }
+        });
+}
+
 } // namespace details
 
+/**
+ * @brief Free the html returned by the C-Pointer-Style interfaces.
+ */
+inline void free_html(char8_t const* const html) noexcept {
+    ::std::free(const_cast<char8_t*>(html));
+}
+
 /**
  * @brief C-Pointer-Style interface for C++ API pltxt2htm::pltxt2advanced_html
- * @note Don't forget to free the returned pointer
+ * @note Don't forget to free the returned pointer by `free_html`
  */
 template<bool ndebug = false>
 [[nodiscard]]
@@ -44,13 +157,77 @@ constexpr char8_t const* advanced_parser(char8_t const* const text, char8_t cons
     noexcept
 #endif
 {
-    return ::pltxt2htm::details::c_ptr_style_wrapper<::pltxt2htm::pltxt2advanced_html<ndebug>>(
-        ::fast_io::mnp::os_c_str(text), ::fast_io::mnp::os_c_str(host));
+    return ::pltxt2htm::details::malloc_html(
+        ::pltxt2htm::details::advanced_html_render<ndebug>(::fast_io::mnp::os_c_str(text),
+                                                           ::fast_io::mnp::os_c_str(host)),
+        nullptr);
+}
+
+/**
+ * @brief Like `advanced_parser`, but the lengths of `text` and `host` are given, they need not end with `\0`
+ * @note `text` may contain `\0`, it is parsed as a char like the others
+ * @param [out] html_size: Length of the returned html, ignored if it is nullptr
+ */
+template<bool ndebug = false>
+[[nodiscard]]
+constexpr char8_t const* advanced_parser(char8_t const* const text, ::std::size_t const text_size,
+                                         char8_t const* const host, ::std::size_t const host_size,
+                                         ::std::size_t* const html_size = nullptr)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    return ::pltxt2htm::details::malloc_html(
+        ::pltxt2htm::details::advanced_html_render<ndebug>(::fast_io::u8string_view{text, text_size},
+                                                           ::fast_io::u8string_view{host, host_size}),
+        html_size);
+}
+
+/**
+ * @brief Like `advanced_parser`, but write the html to `buffer`
+ * @return Length of the html, the html is written only if it is less than `buffer_size`.
+ *         see `details::write_html`
+ */
+template<bool ndebug = false>
+[[nodiscard]]
+constexpr ::std::size_t advanced_parser_to(char8_t const* const text, ::std::size_t const text_size,
+                                           char8_t const* const host, ::std::size_t const host_size,
+                                           char8_t* const buffer, ::std::size_t const buffer_size)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    return ::pltxt2htm::details::write_html(
+        ::pltxt2htm::details::advanced_html_render<ndebug>(::fast_io::u8string_view{text, text_size},
+                                                           ::fast_io::u8string_view{host, host_size}),
+        buffer, buffer_size);
+}
+
+/**
+ * @brief Convert `count` texts of the given lengths on a pool of threads, see `convert_batch`
+ * @param threads: Number of threads, 0 means the number of cpus
+ * @param [out] htmls: Array of `count` pointers, which receives the html of each text in order.
+ *                     Don't forget to free each of them by `free_html`
+ * @param [out] html_sizes: Array of `count` lengths of the htmls, ignored if it is nullptr
+ */
+template<bool ndebug = false>
+inline void advanced_parser_batch(char8_t const* const* const texts, ::std::size_t const* const text_sizes,
+                                  ::std::size_t const count, char8_t const* const host, ::std::size_t const host_size,
+                                  ::std::size_t const threads, char8_t const** const htmls,
+                                  ::std::size_t* const html_sizes = nullptr)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    ::pltxt2htm::details::malloc_html_batch<ndebug>(
+        texts, text_sizes, count, ::fast_io::u8string_view{host, host_size},
+        ::pltxt2htm::BatchOptions{.html = ::pltxt2htm::BatchHtml::advanced, .optimize = true, .threads = threads},
+        htmls, html_sizes);
 }
 
 /**
  * @brief C-Pointer-Style interface for C++ API pltxt2htm::pltxt2fixedadv_html
- * @note Don't forget to free the returned pointer
+ * @note Don't forget to free the returned pointer by `free_html`
  */
 template<bool ndebug = false>
 [[nodiscard]]
@@ -59,13 +236,76 @@ constexpr char8_t const* fixedadv_parser(char8_t const* const text, char8_t cons
     noexcept
 #endif
 {
-    return ::pltxt2htm::details::c_ptr_style_wrapper<::pltxt2htm::pltxt2fixedadv_html<ndebug>>(
-        ::fast_io::mnp::os_c_str(text), ::fast_io::mnp::os_c_str(host));
+    return ::pltxt2htm::details::malloc_html(
+        ::pltxt2htm::details::advanced_html_render<ndebug, false>(::fast_io::mnp::os_c_str(text),
+                                                                  ::fast_io::mnp::os_c_str(host)),
+        nullptr);
+}
+
+/**
+ * @brief Like `fixedadv_parser`, but the lengths of `text` and `host` are given, they need not end with `\0`
+ * @note `text` may contain `\0`, it is parsed as a char like the others
+ * @param [out] html_size: Length of the returned html, ignored if it is nullptr
+ */
+template<bool ndebug = false>
+[[nodiscard]]
+constexpr char8_t const* fixedadv_parser(char8_t const* const text, ::std::size_t const text_size,
+                                         char8_t const* const host, ::std::size_t const host_size,
+                                         ::std::size_t* const html_size = nullptr)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    return ::pltxt2htm::details::malloc_html(
+        ::pltxt2htm::details::advanced_html_render<ndebug, false>(::fast_io::u8string_view{text, text_size},
+                                                                  ::fast_io::u8string_view{host, host_size}),
+        html_size);
+}
+
+/**
+ * @brief Like `fixedadv_parser`, but write the html to `buffer`
+ * @return Same as the one of `advanced_parser_to`
+ */
+template<bool ndebug = false>
+[[nodiscard]]
+constexpr ::std::size_t fixedadv_parser_to(char8_t const* const text, ::std::size_t const text_size,
+                                           char8_t const* const host, ::std::size_t const host_size,
+                                           char8_t* const buffer, ::std::size_t const buffer_size)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    return ::pltxt2htm::details::write_html(
+        ::pltxt2htm::details::advanced_html_render<ndebug, false>(::fast_io::u8string_view{text, text_size},
+                                                                  ::fast_io::u8string_view{host, host_size}),
+        buffer, buffer_size);
+}
+
+/**
+ * @brief Convert `count` texts of the given lengths on a pool of threads, see `convert_batch`
+ * @param threads: Number of threads, 0 means the number of cpus
+ * @param [out] htmls: Array of `count` pointers, which receives the html of each text in order.
+ *                     Don't forget to free each of them by `free_html`
+ * @param [out] html_sizes: Array of `count` lengths of the htmls, ignored if it is nullptr
+ */
+template<bool ndebug = false>
+inline void fixedadv_parser_batch(char8_t const* const* const texts, ::std::size_t const* const text_sizes,
+                                  ::std::size_t const count, char8_t const* const host, ::std::size_t const host_size,
+                                  ::std::size_t const threads, char8_t const** const htmls,
+                                  ::std::size_t* const html_sizes = nullptr)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    ::pltxt2htm::details::malloc_html_batch<ndebug>(
+        texts, text_sizes, count, ::fast_io::u8string_view{host, host_size},
+        ::pltxt2htm::BatchOptions{.html = ::pltxt2htm::BatchHtml::fixedadv, .optimize = true, .threads = threads},
+        htmls, html_sizes);
 }
 
 /**
  * @brief C-Pointer-Style interface for C++ API pltxt2htm::pltxt2common_html
- * @note Don't forget to free the returned pointer
+ * @note Don't forget to free the returned pointer by `free_html`
  */
 template<bool ndebug = false>
 [[nodiscard]]
@@ -74,8 +314,63 @@ constexpr char8_t const* common_parser(char8_t const* const text)
     noexcept
 #endif
 {
-    return ::pltxt2htm::details::c_ptr_style_wrapper<::pltxt2htm::pltxt2common_html<ndebug>>(
-        ::fast_io::mnp::os_c_str(text));
+    return ::pltxt2htm::details::malloc_html(
+        ::pltxt2htm::details::common_html_render<ndebug>(::fast_io::mnp::os_c_str(text)), nullptr);
+}
+
+/**
+ * @brief Like `common_parser`, but the length of `text` is given, it need not end with `\0`
+ * @note `text` may contain `\0`, it is parsed as a char like the others
+ * @param [out] html_size: Length of the returned html, ignored if it is nullptr
+ */
+template<bool ndebug = false>
+[[nodiscard]]
+constexpr char8_t const* common_parser(char8_t const* const text, ::std::size_t const text_size,
+                                       ::std::size_t* const html_size = nullptr)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    return ::pltxt2htm::details::malloc_html(
+        ::pltxt2htm::details::common_html_render<ndebug>(::fast_io::u8string_view{text, text_size}), html_size);
+}
+
+/**
+ * @brief Like `common_parser`, but write the html to `buffer`
+ * @return Same as the one of `advanced_parser_to`
+ */
+template<bool ndebug = false>
+[[nodiscard]]
+constexpr ::std::size_t common_parser_to(char8_t const* const text, ::std::size_t const text_size,
+                                         char8_t* const buffer, ::std::size_t const buffer_size)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    return ::pltxt2htm::details::write_html(
+        ::pltxt2htm::details::common_html_render<ndebug>(::fast_io::u8string_view{text, text_size}), buffer,
+        buffer_size);
+}
+
+/**
+ * @brief Convert `count` texts of the given lengths on a pool of threads, see `convert_batch`
+ * @param threads: Number of threads, 0 means the number of cpus
+ * @param [out] htmls: Array of `count` pointers, which receives the html of each text in order.
+ *                     Don't forget to free each of them by `free_html`
+ * @param [out] html_sizes: Array of `count` lengths of the htmls, ignored if it is nullptr
+ */
+template<bool ndebug = false>
+inline void common_parser_batch(char8_t const* const* const texts, ::std::size_t const* const text_sizes,
+                                ::std::size_t const count, ::std::size_t const threads, char8_t const** const htmls,
+                                ::std::size_t* const html_sizes = nullptr)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    ::pltxt2htm::details::malloc_html_batch<ndebug>(
+        texts, text_sizes, count, ::fast_io::u8string_view{},
+        ::pltxt2htm::BatchOptions{.html = ::pltxt2htm::BatchHtml::common, .optimize = false, .threads = threads},
+        htmls, html_sizes);
 }
 
 } // namespace pltxt2htm
@@ -4,14 +4,23 @@
     #pragma message("Fuck you, MSVC! Use [gcc/clang](https://github.com/24bit-xjkp/toolchains/releases) instead")
 #endif
 
+#include <cstddef>
+#include <concepts>
+#include <type_traits>
 #include <fast_io/fast_io_dsal/vector.h>
 #include <fast_io/fast_io_dsal/string.h>
 #include <fast_io/fast_io_dsal/string_view.h>
 #include <exception/exception.hh>
 #include "parser.hh"
 #include "optimizer.hh"
+#include "flat_ast.hh"
+#include "flat_ast_image.hh"
 #include "backend/advanced_html.hh"
 #include "backend/common_html.hh"
+#include "direct_render.hh"
+#include "sink.hh"
+#include "limits.hh"
+#include "batch.hh"
 #include "version.hh"
 
 namespace pltxt2htm {
@@ -21,20 +30,62 @@ namespace pltxt2htm {
  *        Supported syntax are listed in pltxt2htm/astnode.hh: `enum class NodeType`
  * @tparam ndebug: Whether enable more debug checks like NDEBUG macro. show details in README.md Q/A
  * @tparam optimize: whether optimize the generated html
+ * @tparam single_pass: Render the html while parsing instead of building the ast, the html is the same.
+ *                      see pltxt2htm/direct_render.hh
+ * @tparam exact_size: Measure the html of the ast before rendering it, so that the result is allocated once.
+ *                     see `advanced_html_size`. With `single_pass`, which has no ast, the pl-text is rendered twice.
  * @param pltext The text of Quantum Physics.
  */
-template<bool ndebug = false, bool optimize = true>
+template<bool ndebug = false, bool optimize = true, bool single_pass = false, bool exact_size = false>
 [[nodiscard]]
 constexpr auto pltxt2advanced_html(::fast_io::u8string_view pltext, ::fast_io::u8string_view host)
 #if __cpp_exceptions < 199711L
     noexcept
 #endif
 {
-    auto ast = ::pltxt2htm::parse_pltxt<ndebug>(pltext);
-    if constexpr (optimize) {
-        ::pltxt2htm::optimize_ast<ndebug>(ast);
+    if constexpr (single_pass) {
+        return ::pltxt2htm::details::render_to_string<exact_size>([pltext, host](auto& html_sink) {
+            ::pltxt2htm::details::direct_render<ndebug, optimize>(
+                pltext, ::pltxt2htm::details::AdvancedHtmlEmitter<ndebug>{host}, html_sink);
+        });
+    } else {
+        auto ast = ::pltxt2htm::parse_pltxt<ndebug>(pltext);
+        if constexpr (optimize) {
+            ::pltxt2htm::optimize_ast<ndebug>(ast);
+        }
+        return ::pltxt2htm::details::render_to_string<exact_size>([&ast, host](auto& html_sink) {
+            ::pltxt2htm::details::ast2advanced_html<ndebug>(ast, host, html_sink);
+        });
+    }
+}
+
+/**
+ * @brief Like `pltxt2advanced_html`, but write the html to `sink` instead of returning a new string.
+ * @param sink: `::fast_io::u8string&` (the html is appended, so its capacity can be reused across calls),
+ *              a fast_io output stream, a callback invocable with `::fast_io::u8string_view`,
+ *              or any `html_sink`.
+ */
+template<bool ndebug = false, bool optimize = true, bool single_pass = false, typename Sink>
+    requires (!::std::same_as<::std::remove_cvref_t<Sink>, ::pltxt2htm::Limits>)
+constexpr void pltxt2advanced_html(::fast_io::u8string_view pltext, ::fast_io::u8string_view host, Sink&& sink)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    if constexpr (single_pass) {
+        ::pltxt2htm::details::render_to_sink(sink, [pltext, host](auto& html_sink) {
+            ::pltxt2htm::details::direct_render<ndebug, optimize>(
+                pltext, ::pltxt2htm::details::AdvancedHtmlEmitter<ndebug>{host}, html_sink);
+        });
+    } else {
+        auto ast = ::pltxt2htm::parse_pltxt<ndebug>(pltext);
+        if constexpr (optimize) {
+            ::pltxt2htm::optimize_ast<ndebug>(ast);
+        }
+        ::pltxt2htm::details::render_to_sink(sink, [&ast, host](auto& html_sink) {
+            ::pltxt2htm::details::ast2advanced_html<ndebug>(ast, host, html_sink);
+        });
     }
-    return ::pltxt2htm::details::ast2advanced_html<ndebug>(::std::move(ast), host);
 }
 
 /**
@@ -42,28 +93,190 @@ constexpr auto pltxt2advanced_html(::fast_io::u8string_view pltext, ::fast_io::u
  *        `<` won't be transformed to `&lt;`
  * @tparam ndebug: Whether enable more debug checks like NDEBUG macro. show details in README.md Q/A
  * @tparam optimize: whether optimize the generated html
+ * @tparam single_pass: Same as the one of `pltxt2advanced_html`
+ * @tparam exact_size: Same as the one of `pltxt2advanced_html`
  */
-template<bool ndebug = false, bool optimize = true>
+template<bool ndebug = false, bool optimize = true, bool single_pass = false, bool exact_size = false>
 [[nodiscard]]
 constexpr auto pltxt2fixedadv_html(::fast_io::u8string_view pltext, ::fast_io::u8string_view host)
 #if __cpp_exceptions < 199711L
     noexcept
 #endif
+{
+    if constexpr (single_pass) {
+        return ::pltxt2htm::details::render_to_string<exact_size>([pltext, host](auto& html_sink) {
+            ::pltxt2htm::details::direct_render<ndebug, optimize>(
+                pltext, ::pltxt2htm::details::AdvancedHtmlEmitter<ndebug, false>{host}, html_sink);
+        });
+    } else {
+        auto ast = ::pltxt2htm::parse_pltxt<ndebug>(pltext);
+        if constexpr (optimize) {
+            ::pltxt2htm::optimize_ast<ndebug>(ast);
+        }
+        return ::pltxt2htm::details::render_to_string<exact_size>([&ast, host](auto& html_sink) {
+            ::pltxt2htm::details::ast2advanced_html<ndebug, false>(ast, host, html_sink);
+        });
+    }
+}
+
+/**
+ * @brief Like `pltxt2fixedadv_html`, but write the html to `sink` instead of returning a new string.
+ * @param sink: Same as the sink of `pltxt2advanced_html`
+ */
+template<bool ndebug = false, bool optimize = true, bool single_pass = false, typename Sink>
+    requires (!::std::same_as<::std::remove_cvref_t<Sink>, ::pltxt2htm::Limits>)
+constexpr void pltxt2fixedadv_html(::fast_io::u8string_view pltext, ::fast_io::u8string_view host, Sink&& sink)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    if constexpr (single_pass) {
+        ::pltxt2htm::details::render_to_sink(sink, [pltext, host](auto& html_sink) {
+            ::pltxt2htm::details::direct_render<ndebug, optimize>(
+                pltext, ::pltxt2htm::details::AdvancedHtmlEmitter<ndebug, false>{host}, html_sink);
+        });
+    } else {
+        auto ast = ::pltxt2htm::parse_pltxt<ndebug>(pltext);
+        if constexpr (optimize) {
+            ::pltxt2htm::optimize_ast<ndebug>(ast);
+        }
+        ::pltxt2htm::details::render_to_sink(sink, [&ast, host](auto& html_sink) {
+            ::pltxt2htm::details::ast2advanced_html<ndebug, false>(ast, host, html_sink);
+        });
+    }
+}
+
+/**
+ * @tparam ndebug: Whether enable more debug checks like NDEBUG macro. show details in README.md Q/A
+ * @tparam optimize: whether optimize the generated html
+ * @tparam single_pass: Same as the one of `pltxt2advanced_html`
+ * @tparam exact_size: Same as the one of `pltxt2advanced_html`
+ */
+template<bool ndebug = false, bool optimize = false, bool single_pass = false, bool exact_size = false>
+[[nodiscard]]
+constexpr auto pltxt2common_html(::fast_io::u8string_view pltext)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    if constexpr (single_pass) {
+        return ::pltxt2htm::details::render_to_string<exact_size>([pltext](auto& html_sink) {
+            ::pltxt2htm::details::direct_render<ndebug, optimize>(
+                pltext, ::pltxt2htm::details::CommonHtmlEmitter<ndebug>{}, html_sink);
+        });
+    } else {
+        auto ast = ::pltxt2htm::parse_pltxt<ndebug>(pltext);
+        if constexpr (optimize) {
+            ::pltxt2htm::optimize_ast<ndebug>(ast);
+        }
+        return ::pltxt2htm::details::render_to_string<exact_size>([&ast](auto& html_sink) {
+            ::pltxt2htm::details::ast2common_html<ndebug>(ast, html_sink);
+        });
+    }
+}
+
+/**
+ * @brief Like `pltxt2common_html`, but write the html to `sink` instead of returning a new string.
+ * @param sink: Same as the sink of `pltxt2advanced_html`
+ */
+template<bool ndebug = false, bool optimize = false, bool single_pass = false, typename Sink>
+    requires (!::std::same_as<::std::remove_cvref_t<Sink>, ::pltxt2htm::Limits>)
+constexpr void pltxt2common_html(::fast_io::u8string_view pltext, Sink&& sink)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    if constexpr (single_pass) {
+        ::pltxt2htm::details::render_to_sink(sink, [pltext](auto& html_sink) {
+            ::pltxt2htm::details::direct_render<ndebug, optimize>(
+                pltext, ::pltxt2htm::details::CommonHtmlEmitter<ndebug>{}, html_sink);
+        });
+    } else {
+        auto ast = ::pltxt2htm::parse_pltxt<ndebug>(pltext);
+        if constexpr (optimize) {
+            ::pltxt2htm::optimize_ast<ndebug>(ast);
+        }
+        ::pltxt2htm::details::render_to_sink(sink, [&ast](auto& html_sink) {
+            ::pltxt2htm::details::ast2common_html<ndebug>(ast, html_sink);
+        });
+    }
+}
+
+/**
+ * @brief Exact size in bytes of the html of the optimized `ast`, excluding the null terminator.
+ * @note The ast is rendered by `ast2advanced_html` to a sink which only counts the bytes, so the size is always the
+ *       one of the html. Callers can allocate the destination up front, then render the same ast once into it.
+ */
+template<bool ndebug = false, bool escape_less_than = true>
+[[nodiscard]]
+constexpr ::std::size_t advanced_html_size(::pltxt2htm::Ast const& ast, ::fast_io::u8string_view host)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    ::pltxt2htm::details::MeasureSink measure_sink{};
+    ::pltxt2htm::details::ast2advanced_html<ndebug, escape_less_than>(ast, host, measure_sink);
+    return measure_sink.size();
+}
+
+/**
+ * @brief Exact size in bytes of the html of `pltxt2advanced_html<ndebug, optimize>(pltext, host)`,
+ *        excluding the null terminator.
+ * @note `pltext` is parsed and optimized, then measured by `advanced_html_size(ast, host)`. Measure the ast instead
+ *       when it is rendered afterwards, so that it is parsed once.
+ */
+template<bool ndebug = false, bool optimize = true>
+[[nodiscard]]
+constexpr ::std::size_t advanced_html_size(::fast_io::u8string_view pltext, ::fast_io::u8string_view host)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
 {
     auto ast = ::pltxt2htm::parse_pltxt<ndebug>(pltext);
     if constexpr (optimize) {
         ::pltxt2htm::optimize_ast<ndebug>(ast);
     }
-    return ::pltxt2htm::details::ast2advanced_html<ndebug, false>(::std::move(ast), host);
+    return ::pltxt2htm::advanced_html_size<ndebug>(ast, host);
 }
 
 /**
- * @tparam ndebug: Whether enable more debug checks like NDEBUG macro. show details in README.md Q/A
- * @tparam optimize: whether optimize the generated html
+ * @brief Exact size in bytes of the html of `pltxt2fixedadv_html<ndebug, optimize>(pltext, host)`.
+ */
+template<bool ndebug = false, bool optimize = true>
+[[nodiscard]]
+constexpr ::std::size_t fixedadv_html_size(::fast_io::u8string_view pltext, ::fast_io::u8string_view host)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    auto ast = ::pltxt2htm::parse_pltxt<ndebug>(pltext);
+    if constexpr (optimize) {
+        ::pltxt2htm::optimize_ast<ndebug>(ast);
+    }
+    return ::pltxt2htm::advanced_html_size<ndebug, false>(ast, host);
+}
+
+/**
+ * @brief Exact size in bytes of the common html of the `ast`.
+ */
+template<bool ndebug = false>
+[[nodiscard]]
+constexpr ::std::size_t common_html_size(::pltxt2htm::Ast const& ast)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    ::pltxt2htm::details::MeasureSink measure_sink{};
+    ::pltxt2htm::details::ast2common_html<ndebug>(ast, measure_sink);
+    return measure_sink.size();
+}
+
+/**
+ * @brief Exact size in bytes of the html of `pltxt2common_html<ndebug, optimize>(pltext)`.
  */
 template<bool ndebug = false, bool optimize = false>
 [[nodiscard]]
-constexpr auto pltxt2common_html(::fast_io::u8string_view pltext)
+constexpr ::std::size_t common_html_size(::fast_io::u8string_view pltext)
 #if __cpp_exceptions < 199711L
     noexcept
 #endif
@@ -72,7 +285,105 @@ constexpr auto pltxt2common_html(::fast_io::u8string_view pltext)
     if constexpr (optimize) {
         ::pltxt2htm::optimize_ast<ndebug>(ast);
     }
-    return ::pltxt2htm::details::ast2common_html<ndebug>(::std::move(ast));
+    return ::pltxt2htm::common_html_size<ndebug>(ast);
+}
+
+namespace details {
+
+/**
+ * @brief Convert `pltext` within the budgets of `limits`, the html is escaped plain text if one runs out.
+ * @param emitter: Emitter of the target, which escapes the plain text.
+ * @param render: Invocable with the ast and an `html_sink`, which renders the target.
+ */
+template<bool ndebug, bool optimize, typename Emitter, typename Render>
+[[nodiscard]]
+inline auto convert_within_limits(::fast_io::u8string_view pltext, ::pltxt2htm::Limits const& limits,
+                                  Emitter const& emitter, Render const& render)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+    -> ::fast_io::u8string {
+    ::fast_io::u8string result{};
+    ::pltxt2htm::details::Budget budget{limits};
+    {
+        ::pltxt2htm::details::NodeArena arena{};
+        ::pltxt2htm::details::NodeArenaScope const arena_scope{arena};
+        ::pltxt2htm::details::LimitedAstBuilder<ndebug> builder{budget};
+        auto ast = ::pltxt2htm::details::parse_pltxt<ndebug>(pltext, builder);
+        if constexpr (optimize) {
+            if (!budget.exhausted()) {
+                ::pltxt2htm::details::optimize_ast<ndebug>(ast, budget);
+            }
+        }
+        if (!budget.exhausted()) {
+            ::pltxt2htm::details::LimitedSink<::fast_io::u8string> html_sink{result, budget};
+            render(ast, html_sink);
+        }
+    }
+    if (budget.exhausted()) {
+        result.clear();
+        ::pltxt2htm::details::render_plain_text(pltext, emitter, limits, result);
+    }
+    return result;
+}
+
+} // namespace details
+
+/**
+ * @brief Like `pltxt2advanced_html`, but within the budgets of `limits`, which is meant for untrusted pl-text.
+ * @param limits: When a budget runs out, the html is the whole pl-text as escaped plain text, cut at
+ *                `limits.max_output_size`. see pltxt2htm/limits.hh
+ */
+template<bool ndebug = false, bool optimize = true>
+[[nodiscard]]
+inline auto pltxt2advanced_html(::fast_io::u8string_view pltext, ::fast_io::u8string_view host,
+                                ::pltxt2htm::Limits const& limits)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+    -> ::fast_io::u8string {
+    return ::pltxt2htm::details::convert_within_limits<ndebug, optimize>(
+        pltext, limits, ::pltxt2htm::details::AdvancedHtmlEmitter<ndebug>{host},
+        [host](::pltxt2htm::Ast const& ast, auto& html_sink) {
+            ::pltxt2htm::details::ast2advanced_html<ndebug>(ast, host, html_sink);
+        });
+}
+
+/**
+ * @brief Like `pltxt2fixedadv_html`, but within the budgets of `limits`.
+ * @param limits: Same as the limits of `pltxt2advanced_html`
+ */
+template<bool ndebug = false, bool optimize = true>
+[[nodiscard]]
+inline auto pltxt2fixedadv_html(::fast_io::u8string_view pltext, ::fast_io::u8string_view host,
+                                ::pltxt2htm::Limits const& limits)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+    -> ::fast_io::u8string {
+    return ::pltxt2htm::details::convert_within_limits<ndebug, optimize>(
+        pltext, limits, ::pltxt2htm::details::AdvancedHtmlEmitter<ndebug, false>{host},
+        [host](::pltxt2htm::Ast const& ast, auto& html_sink) {
+            ::pltxt2htm::details::ast2advanced_html<ndebug, false>(ast, host, html_sink);
+        });
+}
+
+/**
+ * @brief Like `pltxt2common_html`, but within the budgets of `limits`.
+ * @param limits: Same as the limits of `pltxt2advanced_html`
+ */
+template<bool ndebug = false, bool optimize = false>
+[[nodiscard]]
+inline auto pltxt2common_html(::fast_io::u8string_view pltext, ::pltxt2htm::Limits const& limits)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+    -> ::fast_io::u8string {
+    return ::pltxt2htm::details::convert_within_limits<ndebug, optimize>(
+        pltext, limits, ::pltxt2htm::details::CommonHtmlEmitter<ndebug>{},
+        [](::pltxt2htm::Ast const& ast, auto& html_sink) {
+            ::pltxt2htm::details::ast2common_html<ndebug>(ast, html_sink);
+        });
 }
 
 } // namespace pltxt2htm
@@ -0,0 +1,285 @@
+#pragma once
+
+/**
+ * @file scanner.hh
+ * @brief Find the end of plain text and comments, and validate utf-8 in bulk
+ */
+
+#include <cstddef>
+#include <fast_io/fast_io_core.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+
+namespace pltxt2htm::details {
+
+/**
+ * @brief Whether the char is plain text which is pushed to a TextRun as is.
+ * @tparam utf8_validated: Whether the pl-text is known to be valid utf-8, if so, every non-ascii
+ *                         byte is plain text. Otherwise utf-8 sequences must be checked one by one.
+ * @note Control chars, space and the chars which start a special node are not plain.
+ */
+template<bool utf8_validated>
+[[nodiscard]]
+constexpr bool is_plain_char(char8_t chr) noexcept {
+    if (chr <= u8' ' || chr == 0x7f) {
+        return false;
+    }
+    if (chr > 0x7f) {
+        return utf8_validated;
+    }
+    switch (chr) {
+    case u8'&':
+        [[fallthrough]];
+    case u8'\'':
+        [[fallthrough]];
+    case u8'\"':
+        [[fallthrough]];
+    case u8'<':
+        [[fallthrough]];
+    case u8'>':
+        [[fallthrough]];
+    case u8'\\':
+        return false;
+    default:
+        return true;
+    }
+}
+
+/**
+ * @brief Scalar fallback of `find_plain_text_end`.
+ */
+template<bool utf8_validated>
+[[nodiscard]]
+constexpr char8_t const* find_plain_text_end_scalar(char8_t const* first, char8_t const* last) noexcept {
+    for (; first != last && ::pltxt2htm::details::is_plain_char<utf8_validated>(*first); ++first) {
+    }
+    return first;
+}
+
+/**
+ * @brief Fill all lanes of a simd vector with `chr`.
+ */
+template<::std::size_t N>
+[[nodiscard]]
+constexpr auto simd_broadcast(char unsigned chr) noexcept -> ::fast_io::intrinsics::simd_vector<char unsigned, N> {
+    ::fast_io::intrinsics::simd_vector<char unsigned, N> result;
+    for (::std::size_t i{}; i < N; ++i) {
+        result.value[i] = chr;
+    }
+    return result;
+}
+
+/**
+ * @brief Simd version of `find_plain_text_end`, compares `N` bytes at a time.
+ */
+template<bool utf8_validated, ::std::size_t N>
+[[nodiscard]]
+inline char8_t const* find_plain_text_end_simd(char8_t const* first, char8_t const* last) noexcept {
+    using simd_vector_type = ::fast_io::intrinsics::simd_vector<char unsigned, N>;
+
+    // bytes out of [0x21, 0x7e] are greater than 0x5d after subtracting 0x21
+    auto const exclamations = ::pltxt2htm::details::simd_broadcast<N>(u8'!');
+    auto const printable_range = ::pltxt2htm::details::simd_broadcast<N>(0x7e - u8'!');
+    auto const spaces = ::pltxt2htm::details::simd_broadcast<N>(u8' ');
+    auto const deletes = ::pltxt2htm::details::simd_broadcast<N>(0x7f);
+    auto const ampersands = ::pltxt2htm::details::simd_broadcast<N>(u8'&');
+    auto const single_quotes = ::pltxt2htm::details::simd_broadcast<N>(u8'\'');
+    auto const double_quotes = ::pltxt2htm::details::simd_broadcast<N>(u8'\"');
+    auto const less_thans = ::pltxt2htm::details::simd_broadcast<N>(u8'<');
+    auto const greater_thans = ::pltxt2htm::details::simd_broadcast<N>(u8'>');
+    auto const backslashes = ::pltxt2htm::details::simd_broadcast<N>(u8'\\');
+
+    simd_vector_type simdvec;
+    for (; N <= static_cast<::std::size_t>(last - first); first += N) {
+        simdvec.load(first);
+        simd_vector_type mask;
+        if constexpr (utf8_validated) {
+            mask = (simdvec <= spaces) | (simdvec == deletes);
+        } else {
+            mask = (simdvec - exclamations) > printable_range;
+        }
+        mask = mask | (simdvec == ampersands) | (simdvec == single_quotes) | (simdvec == double_quotes) |
+               (simdvec == less_thans) | (simdvec == greater_thans) | (simdvec == backslashes);
+        if (!::fast_io::intrinsics::is_all_zeros(mask)) {
+            return first + ::fast_io::intrinsics::vector_mask_countr_zero(mask);
+        }
+    }
+    return ::pltxt2htm::details::find_plain_text_end_scalar<utf8_validated>(first, last);
+}
+
+/**
+ * @brief Find the first char in [first, last) which is not plain text.
+ * @note Plain text is the hottest path of the parser, the whole run is consumed at once
+ *       instead of one node per byte.
+ */
+template<bool utf8_validated>
+[[nodiscard]]
+constexpr char8_t const* find_plain_text_end(char8_t const* first, char8_t const* last) noexcept {
+    constexpr ::std::size_t simd_size{
+        ::fast_io::intrinsics::optimal_simd_vector_run_with_cpu_instruction_size_with_mask_countr};
+    if constexpr (simd_size != 0) {
+        if !consteval {
+            return ::pltxt2htm::details::find_plain_text_end_simd<utf8_validated, simd_size>(first, last);
+        }
+    }
+    return ::pltxt2htm::details::find_plain_text_end_scalar<utf8_validated>(first, last);
+}
+
+/**
+ * @brief Scalar fallback of `find_comment_end`.
+ */
+[[nodiscard]]
+constexpr char8_t const* find_comment_end_scalar(char8_t const* first, char8_t const* last) noexcept {
+    for (; 3 <= static_cast<::std::size_t>(last - first); ++first) {
+        if (first[0] == u8'-' && first[1] == u8'-' && first[2] == u8'>') {
+            return first;
+        }
+    }
+    return last;
+}
+
+/**
+ * @brief Simd version of `find_comment_end`, matches `-->` at `N` offsets at a time.
+ */
+template<::std::size_t N>
+[[nodiscard]]
+inline char8_t const* find_comment_end_simd(char8_t const* first, char8_t const* last) noexcept {
+    using simd_vector_type = ::fast_io::intrinsics::simd_vector<char unsigned, N>;
+    auto const hyphens = ::pltxt2htm::details::simd_broadcast<N>(u8'-');
+    auto const greater_thans = ::pltxt2htm::details::simd_broadcast<N>(u8'>');
+
+    // the vectors of offsets 0, 1 and 2, which are the 3 bytes of `-->`
+    simd_vector_type simdvec0;
+    simd_vector_type simdvec1;
+    simd_vector_type simdvec2;
+    for (; N + 2 <= static_cast<::std::size_t>(last - first); first += N) {
+        simdvec0.load(first);
+        simdvec1.load(first + 1);
+        simdvec2.load(first + 2);
+        auto const mask = (simdvec0 == hyphens) & (simdvec1 == hyphens) & (simdvec2 == greater_thans);
+        if (!::fast_io::intrinsics::is_all_zeros(mask)) {
+            return first + ::fast_io::intrinsics::vector_mask_countr_zero(mask);
+        }
+    }
+    return ::pltxt2htm::details::find_comment_end_scalar(first, last);
+}
+
+/**
+ * @brief Find the first `-->` in [first, last), `last` if there is none.
+ * @note Commented-out blocks may be large, their bodies are skipped in bulk.
+ */
+[[nodiscard]]
+constexpr char8_t const* find_comment_end(char8_t const* first, char8_t const* last) noexcept {
+    constexpr ::std::size_t simd_size{
+        ::fast_io::intrinsics::optimal_simd_vector_run_with_cpu_instruction_size_with_mask_countr};
+    if constexpr (simd_size != 0) {
+        if !consteval {
+            return ::pltxt2htm::details::find_comment_end_simd<simd_size>(first, last);
+        }
+    }
+    return ::pltxt2htm::details::find_comment_end_scalar(first, last);
+}
+
+/**
+ * @brief Length of the utf-8 sequence starting at `first`, 0 if the sequence is invalid.
+ * @note Overlong encodings, surrogates and code points above U+10FFFF are invalid.
+ */
+[[nodiscard]]
+constexpr ::std::size_t utf8_sequence_length(char8_t const* first, char8_t const* last) noexcept {
+    auto const size = static_cast<::std::size_t>(last - first);
+    char8_t const lead{*first};
+    auto const is_continuation = [](char8_t chr) static constexpr noexcept { return (chr & 0xC0) == 0x80; };
+    if (lead < 0x80) {
+        return 1;
+    } else if (lead < 0xC2) {
+        // continuation bytes or overlong 2 bytes sequences
+        return 0;
+    } else if (lead < 0xE0) {
+        return size >= 2 && is_continuation(first[1]) ? 2 : 0;
+    } else if (lead < 0xF0) {
+        if (size < 3 || !is_continuation(first[1]) || !is_continuation(first[2])) {
+            return 0;
+        }
+        // overlong or surrogate
+        if ((lead == 0xE0 && first[1] < 0xA0) || (lead == 0xED && first[1] >= 0xA0)) {
+            return 0;
+        }
+        return 3;
+    } else if (lead < 0xF5) {
+        if (size < 4 || !is_continuation(first[1]) || !is_continuation(first[2]) || !is_continuation(first[3])) {
+            return 0;
+        }
+        // overlong or greater than U+10FFFF
+        if ((lead == 0xF0 && first[1] < 0x90) || (lead == 0xF4 && first[1] >= 0x90)) {
+            return 0;
+        }
+        return 4;
+    } else {
+        return 0;
+    }
+}
+
+/**
+ * @brief Scalar fallback of `is_valid_utf8`.
+ */
+[[nodiscard]]
+constexpr bool is_valid_utf8_scalar(char8_t const* first, char8_t const* last) noexcept {
+    while (first != last) {
+        auto const length = ::pltxt2htm::details::utf8_sequence_length(first, last);
+        if (length == 0) {
+            return false;
+        }
+        first += length;
+    }
+    return true;
+}
+
+/**
+ * @brief Simd version of `is_valid_utf8`, skips `N` bytes of ascii at a time.
+ */
+template<::std::size_t N>
+[[nodiscard]]
+inline bool is_valid_utf8_simd(char8_t const* first, char8_t const* last) noexcept {
+    using simd_vector_type = ::fast_io::intrinsics::simd_vector<char unsigned, N>;
+    auto const ascii_max = ::pltxt2htm::details::simd_broadcast<N>(0x7f);
+
+    simd_vector_type simdvec;
+    while (N <= static_cast<::std::size_t>(last - first)) {
+        simdvec.load(first);
+        auto const mask = simdvec > ascii_max;
+        if (::fast_io::intrinsics::is_all_zeros(mask)) {
+            first += N;
+            continue;
+        }
+        first += ::fast_io::intrinsics::vector_mask_countr_zero(mask);
+        // validate non-ascii sequences until the next ascii byte
+        do {
+            auto const length = ::pltxt2htm::details::utf8_sequence_length(first, last);
+            if (length == 0) {
+                return false;
+            }
+            first += length;
+        } while (first != last && *first > 0x7f);
+    }
+    return ::pltxt2htm::details::is_valid_utf8_scalar(first, last);
+}
+
+/**
+ * @brief Whether the whole pl-text is valid utf-8.
+ * @note The parser validates the input once, so that valid text is consumed in bulk and
+ *       only invalid input takes the per code point path.
+ */
+[[nodiscard]]
+constexpr bool is_valid_utf8(::fast_io::u8string_view pltext) noexcept {
+    auto const first = pltext.data();
+    auto const last = pltext.data() + pltext.size();
+    constexpr ::std::size_t simd_size{
+        ::fast_io::intrinsics::optimal_simd_vector_run_with_cpu_instruction_size_with_mask_countr};
+    if constexpr (simd_size != 0) {
+        if !consteval {
+            return ::pltxt2htm::details::is_valid_utf8_simd<simd_size>(first, last);
+        }
+    }
+    return ::pltxt2htm::details::is_valid_utf8_scalar(first, last);
+}
+
+} // namespace pltxt2htm::details
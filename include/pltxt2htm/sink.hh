@@ -0,0 +1,208 @@
+#pragma once
+
+/**
+ * @file sink.hh
+ * @brief Where the backends write html to
+ */
+
+#include <cstddef>
+#include <concepts>
+#include <algorithm>
+#include <utility>
+#include <fast_io/fast_io_core.h>
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+
+namespace pltxt2htm {
+
+/**
+ * @brief A sink receives the html in order, piece by piece.
+ * @note `::fast_io::u8string` is a sink, the html is appended to it.
+ */
+template<typename T>
+concept html_sink = requires(T& sink, ::fast_io::u8string_view str, char8_t chr) {
+    sink.append(str);
+    sink.push_back(chr);
+};
+
+namespace details {
+
+/**
+ * @brief Write to a fast_io output stream (e.g. `::fast_io::u8c_stdout()`, `::fast_io::u8obuf_file`).
+ */
+template<typename Output>
+class StreamWriter {
+    Output& output_;
+
+public:
+    constexpr explicit StreamWriter(Output& output) noexcept
+        : output_{output} {
+    }
+
+    constexpr void operator()(this StreamWriter& self, ::fast_io::u8string_view str)
+#if __cpp_exceptions < 199711L
+        noexcept
+#endif
+    {
+        ::fast_io::operations::write_all(self.output_, str.data(), str.data() + str.size());
+    }
+};
+
+/**
+ * @brief Collect the pieces of html in a fixed buffer, and pass the buffer to `writer` when it is full.
+ * @tparam Writer: Invocable with `::fast_io::u8string_view`.
+ * @note The backends emit a lot of tiny pieces, writing them one by one to a stream or a callback is slow.
+ *       Call `flush` after rendering.
+ */
+template<typename Writer, ::std::size_t buffer_capacity = 4096>
+class BufferedSink {
+    Writer writer_;
+    ::std::size_t size_{};
+    char8_t buffer_[buffer_capacity];
+
+public:
+    constexpr explicit BufferedSink(Writer writer) noexcept
+        : writer_{::std::forward<Writer>(writer)} {
+    }
+
+    constexpr void append(this BufferedSink& self, ::fast_io::u8string_view str)
+#if __cpp_exceptions < 199711L
+        noexcept
+#endif
+    {
+        if (str.size() > buffer_capacity - self.size_) {
+            self.flush();
+            if (str.size() >= buffer_capacity) {
+                // large text runs are passed through without copying
+                self.writer_(str);
+                return;
+            }
+        }
+        ::std::copy_n(str.data(), str.size(), self.buffer_ + self.size_);
+        self.size_ += str.size();
+    }
+
+    constexpr void push_back(this BufferedSink& self, char8_t chr)
+#if __cpp_exceptions < 199711L
+        noexcept
+#endif
+    {
+        if (self.size_ == buffer_capacity) [[unlikely]] {
+            self.flush();
+        }
+        self.buffer_[self.size_++] = chr;
+    }
+
+    constexpr void flush(this BufferedSink& self)
+#if __cpp_exceptions < 199711L
+        noexcept
+#endif
+    {
+        if (self.size_ != 0) {
+            self.writer_(::fast_io::u8string_view{self.buffer_, self.size_});
+            self.size_ = 0;
+        }
+    }
+};
+
+/**
+ * @brief Count the bytes of the html instead of storing them.
+ */
+class MeasureSink {
+    ::std::size_t size_{};
+
+public:
+    constexpr void append(this MeasureSink& self, ::fast_io::u8string_view str) noexcept {
+        self.size_ += str.size();
+    }
+
+    constexpr void push_back(this MeasureSink& self, char8_t) noexcept {
+        ++self.size_;
+    }
+
+    [[nodiscard]]
+    constexpr ::std::size_t size(this MeasureSink const& self) noexcept {
+        return self.size_;
+    }
+};
+
+/**
+ * @brief Write the html to a buffer without checking its capacity.
+ * @note The buffer must be large enough, which is measured by `MeasureSink` before.
+ */
+class UncheckedSink {
+    char8_t* curr_ptr_;
+
+public:
+    constexpr explicit UncheckedSink(char8_t* buffer) noexcept
+        : curr_ptr_{buffer} {
+    }
+
+    constexpr void append(this UncheckedSink& self, ::fast_io::u8string_view str) noexcept {
+        self.curr_ptr_ = ::std::copy_n(str.data(), str.size(), self.curr_ptr_);
+    }
+
+    constexpr void push_back(this UncheckedSink& self, char8_t chr) noexcept {
+        *self.curr_ptr_++ = chr;
+    }
+};
+
+/**
+ * @brief Render html into a new string by `render`, which is invoked with an `html_sink`.
+ * @tparam exact_size: Measure the html by a first `render` to allocate the string once,
+ *                     then write it by a second `render` without capacity checks
+ */
+template<bool exact_size, typename Render>
+[[nodiscard]]
+constexpr auto render_to_string(Render&& render)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+    -> ::fast_io::u8string {
+    if constexpr (exact_size) {
+        ::pltxt2htm::details::MeasureSink measure_sink{};
+        render(measure_sink);
+        // a string of `size` zeroed chars
+        ::fast_io::u8string result(measure_sink.size());
+        ::pltxt2htm::details::UncheckedSink unchecked_sink{result.data()};
+        render(unchecked_sink);
+        return result;
+    } else {
+        ::fast_io::u8string result{};
+        render(result);
+        return result;
+    }
+}
+
+/**
+ * @brief Render html into `sink` by `render`, which is invoked with an `html_sink`.
+ * @param sink: One of
+ *              - an `html_sink`, e.g. `::fast_io::u8string&` whose capacity can be reused across calls
+ *              - a fast_io output stream, e.g. `::fast_io::u8c_stdout()` or a buffered file
+ *              - a callback invocable with `::fast_io::u8string_view`
+ */
+template<typename Sink, typename Render>
+constexpr void render_to_sink(Sink& sink, Render&& render)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif
+{
+    if constexpr (::pltxt2htm::html_sink<Sink>) {
+        render(sink);
+    } else if constexpr (::fast_io::operations::defines::has_output_or_io_stream_ref_define<Sink&>) {
+        ::pltxt2htm::details::BufferedSink<::pltxt2htm::details::StreamWriter<Sink>> buffered_sink{
+            ::pltxt2htm::details::StreamWriter<Sink>{sink}};
+        render(buffered_sink);
+        buffered_sink.flush();
+    } else {
+        static_assert(::std::invocable<Sink&, ::fast_io::u8string_view>,
+                      "sink must be an html_sink, a fast_io output stream or invocable with u8string_view");
+        ::pltxt2htm::details::BufferedSink<Sink&> buffered_sink{sink};
+        render(buffered_sink);
+        buffered_sink.flush();
+    }
+}
+
+} // namespace details
+
+} // namespace pltxt2htm
@@ -0,0 +1,180 @@
+#pragma once
+
+/**
+ * @file tag_name.hh
+ * @brief Recognize tag names a word at a time
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <exception/exception.hh>
+#include "astnode/node_type.hh"
+
+namespace pltxt2htm::details {
+
+/**
+ * @brief Load 8 bytes from `first` as a little endian word.
+ * @note Compiled to a single load on little endian targets.
+ */
+[[nodiscard]]
+constexpr ::std::uint_least64_t load_word(char8_t const* first) noexcept {
+    return [first]<::std::size_t... Is>(::std::index_sequence<Is...>) {
+        return ((static_cast<::std::uint_least64_t>(first[Is]) << (Is * 8)) | ...);
+    }(::std::make_index_sequence<8>{});
+}
+
+/**
+ * @brief Mask of the lowest `size` bytes of a word.
+ */
+[[nodiscard]]
+constexpr ::std::uint_least64_t low_bytes_mask(::std::size_t size) noexcept {
+    return size >= 8 ? ~::std::uint_least64_t{} : (::std::uint_least64_t{1} << (size * 8)) - 1;
+}
+
+/**
+ * @brief Bytes [offset, offset + 8) of `name` as a little endian word, bytes after the name are zero.
+ */
+template<::std::size_t offset, char8_t... name>
+[[nodiscard]]
+consteval ::std::uint_least64_t name_word() noexcept {
+    char8_t const str[]{name..., u8'\0'};
+    ::std::uint_least64_t word{};
+    for (::std::size_t i{offset}; i < sizeof...(name) && i < offset + 8; ++i) {
+        word |= static_cast<::std::uint_least64_t>(str[i]) << ((i - offset) * 8);
+    }
+    return word;
+}
+
+/**
+ * @brief Like `name_word`, but every letter of `name` is 0x20 and other bytes are zero.
+ * @note ASCII between lowercase and uppercase is 32, so or-ing the mask folds the case of letters only.
+ */
+template<::std::size_t offset, char8_t... name>
+[[nodiscard]]
+consteval ::std::uint_least64_t name_fold_mask() noexcept {
+    char8_t const str[]{name..., u8'\0'};
+    ::std::uint_least64_t mask{};
+    for (::std::size_t i{offset}; i < sizeof...(name) && i < offset + 8; ++i) {
+        if (u8'a' <= str[i] && str[i] <= u8'z') {
+            mask |= ::std::uint_least64_t{0x20} << ((i - offset) * 8);
+        }
+    }
+    return mask;
+}
+
+/**
+ * @brief Load bytes [offset, size) (at most 8) of the tag name `str` as a word, with the letters lowercased.
+ * @note The name only contains letters and digits, setting 0x20 of every byte keeps digits as is.
+ */
+[[nodiscard]]
+constexpr ::std::uint_least64_t load_folded_name_word(::fast_io::u8string_view str, ::std::size_t offset,
+                                                      ::std::size_t size) noexcept {
+    auto const mask = ::pltxt2htm::details::low_bytes_mask(size - offset);
+    ::std::uint_least64_t word{};
+    if (str.size() - offset >= 8) {
+        word = ::pltxt2htm::details::load_word(str.data() + offset);
+    } else {
+        for (::std::size_t i{offset}; i < size; ++i) {
+            word |= static_cast<::std::uint_least64_t>(str.data()[i]) << ((i - offset) * 8);
+        }
+    }
+    return (word | ::std::uint_least64_t{0x2020202020202020}) & mask;
+}
+
+/**
+ * @brief Recognize the name of a tag, e.g. `color` of `<color=red>` and `</color>`.
+ * @param[in] str: text after `<` or `</`
+ * @param[out] name_size: length of the tag name
+ * @return Type of the tag, nullopt if the name is not a tag of pl-text.
+ * @note The name is loaded and case folded as words, then resolved by one switch over
+ *       the words of all tag names instead of matching every candidate byte by byte.
+ */
+template<bool ndebug>
+[[nodiscard]]
+constexpr auto recognize_tag_name(::fast_io::u8string_view str, ::std::size_t& name_size) noexcept
+    -> ::exception::optional<::pltxt2htm::NodeType> {
+    // `experiment` and `discussion` are the longest names
+    constexpr ::std::size_t max_name_size{10};
+    auto const is_name_char = [](char8_t chr) static constexpr noexcept {
+        return (u8'a' <= chr && chr <= u8'z') || (u8'A' <= chr && chr <= u8'Z') || (u8'0' <= chr && chr <= u8'9');
+    };
+
+    ::std::size_t size{};
+    while (size < str.size() && size <= max_name_size && is_name_char(str.data()[size])) {
+        ++size;
+    }
+    if (size == 0 || size > max_name_size) {
+        return ::exception::nullopt_t{};
+    }
+    name_size = size;
+
+    // names no longer than 8 bytes are distinct words because the bytes after the name are zero
+    switch (::pltxt2htm::details::load_folded_name_word(str, 0, size)) {
+    case ::pltxt2htm::details::name_word<0, u8'a'>():
+        return ::pltxt2htm::NodeType::pl_a;
+    case ::pltxt2htm::details::name_word<0, u8'b'>():
+        return ::pltxt2htm::NodeType::pl_b;
+    case ::pltxt2htm::details::name_word<0, u8'i'>():
+        return ::pltxt2htm::NodeType::pl_i;
+    case ::pltxt2htm::details::name_word<0, u8'p'>():
+        return ::pltxt2htm::NodeType::html_p;
+    case ::pltxt2htm::details::name_word<0, u8'b', u8'r'>():
+        return ::pltxt2htm::NodeType::html_br;
+    case ::pltxt2htm::details::name_word<0, u8'e', u8'm'>():
+        return ::pltxt2htm::NodeType::html_em;
+    case ::pltxt2htm::details::name_word<0, u8'h', u8'1'>():
+        return ::pltxt2htm::NodeType::html_h1;
+    case ::pltxt2htm::details::name_word<0, u8'h', u8'2'>():
+        return ::pltxt2htm::NodeType::html_h2;
+    case ::pltxt2htm::details::name_word<0, u8'h', u8'3'>():
+        return ::pltxt2htm::NodeType::html_h3;
+    case ::pltxt2htm::details::name_word<0, u8'h', u8'4'>():
+        return ::pltxt2htm::NodeType::html_h4;
+    case ::pltxt2htm::details::name_word<0, u8'h', u8'5'>():
+        return ::pltxt2htm::NodeType::html_h5;
+    case ::pltxt2htm::details::name_word<0, u8'h', u8'6'>():
+        return ::pltxt2htm::NodeType::html_h6;
+    case ::pltxt2htm::details::name_word<0, u8'h', u8'r'>():
+        return ::pltxt2htm::NodeType::html_hr;
+    case ::pltxt2htm::details::name_word<0, u8'l', u8'i'>():
+        return ::pltxt2htm::NodeType::html_li;
+    case ::pltxt2htm::details::name_word<0, u8'u', u8'l'>():
+        return ::pltxt2htm::NodeType::html_ul;
+    case ::pltxt2htm::details::name_word<0, u8'd', u8'e', u8'l'>():
+        return ::pltxt2htm::NodeType::html_del;
+    case ::pltxt2htm::details::name_word<0, u8'p', u8'r', u8'e'>():
+        return ::pltxt2htm::NodeType::html_pre;
+    case ::pltxt2htm::details::name_word<0, u8'c', u8'o', u8'd', u8'e'>():
+        return ::pltxt2htm::NodeType::html_code;
+    case ::pltxt2htm::details::name_word<0, u8's', u8'i', u8'z', u8'e'>():
+        return ::pltxt2htm::NodeType::pl_size;
+    case ::pltxt2htm::details::name_word<0, u8'u', u8's', u8'e', u8'r'>():
+        return ::pltxt2htm::NodeType::pl_user;
+    case ::pltxt2htm::details::name_word<0, u8'c', u8'o', u8'l', u8'o', u8'r'>():
+        return ::pltxt2htm::NodeType::pl_color;
+    case ::pltxt2htm::details::name_word<0, u8's', u8't', u8'r', u8'o', u8'n', u8'g'>():
+        return ::pltxt2htm::NodeType::html_strong;
+    case ::pltxt2htm::details::name_word<0, u8'e', u8'x', u8'p', u8'e', u8'r', u8'i', u8'm', u8'e', u8'n', u8't'>(): {
+        if (size == 10 && ::pltxt2htm::details::load_folded_name_word(str, 8, size) ==
+                              ::pltxt2htm::details::name_word<8, u8'e', u8'x', u8'p', u8'e', u8'r', u8'i', u8'm',
+                                                              u8'e', u8'n', u8't'>()) {
+            return ::pltxt2htm::NodeType::pl_experiment;
+        }
+        return ::exception::nullopt_t{};
+    }
+    case ::pltxt2htm::details::name_word<0, u8'd', u8'i', u8's', u8'c', u8'u', u8's', u8's', u8'i', u8'o', u8'n'>(): {
+        if (size == 10 && ::pltxt2htm::details::load_folded_name_word(str, 8, size) ==
+                              ::pltxt2htm::details::name_word<8, u8'd', u8'i', u8's', u8'c', u8'u', u8's', u8's',
+                                                              u8'i', u8'o', u8'n'>()) {
+            return ::pltxt2htm::NodeType::pl_discussion;
+        }
+        return ::exception::nullopt_t{};
+    }
+    default:
+        return ::exception::nullopt_t{};
+    }
+}
+
+} // namespace pltxt2htm::details
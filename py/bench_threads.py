@@ -0,0 +1,60 @@
+# Throughput of converting documents on 1..N python threads and by the batch api, run it after building the module
+# Conversions run in parallel because the GIL is released while parsing and rendering,
+# on free-threaded python (3.13t) the argument parsing runs in parallel too
+
+import os
+import sys
+import time
+import threading
+import pltxt2htm
+
+if __name__ != "__main__":
+    raise Exception("This file can't be imported")
+
+PARAGRAPH = (
+    "<size=48><b>实验目的</b></size>\n"
+    "测量<color=red>小灯泡</color>的伏安特性曲线, 参见<Experiment=642cf37a494746375aae306a>电学实验</Experiment>\n"
+    "<i>注意</i>: 电压不要超过 3.8V, 否则会烧坏小灯泡 &lt;警告&gt;\n"
+    "# 数据记录\n"
+    "<del>旧数据</del> <a>链接</a> \\* 星号 <!-- 这是注释 -->\n\n"
+)
+# experiment's introduction of about 50 KB
+DOCUMENT = PARAGRAPH * (50 * 1024 // len(PARAGRAPH.encode()))
+DOCUMENTS_PER_THREAD = 64
+
+
+def convert(count: int) -> None:
+    for _ in range(count):
+        pltxt2htm.advanced_parser(DOCUMENT, "localhost:5173")
+
+
+def run(threads: int) -> float:
+    workers = [threading.Thread(target=convert, args=(DOCUMENTS_PER_THREAD,)) for _ in range(threads)]
+    begin = time.perf_counter()
+    for worker in workers:
+        worker.start()
+    for worker in workers:
+        worker.join()
+    return threads * DOCUMENTS_PER_THREAD * len(DOCUMENT.encode()) / (time.perf_counter() - begin)
+
+
+gil_enabled = getattr(sys, "_is_gil_enabled", lambda: True)()
+print(f"python {sys.version.split()[0]}, gil enabled: {gil_enabled}, cpus: {os.cpu_count()}")
+convert(4)  # warm up
+single = run(1)
+threads = 1
+while threads <= (os.cpu_count() or 1):
+    throughput = run(threads)
+    print(f"{threads:>3} threads: {throughput / 1024 / 1024:8.2f} MiB/s, speedup {throughput / single:.2f}x")
+    threads *= 2
+
+# many short titles, a loop of advanced_parser vs advanced_parser_batch
+titles = [f"<color=red>实验 {i}</color> <b>小灯泡</b>的伏安特性" for i in range(100000)]
+begin = time.perf_counter()
+for title in titles:
+    pltxt2htm.advanced_parser(title, "localhost:5173")
+loop_time = time.perf_counter() - begin
+begin = time.perf_counter()
+pltxt2htm.advanced_parser_batch(titles, "localhost:5173")
+batch_time = time.perf_counter() - begin
+print(f"{len(titles)} titles: loop {loop_time:.3f}s, batch {batch_time:.3f}s")
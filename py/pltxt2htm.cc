@@ -1,84 +1,342 @@
-#include <cstdlib>
+#define PY_SSIZE_T_CLEAN
+#include <cstddef>
+#include <cstring>
 #include <memory>
+#include <span>
 #include <Python.h>
 #include <fast_io/fast_io_dsal/array.h>
+#include <fast_io/fast_io_dsal/vector.h>
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
 #include <pltxt2htm/pltxt2htm.h>
 
-static ::PyObject* common_parser([[maybe_unused]] ::PyObject* self, ::PyObject* args, ::PyObject* kwargs)
+namespace {
+
+#ifdef NDEBUG
+constexpr bool ndebug{true};
+#else
+constexpr bool ndebug{false};
+#endif
+
+/**
+ * @brief Utf-8 text of an argument, which is a `str` or a bytes-like object (`bytes`, `bytearray`, `memoryview`...)
+ * @note The text is borrowed from a `str` or a read-only buffer without copy, a writable buffer is copied.
+ */
+class Utf8Arg {
+    ::Py_buffer buffer_{};
+    bool is_buffer_{};
+    bool is_ascii_{};
+    ::fast_io::u8string_view text_{};
+    // copy of a writable buffer
+    ::fast_io::u8string copy_{};
+
+public:
+    constexpr Utf8Arg() noexcept = default;
+    Utf8Arg(Utf8Arg const&) noexcept = delete;
+    Utf8Arg& operator=(Utf8Arg const&) noexcept = delete;
+
+    ~Utf8Arg() noexcept {
+        if (this->is_buffer_) {
+            ::PyBuffer_Release(::std::addressof(this->buffer_));
+        }
+    }
+
+    /**
+     * @return false with a python exception set if `obj` is neither `str` nor bytes-like
+     */
+    [[nodiscard]]
+    bool init(this Utf8Arg& self, ::PyObject* obj, char const* name) noexcept {
+        if (PyUnicode_Check(obj)) {
+            ::Py_ssize_t size{};
+            // the utf-8 of a str is cached by itself, and is the str itself for ascii str
+            char const* text = ::PyUnicode_AsUTF8AndSize(obj, ::std::addressof(size));
+            if (text == nullptr) [[unlikely]] {
+                return false;
+            }
+            self.text_ = ::fast_io::u8string_view{reinterpret_cast<char8_t const*>(text),
+                                                  static_cast<::std::size_t>(size)};
+            self.is_ascii_ = PyUnicode_IS_ASCII(obj);
+            return true;
+        }
+        if (PyObject_CheckBuffer(obj)) {
+            if (::PyObject_GetBuffer(obj, ::std::addressof(self.buffer_), PyBUF_SIMPLE) != 0) [[unlikely]] {
+                return false;
+            }
+            self.is_buffer_ = true;
+            self.text_ = ::fast_io::u8string_view{static_cast<char8_t const*>(self.buffer_.buf),
+                                                  static_cast<::std::size_t>(self.buffer_.len)};
+            if (!self.buffer_.readonly) {
+                // a `bytearray` or a writable `memoryview` can be modified by other threads while the GIL is
+                // released, then the html would be rendered from another text than the measured one
+                self.copy_.append(self.text_);
+                self.text_ = ::fast_io::u8string_view{self.copy_.data(), self.copy_.size()};
+                ::PyBuffer_Release(::std::addressof(self.buffer_));
+                self.is_buffer_ = false;
+            }
+            return true;
+        }
+        ::PyErr_Format(PyExc_TypeError, "%s must be str or a bytes-like object, not %.200s", name,
+                       Py_TYPE(obj)->tp_name);
+        return false;
+    }
+
+    [[nodiscard]]
+    ::fast_io::u8string_view text(this Utf8Arg const& self) noexcept {
+        return self.text_;
+    }
+
+    /**
+     * @brief Whether the text is known to be ascii, bytes-like objects are never known
+     */
+    [[nodiscard]]
+    bool is_ascii(this Utf8Arg const& self) noexcept {
+        return self.is_ascii_;
+    }
+};
+
+/**
+ * @brief Build the python object of the html rendered by `make_render()`, without copying the html.
+ * @note The GIL is released while parsing and rendering, which touch no python object. The text is an immutable
+ *       str/bytes, a read-only buffer or a copy of a writable buffer (see `Utf8Arg`), so it is the same when the
+ *       html is measured and rendered.
+ * @param is_ascii: Whether the html is known to be ascii, which is true if the text and host are ascii,
+ *                  because only invalid utf-8 is rendered to non-ascii chars besides the text itself
+ * @param as_bytes: Return the utf-8 of the html as `bytes` instead of `str`
+ */
+template<typename MakeRender>
+::PyObject* html_object(MakeRender const& make_render, bool is_ascii, bool as_bytes)
 #if __cpp_exceptions < 199711L
     noexcept
 #endif // __cpp_exceptions < 199711L
 {
-    static auto kwlist = ::fast_io::array{"text", nullptr};
-#ifndef NDEBUG
-    char8_t const* text = nullptr;
-#else
-    #if __has_cpp_attribute(indeterminate)
-    char8_t const* text [[indeterminate]];
-    #else
-    char8_t const* text;
-    #endif
-#endif
+    ::PyThreadState* thread_state = ::PyEval_SaveThread();
+    auto const render = make_render();
+    ::pltxt2htm::details::MeasureSink measure_sink{};
+    render(measure_sink);
+    auto const size = static_cast<::Py_ssize_t>(measure_sink.size());
+
+    if (as_bytes || is_ascii) {
+        ::PyEval_RestoreThread(thread_state);
+        // ascii str is stored as utf-8 by python, the html is written to it directly
+        ::PyObject* result = as_bytes ? ::PyBytes_FromStringAndSize(nullptr, size) : ::PyUnicode_New(size, 127);
+        if (result == nullptr) [[unlikely]] {
+            return nullptr;
+        }
+        auto const data = as_bytes ? reinterpret_cast<char8_t*>(PyBytes_AS_STRING(result))
+                                   : reinterpret_cast<char8_t*>(PyUnicode_1BYTE_DATA(result));
+        // the new object is not visible to other threads yet
+        thread_state = ::PyEval_SaveThread();
+        ::pltxt2htm::details::UncheckedSink sink{data};
+        render(sink);
+        ::PyEval_RestoreThread(thread_state);
+        return result;
+    } else {
+        // short html like titles is rendered on the stack to avoid an allocation
+        char8_t stack_buffer[1024];
+        ::fast_io::u8string heap_buffer{};
+        char8_t* html{stack_buffer};
+        if (measure_sink.size() > sizeof(stack_buffer)) {
+            heap_buffer = ::fast_io::u8string(measure_sink.size());
+            html = heap_buffer.data();
+        }
+        ::pltxt2htm::details::UncheckedSink sink{html};
+        render(sink);
+        ::PyEval_RestoreThread(thread_state);
+        // python chooses the narrowest kind (latin-1, ucs2 or ucs4) of the str while decoding
+        return ::PyUnicode_DecodeUTF8(reinterpret_cast<char const*>(html), size, nullptr);
+    }
+}
+
+template<bool escape_less_than>
+::PyObject* advanced_html(::PyObject* args, ::PyObject* kwargs)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif // __cpp_exceptions < 199711L
+{
+    static auto kwlist = ::fast_io::array{"text", "host", "as_bytes", nullptr};
+    ::PyObject* text_obj = nullptr;
+    ::PyObject* host_obj = nullptr;
+    int as_bytes{};
     // Before python3.13, argument `keywords` does not marked as const
-    if (!::PyArg_ParseTupleAndKeywords(args, kwargs, "s",
+    if (!::PyArg_ParseTupleAndKeywords(args, kwargs, "OO|$p",
 #if PY_MINOR_VERSION < 13
                                        const_cast<char**>(kwlist.data()),
 #else
                                        kwlist.data(),
 #endif
-                                       ::std::addressof(text))) [[unlikely]] {
+                                       ::std::addressof(text_obj), ::std::addressof(host_obj),
+                                       ::std::addressof(as_bytes))) [[unlikely]] {
         return nullptr;
     }
-    char8_t const* html = ::pltxt2htm::common_parser<
-#ifdef NDEBUG
-        true
-#else
-        false
-#endif
-        >(reinterpret_cast<char8_t const*>(text));
-    ::PyObject* result = ::PyUnicode_FromString(reinterpret_cast<char const*>(html));
-    ::free(reinterpret_cast<void*>(const_cast<char8_t*>(html)));
+    ::Utf8Arg text{};
+    ::Utf8Arg host{};
+    if (!text.init(text_obj, "argument `text`") || !host.init(host_obj, "argument `host`")) [[unlikely]] {
+        return nullptr;
+    }
+    return ::html_object(
+        [&text, &host] {
+            return ::pltxt2htm::details::advanced_html_render<::ndebug, escape_less_than>(text.text(), host.text());
+        },
+        text.is_ascii() && host.is_ascii(), as_bytes != 0);
+}
+
+/**
+ * @brief Python object of the rendered html, the html is copied into it.
+ */
+::PyObject* html_object(::fast_io::u8string const& html, bool is_ascii, bool as_bytes) noexcept {
+    auto const data = reinterpret_cast<char const*>(html.data());
+    auto const size = static_cast<::Py_ssize_t>(html.size());
+    if (as_bytes) {
+        return ::PyBytes_FromStringAndSize(data, size);
+    } else if (is_ascii) {
+        ::PyObject* result = ::PyUnicode_New(size, 127);
+        if (result != nullptr) [[likely]] {
+            ::std::memcpy(PyUnicode_1BYTE_DATA(result), data, html.size());
+        }
+        return result;
+    } else {
+        return ::PyUnicode_DecodeUTF8(data, size, nullptr);
+    }
+}
+
+/**
+ * @brief Convert a sequence of texts to a list of html on the pool of threads of `::pltxt2htm::convert_batch`.
+ * @param threads_obj: Number of threads, None or nullptr for the number of cpus
+ * @param html: Which html the texts are rendered to, `host` is ignored by common html
+ * @param optimize: Whether optimize the ast, the same as the corresponding non-batch function
+ */
+::PyObject* batch_object(::PyObject* texts_obj, ::PyObject* threads_obj, ::fast_io::u8string_view host,
+                         bool host_is_ascii, bool as_bytes, ::pltxt2htm::BatchHtml html, bool optimize)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif // __cpp_exceptions < 199711L
+{
+    ::std::size_t threads{};
+    if (threads_obj != nullptr && threads_obj != Py_None) {
+        auto const value = ::PyLong_AsSsize_t(threads_obj);
+        if (value == -1 && ::PyErr_Occurred()) [[unlikely]] {
+            return nullptr;
+        }
+        if (value < 1) [[unlikely]] {
+            ::PyErr_SetString(PyExc_ValueError, "argument `threads` must be positive");
+            return nullptr;
+        }
+        threads = static_cast<::std::size_t>(value);
+    }
+
+    // a tuple holds the texts, even if the sequence is modified by other threads
+    ::PyObject* texts_tuple = ::PySequence_Tuple(texts_obj);
+    if (texts_tuple == nullptr) [[unlikely]] {
+        return nullptr;
+    }
+    auto const size = static_cast<::std::size_t>(PyTuple_GET_SIZE(texts_tuple));
+    ::std::unique_ptr<::Utf8Arg[]> texts{new ::Utf8Arg[size]};
+    for (::std::size_t i{}; i < size; ++i) {
+        if (!texts[i].init(PyTuple_GET_ITEM(texts_tuple, i), "item of `texts`")) [[unlikely]] {
+            Py_DECREF(texts_tuple);
+            return nullptr;
+        }
+    }
+
+    ::fast_io::vector<::fast_io::u8string_view> pltexts{};
+    pltexts.reserve(size);
+    for (::std::size_t i{}; i < size; ++i) {
+        pltexts.push_back(texts[i].text());
+    }
+    // the workers copy each html into the buffer of its index, the python objects are built after taking the GIL
+    ::fast_io::vector<::fast_io::u8string> htmls(size);
+    ::PyThreadState* thread_state = ::PyEval_SaveThread();
+    ::pltxt2htm::details::run_batch<::ndebug>(
+        ::std::span<::fast_io::u8string_view const>{pltexts.data(), pltexts.size()}, host,
+        ::pltxt2htm::BatchOptions{.html = html, .optimize = optimize, .threads = threads},
+        [&htmls](::std::size_t index, ::fast_io::u8string_view html_view) {
+            htmls.index_unchecked(index).append(html_view);
+        });
+    ::PyEval_RestoreThread(thread_state);
+
+    ::PyObject* result = ::PyList_New(static_cast<::Py_ssize_t>(size));
+    if (result == nullptr) [[unlikely]] {
+        Py_DECREF(texts_tuple);
+        return nullptr;
+    }
+    for (::std::size_t i{}; i < size; ++i) {
+        ::PyObject* html_obj = ::html_object(htmls.index_unchecked(i), texts[i].is_ascii() && host_is_ascii, as_bytes);
+        if (html_obj == nullptr) [[unlikely]] {
+            Py_DECREF(result);
+            Py_DECREF(texts_tuple);
+            return nullptr;
+        }
+        PyList_SET_ITEM(result, static_cast<::Py_ssize_t>(i), html_obj);
+    }
+    Py_DECREF(texts_tuple);
     return result;
 }
 
-static ::PyObject* advanced_parser([[maybe_unused]] ::PyObject* self, ::PyObject* args, ::PyObject* kwargs)
+template<bool escape_less_than>
+::PyObject* advanced_html_batch(::PyObject* args, ::PyObject* kwargs)
 #if __cpp_exceptions < 199711L
     noexcept
 #endif // __cpp_exceptions < 199711L
 {
-    static auto kwlist = ::fast_io::array{"text", "host", nullptr};
-#ifndef NDEBUG
-    char8_t const* text = nullptr;
-    char8_t const* host = nullptr;
-#else
-    #if __has_cpp_attribute(indeterminate)
-    char8_t const* text [[indeterminate]];
-    char8_t const* host [[indeterminate]];
-    #else
-    char8_t const* text;
-    char8_t const* host;
-    #endif
-#endif
+    static auto kwlist = ::fast_io::array{"texts", "host", "threads", "as_bytes", nullptr};
+    ::PyObject* texts_obj = nullptr;
+    ::PyObject* host_obj = nullptr;
+    ::PyObject* threads_obj = nullptr;
+    int as_bytes{};
     // Before python3.13, argument `keywords` does not marked as const
-    if (!::PyArg_ParseTupleAndKeywords(args, kwargs, "ss",
+    if (!::PyArg_ParseTupleAndKeywords(args, kwargs, "OO|O$p",
 #if PY_MINOR_VERSION < 13
                                        const_cast<char**>(kwlist.data()),
 #else
                                        kwlist.data(),
 #endif
-                                       ::std::addressof(text), ::std::addressof(host))) [[unlikely]] {
+                                       ::std::addressof(texts_obj), ::std::addressof(host_obj),
+                                       ::std::addressof(threads_obj), ::std::addressof(as_bytes))) [[unlikely]] {
         return nullptr;
     }
-    char8_t const* html = ::pltxt2htm::advanced_parser<
-#ifdef NDEBUG
-        true
+    ::Utf8Arg host{};
+    if (!host.init(host_obj, "argument `host`")) [[unlikely]] {
+        return nullptr;
+    }
+    return ::batch_object(texts_obj, threads_obj, host.text(), host.is_ascii(), as_bytes != 0,
+                          escape_less_than ? ::pltxt2htm::BatchHtml::advanced : ::pltxt2htm::BatchHtml::fixedadv,
+                          true);
+}
+
+} // namespace
+
+static ::PyObject* common_parser([[maybe_unused]] ::PyObject* self, ::PyObject* args, ::PyObject* kwargs)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif // __cpp_exceptions < 199711L
+{
+    static auto kwlist = ::fast_io::array{"text", "as_bytes", nullptr};
+    ::PyObject* text_obj = nullptr;
+    int as_bytes{};
+    // Before python3.13, argument `keywords` does not marked as const
+    if (!::PyArg_ParseTupleAndKeywords(args, kwargs, "O|$p",
+#if PY_MINOR_VERSION < 13
+                                       const_cast<char**>(kwlist.data()),
 #else
-        false
+                                       kwlist.data(),
 #endif
-        >(reinterpret_cast<char8_t const*>(text), reinterpret_cast<char8_t const*>(host));
-    ::PyObject* result = ::PyUnicode_FromString(reinterpret_cast<char const*>(html));
-    ::free(static_cast<void*>(const_cast<char8_t*>(html)));
-    return result;
+                                       ::std::addressof(text_obj), ::std::addressof(as_bytes))) [[unlikely]] {
+        return nullptr;
+    }
+    ::Utf8Arg text{};
+    if (!text.init(text_obj, "argument `text`")) [[unlikely]] {
+        return nullptr;
+    }
+    return ::html_object([&text] { return ::pltxt2htm::details::common_html_render<::ndebug>(text.text()); },
+                         text.is_ascii(), as_bytes != 0);
+}
+
+static ::PyObject* advanced_parser([[maybe_unused]] ::PyObject* self, ::PyObject* args, ::PyObject* kwargs)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif // __cpp_exceptions < 199711L
+{
+    return ::advanced_html<true>(args, kwargs);
 }
 
 static ::PyObject* fixedadv_parser([[maybe_unused]] ::PyObject* self, ::PyObject* args, ::PyObject* kwargs)
@@ -86,39 +344,47 @@ static ::PyObject* fixedadv_parser([[maybe_unused]] ::PyObject* self, ::PyObject
     noexcept
 #endif // __cpp_exceptions < 199711L
 {
-    static auto kwlist = ::fast_io::array{"text", "host", nullptr};
-#ifndef NDEBUG
-    char8_t const* text = nullptr;
-    char8_t const* host = nullptr;
-#else
-    #if __has_cpp_attribute(indeterminate)
-    char8_t const* text [[indeterminate]];
-    char8_t const* host [[indeterminate]];
-    #else
-    char8_t const* text;
-    char8_t const* host;
-    #endif
-#endif
+    return ::advanced_html<false>(args, kwargs);
+}
+
+static ::PyObject* common_parser_batch([[maybe_unused]] ::PyObject* self, ::PyObject* args, ::PyObject* kwargs)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif // __cpp_exceptions < 199711L
+{
+    static auto kwlist = ::fast_io::array{"texts", "threads", "as_bytes", nullptr};
+    ::PyObject* texts_obj = nullptr;
+    ::PyObject* threads_obj = nullptr;
+    int as_bytes{};
     // Before python3.13, argument `keywords` does not marked as const
-    if (!::PyArg_ParseTupleAndKeywords(args, kwargs, "ss",
+    if (!::PyArg_ParseTupleAndKeywords(args, kwargs, "O|O$p",
 #if PY_MINOR_VERSION < 13
                                        const_cast<char**>(kwlist.data()),
 #else
                                        kwlist.data(),
 #endif
-                                       ::std::addressof(text), ::std::addressof(host))) [[unlikely]] {
+                                       ::std::addressof(texts_obj), ::std::addressof(threads_obj),
+                                       ::std::addressof(as_bytes))) [[unlikely]] {
         return nullptr;
     }
-    char8_t const* html = ::pltxt2htm::fixedadv_parser<
-#ifdef NDEBUG
-        true
-#else
-        false
-#endif
-        >(reinterpret_cast<char8_t const*>(text), reinterpret_cast<char8_t const*>(host));
-    ::PyObject* result = ::PyUnicode_FromString(reinterpret_cast<char const*>(html));
-    ::free(static_cast<void*>(const_cast<char8_t*>(html)));
-    return result;
+    return ::batch_object(texts_obj, threads_obj, ::fast_io::u8string_view{}, true, as_bytes != 0,
+                          ::pltxt2htm::BatchHtml::common, false);
+}
+
+static ::PyObject* advanced_parser_batch([[maybe_unused]] ::PyObject* self, ::PyObject* args, ::PyObject* kwargs)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif // __cpp_exceptions < 199711L
+{
+    return ::advanced_html_batch<true>(args, kwargs);
+}
+
+static ::PyObject* fixedadv_parser_batch([[maybe_unused]] ::PyObject* self, ::PyObject* args, ::PyObject* kwargs)
+#if __cpp_exceptions < 199711L
+    noexcept
+#endif // __cpp_exceptions < 199711L
+{
+    return ::advanced_html_batch<false>(args, kwargs);
 }
 
 static auto methods_ = ::fast_io::array{
@@ -129,30 +395,53 @@ static auto methods_ = ::fast_io::array{
                   nullptr},
     ::PyMethodDef{"fixedadv_parser", reinterpret_cast<PyCFunction>(::fixedadv_parser), METH_VARARGS | METH_KEYWORDS,
                   nullptr},
+    ::PyMethodDef{"common_parser_batch", reinterpret_cast<PyCFunction>(::common_parser_batch),
+                  METH_VARARGS | METH_KEYWORDS, nullptr},
+    ::PyMethodDef{"advanced_parser_batch", reinterpret_cast<PyCFunction>(::advanced_parser_batch),
+                  METH_VARARGS | METH_KEYWORDS, nullptr},
+    ::PyMethodDef{"fixedadv_parser_batch", reinterpret_cast<PyCFunction>(::fixedadv_parser_batch),
+                  METH_VARARGS | METH_KEYWORDS, nullptr},
     ::PyMethodDef{nullptr, nullptr, 0, nullptr}};
 
+static int exec_module(::PyObject* m) noexcept {
+    ::PyObject* version =
+        ::PyTuple_Pack(3, ::PyLong_FromLong(::pltxt2htm::version::major),
+                       ::PyLong_FromLong(::pltxt2htm::version::minor), ::PyLong_FromLong(::pltxt2htm::version::patch));
+    if (version == nullptr) [[unlikely]] {
+        return -1;
+    }
+    if (::PyModule_AddObject(m, "__version__", version) != 0) [[unlikely]] {
+        Py_DECREF(version);
+        return -1;
+    }
+    return 0;
+}
+
+static auto slots_ = ::fast_io::array{
+    ::PyModuleDef_Slot{Py_mod_exec, reinterpret_cast<void*>(::exec_module)},
+#ifdef Py_mod_multiple_interpreters
+    // the module has no global state
+    ::PyModuleDef_Slot{Py_mod_multiple_interpreters, Py_MOD_PER_INTERPRETER_GIL_SUPPORTED},
+#endif
+#ifdef Py_mod_gil
+    // conversions run in parallel on free-threaded python
+    ::PyModuleDef_Slot{Py_mod_gil, Py_MOD_GIL_NOT_USED},
+#endif
+    ::PyModuleDef_Slot{0, nullptr}};
+
 static ::PyModuleDef pltxt2htm_py_module = {
     .m_base = PyModuleDef_HEAD_INIT,
     .m_name = "pltxt2htm",
     .m_doc = "Parse Quantam-Physics's text to html",
     /* size of per-interpreter state of the module, or -1 if the module keeps state in global variables. */
-    .m_size = -1,
+    .m_size = 0,
     .m_methods = ::methods_.data(),
-    .m_slots = nullptr,
+    .m_slots = ::slots_.data(),
     .m_traverse = nullptr,
     .m_clear = nullptr,
     .m_free = nullptr};
 
 PyMODINIT_FUNC PyInit_pltxt2htm() noexcept {
-    ::PyObject* m = PyModule_Create(::std::addressof(::pltxt2htm_py_module));
-    if (m == nullptr) [[unlikely]] {
-        return nullptr;
-    }
-
-    ::PyModule_AddObject(
-        m, "__version__",
-        ::PyTuple_Pack(3, ::PyLong_FromLong(::pltxt2htm::version::major),
-                       ::PyLong_FromLong(::pltxt2htm::version::minor), ::PyLong_FromLong(::pltxt2htm::version::patch)));
-
-    return m;
+    // multi-phase initialization, the module is created by python and initialized by `exec_module`
+    return ::PyModuleDef_Init(::std::addressof(::pltxt2htm_py_module));
 }
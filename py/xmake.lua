@@ -16,6 +16,10 @@ target("pltxt2htm", function ()
     if is_plat("windows", "mingw") then
         add_links("ntdll")
     end
+    if is_plat("linux", "bsd") then
+        -- threads of the batch api
+        add_syslinks("pthread")
+    end
 
     local python = nil
     on_config(function (target)
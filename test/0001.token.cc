@@ -1,7 +1,7 @@
 #include <concepts>
 #include <type_traits>
 #include <fast_io/fast_io_dsal/vector.h>
-#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
 #include <exception/exception.hh>
 #include <pltxt2htm/astnode/node_type.hh>
 #include <pltxt2htm/astnode/physics_lab_node.hh>
@@ -18,9 +18,9 @@ int main() {
 
     ::fast_io::vector<::pltxt2htm::PlTxtNode> arr{
         ::pltxt2htm::U8Char{u8'a'},
-        ::pltxt2htm::Color{::pltxt2htm::Ast(text), ::fast_io::u8string{u8"red"}},
-        ::pltxt2htm::Experiment{::pltxt2htm::Ast(text), ::fast_io::u8string{u8"123"}},
-        ::pltxt2htm::Discussion{::pltxt2htm::Ast(text), ::fast_io::u8string{u8"123"}},
+        ::pltxt2htm::Color{::pltxt2htm::Ast(text), ::fast_io::u8string_view{u8"red"}},
+        ::pltxt2htm::Experiment{::pltxt2htm::Ast(text), ::fast_io::u8string_view{u8"123"}},
+        ::pltxt2htm::Discussion{::pltxt2htm::Ast(text), ::fast_io::u8string_view{u8"123"}},
     };
 
     ::exception::assert_true(arr[0].node_type() == ::pltxt2htm::NodeType::u8char);
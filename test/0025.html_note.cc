@@ -1,5 +1,27 @@
+#include <pltxt2htm/pltxt2htm.hh>
 #include "precompile.hh"
 
+namespace {
+
+/**
+ * @brief Text of the comment kept in the Note of `pltext`, which is a single comment.
+ */
+template<bool keep_comments>
+::fast_io::u8string_view note_body(::fast_io::u8string_view pltext) noexcept {
+    auto const ast = ::pltxt2htm::parse_pltxt<false, keep_comments>(pltext);
+    ::pltxt2htm_test::assert_true(ast.size() == 1);
+    auto const note = ast.index_unchecked(0).release_imul();
+    ::pltxt2htm_test::assert_true(note->node_type() == ::pltxt2htm::NodeType::html_note);
+    auto const& subast = static_cast<::pltxt2htm::Note const*>(note)->get_subast();
+    if (subast.empty()) {
+        return {};
+    }
+    ::pltxt2htm_test::assert_true(subast.size() == 1);
+    return static_cast<::pltxt2htm::TextRun const*>(subast.index_unchecked(0).release_imul())->get_text();
+}
+
+} // namespace
+
 int main() {
     auto html1 = ::pltxt2htm_test::pltxt2common_htmld(u8"t<!--es-->t");
     auto answer1 = ::fast_io::u8string_view{u8"tt"};
@@ -13,5 +35,28 @@ int main() {
     auto answer3 = ::fast_io::u8string_view{u8"t"};
     ::pltxt2htm_test::assert_true(html3 == answer3);
 
+    // `-->` at every offset of a long comment, across every simd block boundary
+    for (::std::size_t offset{}; offset < 200; ++offset) {
+        ::fast_io::u8string pltext{u8"a<!--"};
+        for (::std::size_t i{}; i < offset; ++i) {
+            // `-` and `>` which are not `-->`
+            pltext.push_back(i % 3 == 0 ? u8'-' : (i % 3 == 1 ? u8'>' : u8'x'));
+        }
+        pltext.append(::fast_io::u8string_view{u8"-->b-->"});
+        auto html = ::pltxt2htm_test::pltxt2advanced_htmld(::fast_io::u8string_view{pltext.data(), pltext.size()});
+        ::pltxt2htm_test::assert_true(html == u8"ab--&gt;");
+    }
+
+    // `<!-->` is not closed by its own hyphens
+    auto html4 = ::pltxt2htm_test::pltxt2common_htmld(u8"a<!-->b-->c<!--->d-->e");
+    ::pltxt2htm_test::assert_true(html4 == u8"ace");
+
+    // the body is only kept if asked, the empty Note is kept either way
+    ::pltxt2htm_test::assert_true(note_body<true>(u8"<!-- body -->") == u8" body ");
+    ::pltxt2htm_test::assert_true(note_body<true>(u8"<!-- unclosed") == u8" unclosed");
+    ::pltxt2htm_test::assert_true(note_body<false>(u8"<!-- body -->").empty());
+    auto html5 = ::pltxt2htm_test::pltxt2advanced_htmld(u8"<b><!-- body --></b>");
+    ::pltxt2htm_test::assert_true(html5 == u8"<strong></strong>");
+
     return 0;
 }
@@ -0,0 +1,35 @@
+#include "precompile.hh"
+
+int main() {
+    // control characters are dropped between two runs
+    auto html1 = ::pltxt2htm_test::pltxt2common_htmld(u8"中\x01文");
+    auto answer1 = ::fast_io::u8string_view{u8"中文"};
+    ::pltxt2htm_test::assert_true(html1 == answer1);
+
+    // invalid utf-8 bytes split runs
+    auto html2 = ::pltxt2htm_test::pltxt2common_htmld(u8"中\xe6文");
+    auto answer2 = ::fast_io::u8string_view{u8"中�文"};
+    ::pltxt2htm_test::assert_true(html2 == answer2);
+
+    // a backslash which is not an escape is a part of the run
+    auto html3 = ::pltxt2htm_test::pltxt2common_htmld(u8"中\\文");
+    auto answer3 = ::fast_io::u8string_view{u8"中\\文"};
+    ::pltxt2htm_test::assert_true(html3 == answer3);
+
+    // escapes split runs
+    auto html4 = ::pltxt2htm_test::pltxt2common_htmld(u8"中\\*文");
+    auto answer4 = ::fast_io::u8string_view{u8"中*文"};
+    ::pltxt2htm_test::assert_true(html4 == answer4);
+
+    // runs inside and outside of tags
+    auto html5 = ::pltxt2htm_test::pltxt2advanced_htmld(u8"物理<b>实验</b>室");
+    auto answer5 = ::fast_io::u8string_view{u8"物理<strong>实验</strong>室"};
+    ::pltxt2htm_test::assert_true(html5 == answer5);
+
+    // an unclosed tag keeps its text
+    auto html6 = ::pltxt2htm_test::pltxt2advanced_htmld(u8"物理<i>实验室");
+    auto answer6 = ::fast_io::u8string_view{u8"物理<em>实验室</em>"};
+    ::pltxt2htm_test::assert_true(html6 == answer6);
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <exception/exception.hh>
+#include <pltxt2htm/parser.hh>
+#include <pltxt2htm/optimizer.hh>
+#include <pltxt2htm/flat_ast.hh>
+#include <pltxt2htm/backend/advanced_html.hh>
+#include <pltxt2htm/backend/common_html.hh>
+
+int main() {
+    ::fast_io::u8string_view const pltext{u8"物理<color=red>实验<b>室</b></color>\n"};
+    auto const ast = ::pltxt2htm::parse_pltxt<false>(pltext);
+    auto const flat_ast = ::pltxt2htm::flatten_ast<false>(ast);
+
+    // root, text_run, color, text_run, b, text_run, line_break
+    ::exception::assert_true(flat_ast.size() == 7);
+    ::exception::assert_true(flat_ast.node_type(0) == ::pltxt2htm::NodeType::base);
+    ::exception::assert_true(flat_ast.next_sibling(0) == ::pltxt2htm::FlatAst::npos);
+
+    auto const text1 = flat_ast.first_child(0);
+    ::exception::assert_true(flat_ast.node_type(text1) == ::pltxt2htm::NodeType::text_run);
+    ::exception::assert_true(flat_ast.get_str(text1) == ::fast_io::u8string_view{u8"物理"});
+
+    auto const color = flat_ast.next_sibling(text1);
+    ::exception::assert_true(flat_ast.node_type(color) == ::pltxt2htm::NodeType::pl_color);
+    ::exception::assert_true(flat_ast.get_str(color) == ::fast_io::u8string_view{u8"red"});
+
+    auto const text2 = flat_ast.first_child(color);
+    ::exception::assert_true(flat_ast.get_str(text2) == ::fast_io::u8string_view{u8"实验"});
+    auto const b = flat_ast.next_sibling(text2);
+    ::exception::assert_true(flat_ast.node_type(b) == ::pltxt2htm::NodeType::pl_b);
+    ::exception::assert_true(flat_ast.next_sibling(b) == ::pltxt2htm::FlatAst::npos);
+    auto const text3 = flat_ast.first_child(b);
+    ::exception::assert_true(flat_ast.get_str(text3) == ::fast_io::u8string_view{u8"室"});
+    ::exception::assert_true(flat_ast.first_child(text3) == ::pltxt2htm::FlatAst::npos);
+
+    auto const line_break = flat_ast.next_sibling(color);
+    ::exception::assert_true(flat_ast.node_type(line_break) == ::pltxt2htm::NodeType::line_break);
+    ::exception::assert_true(flat_ast.next_sibling(line_break) == ::pltxt2htm::FlatAst::npos);
+
+    // text is borrowed from the pl-text instead of being copied
+    ::exception::assert_true(flat_ast.get_str(text1).data() == pltext.data());
+    ::exception::assert_true(flat_ast.get_str(color).data() == pltext.data() + 13);
+
+    // copied strings outlive the FlatAst they are copied from
+    ::pltxt2htm::FlatAst copied{};
+    {
+        ::fast_io::u8string lang{u8"cpp"};
+        ::pltxt2htm::FlatAst code_fence{};
+        code_fence.push_node(::pltxt2htm::NodeType::base);
+        auto const index = code_fence.push_node_copy(::pltxt2htm::NodeType::md_code_fence,
+                                                     ::fast_io::u8string_view{lang.data(), lang.size()});
+        code_fence.link(0, ::pltxt2htm::FlatAst::npos, index);
+        copied = code_fence;
+    }
+    ::exception::assert_true(copied.get_str(copied.first_child(0)) == ::fast_io::u8string_view{u8"cpp"});
+
+    // rendering the ast and its FlatAst is the same
+    constexpr ::fast_io::u8string_view pltexts[]{
+        u8"物理<color=red>实验<b>室</b></color>\n",
+        u8"# title\n<experiment=642cf37a494746375aae306a>exp</experiment> <discussion=1>d</discussion>"
+        u8"<user=2>u</user><size=12>big</size><a>link</a>\n- - -\n\\*<i>&'\"<>\t</i><br><!-- note -->",
+        u8"<h1>a</h1><p>b<del>c</del><em>d</em><strong>e</strong></p><ul><li>f</li></ul><code>g</code><pre>h</pre>",
+        u8"<b></b><p></p><experiment=1></experiment>",
+    };
+    for (auto const text : pltexts) {
+        auto other_ast = ::pltxt2htm::parse_pltxt<false>(text);
+        ::pltxt2htm::optimize_ast<false>(other_ast);
+        auto const other_flat_ast = ::pltxt2htm::flatten_ast<false>(other_ast);
+        ::exception::assert_true(::pltxt2htm::details::ast2advanced_html<false>(other_ast, u8"localhost:5173") ==
+                                 ::pltxt2htm::details::ast2advanced_html<false>(other_flat_ast, u8"localhost:5173"));
+        ::exception::assert_true(
+            ::pltxt2htm::details::ast2advanced_html<false, false>(other_ast, u8"localhost:5173") ==
+            ::pltxt2htm::details::ast2advanced_html<false, false>(other_flat_ast, u8"localhost:5173"));
+        ::exception::assert_true(::pltxt2htm::details::ast2common_html<false>(other_ast) ==
+                                 ::pltxt2htm::details::ast2common_html<false>(other_flat_ast));
+    }
+
+    return 0;
+}
@@ -0,0 +1,26 @@
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <exception/exception.hh>
+#include <pltxt2htm/parser.hh>
+
+int main() {
+    ::fast_io::u8string_view const pltext{u8"<color=red  >a</color><Experiment=642cf37a>b</Experiment><a>c</a>"};
+    auto const ast = ::pltxt2htm::parse_pltxt<false>(pltext);
+    ::exception::assert_true(ast.size() == 3);
+
+    // attributes are views of the pl-text
+    auto const color = reinterpret_cast<::pltxt2htm::Color const*>(ast.index_unchecked(0).release_imul());
+    ::exception::assert_true(color->node_type() == ::pltxt2htm::NodeType::pl_color);
+    ::exception::assert_true(color->get_color() == ::fast_io::u8string_view{u8"red"});
+    ::exception::assert_true(color->get_color().data() == pltext.data() + 7);
+
+    auto const experiment = reinterpret_cast<::pltxt2htm::Experiment const*>(ast.index_unchecked(1).release_imul());
+    ::exception::assert_true(experiment->node_type() == ::pltxt2htm::NodeType::pl_experiment);
+    ::exception::assert_true(experiment->get_id() == ::fast_io::u8string_view{u8"642cf37a"});
+    ::exception::assert_true(experiment->get_id().data() == pltext.data() + 34);
+
+    auto const a = reinterpret_cast<::pltxt2htm::A const*>(ast.index_unchecked(2).release_imul());
+    ::exception::assert_true(a->node_type() == ::pltxt2htm::NodeType::pl_a);
+    ::exception::assert_true(a->get_color() == ::fast_io::u8string_view{u8"#0000AA"});
+
+    return 0;
+}
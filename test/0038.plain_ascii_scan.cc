@@ -0,0 +1,28 @@
+#include "precompile.hh"
+
+int main() {
+    // a special char at every offset of a long plain run, across every simd block boundary
+    for (::std::size_t offset{}; offset < 200; ++offset) {
+        ::fast_io::u8string pltext(offset, u8'a');
+        pltext.append(::fast_io::u8string_view{u8"<b>x&y\\"});
+        pltext.append(::fast_io::u8string(offset, u8'z'));
+        pltext.push_back(u8'\x01');
+        pltext.append(::fast_io::u8string(offset, u8'q'));
+
+        ::fast_io::u8string answer(offset, u8'a');
+        answer.append(::fast_io::u8string_view{u8"<strong>x&amp;y\\"});
+        answer.append(::fast_io::u8string(offset, u8'z'));
+        answer.append(::fast_io::u8string(offset, u8'q'));
+        answer.append(::fast_io::u8string_view{u8"</strong>"});
+
+        auto html = ::pltxt2htm_test::pltxt2advanced_htmld(::fast_io::u8string_view{pltext.data(), pltext.size()});
+        ::pltxt2htm_test::assert_true(html == ::fast_io::u8string_view{answer.data(), answer.size()});
+    }
+
+    // bytes above 0x7e end a plain run
+    auto html1 = ::pltxt2htm_test::pltxt2common_htmld(u8"abcdefghijklmnopqrstuvwxyz0123456789\x7f物理");
+    auto answer1 = ::fast_io::u8string_view{u8"abcdefghijklmnopqrstuvwxyz0123456789物理"};
+    ::pltxt2htm_test::assert_true(html1 == answer1);
+
+    return 0;
+}
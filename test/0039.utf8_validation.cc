@@ -0,0 +1,42 @@
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <exception/exception.hh>
+#include <pltxt2htm/scanner.hh>
+
+int main() {
+    ::exception::assert_true(::pltxt2htm::details::is_valid_utf8(u8""));
+    ::exception::assert_true(::pltxt2htm::details::is_valid_utf8(u8"Hello\x01\x7f"));
+    ::exception::assert_true(::pltxt2htm::details::is_valid_utf8(u8"café 中文 😊 \xc2\x85"));
+    ::exception::assert_true(::pltxt2htm::details::is_valid_utf8(u8"\xf4\x8f\xbf\xbf"));
+
+    // truncated sequences
+    ::exception::assert_true(!::pltxt2htm::details::is_valid_utf8(u8"\xc3"));
+    ::exception::assert_true(!::pltxt2htm::details::is_valid_utf8(u8"\xe2\x82"));
+    ::exception::assert_true(!::pltxt2htm::details::is_valid_utf8(u8"\xf0\x9f\x98"));
+    // stray continuation bytes
+    ::exception::assert_true(!::pltxt2htm::details::is_valid_utf8(u8"\x80"));
+    ::exception::assert_true(!::pltxt2htm::details::is_valid_utf8(u8"\xc3\xa9\xa9"));
+    // overlong encodings
+    ::exception::assert_true(!::pltxt2htm::details::is_valid_utf8(u8"\xc0\x80"));
+    ::exception::assert_true(!::pltxt2htm::details::is_valid_utf8(u8"\xe0\x80\x80"));
+    ::exception::assert_true(!::pltxt2htm::details::is_valid_utf8(u8"\xf0\x80\x80\x80"));
+    // surrogates and code points above U+10FFFF
+    ::exception::assert_true(!::pltxt2htm::details::is_valid_utf8(u8"\xed\xa0\x80"));
+    ::exception::assert_true(!::pltxt2htm::details::is_valid_utf8(u8"\xf4\x90\x80\x80"));
+    ::exception::assert_true(!::pltxt2htm::details::is_valid_utf8(u8"\xf8\x88\x80\x80\x80"));
+
+    // an invalid byte at every offset of a long text, across every simd block boundary
+    for (::std::size_t offset{}; offset < 200; ++offset) {
+        ::fast_io::u8string text(offset, u8'a');
+        text.append(::fast_io::u8string_view{u8"中文"});
+        ::fast_io::u8string_view const valid_text{text.data(), text.size()};
+        ::exception::assert_true(::pltxt2htm::details::is_valid_utf8(valid_text));
+
+        text.push_back(u8'\xe6');
+        text.append(::fast_io::u8string(offset, u8'b'));
+        ::fast_io::u8string_view const invalid_text{text.data(), text.size()};
+        ::exception::assert_true(!::pltxt2htm::details::is_valid_utf8(invalid_text));
+    }
+
+    return 0;
+}
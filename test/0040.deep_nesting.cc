@@ -0,0 +1,59 @@
+#include "precompile.hh"
+
+int main() {
+    // nesting around and far beyond the inline capacity of the frame stacks
+    for (::std::size_t depth : {1, 15, 16, 17, 33, 100}) {
+        ::fast_io::u8string pltext{};
+        ::fast_io::u8string unclosed_pltext{};
+        ::fast_io::u8string answer{};
+        for (::std::size_t i{}; i < depth; ++i) {
+            pltext.append(::fast_io::u8string_view{u8"<b><i>"});
+            answer.append(::fast_io::u8string_view{u8"<strong><em>"});
+        }
+        unclosed_pltext = pltext;
+        pltext.push_back(u8'x');
+        unclosed_pltext.push_back(u8'x');
+        answer.push_back(u8'x');
+        for (::std::size_t i{}; i < depth; ++i) {
+            pltext.append(::fast_io::u8string_view{u8"</i></b>"});
+            answer.append(::fast_io::u8string_view{u8"</em></strong>"});
+        }
+        ::fast_io::u8string_view const answer_view{answer.data(), answer.size()};
+
+        auto html = ::pltxt2htm_test::pltxt2advanced_htmld(::fast_io::u8string_view{pltext.data(), pltext.size()});
+        ::pltxt2htm_test::assert_true(html == answer_view);
+        auto html1 = ::pltxt2htm_test::pltxt2common_htmld(::fast_io::u8string_view{pltext.data(), pltext.size()});
+        ::pltxt2htm_test::assert_true(html1 == answer_view);
+        // tags without closing tag are closed at the end of the text
+        auto html2 = ::pltxt2htm_test::pltxt2advanced_htmld(
+            ::fast_io::u8string_view{unclosed_pltext.data(), unclosed_pltext.size()});
+        ::pltxt2htm_test::assert_true(html2 == answer_view);
+    }
+
+    // the ast of nesting far beyond the call stack is destroyed without limits
+    {
+        constexpr ::std::size_t depth{200000};
+        ::fast_io::u8string pltext{};
+        ::fast_io::u8string answer{};
+        for (::std::size_t i{}; i < depth; ++i) {
+            pltext.append(::fast_io::u8string_view{u8"<ul><li>"});
+            answer.append(::fast_io::u8string_view{u8"<ul><li>"});
+        }
+        pltext.push_back(u8'x');
+        answer.push_back(u8'x');
+        for (::std::size_t i{}; i < depth; ++i) {
+            answer.append(::fast_io::u8string_view{u8"</li></ul>"});
+        }
+        ::fast_io::u8string_view const pltext_view{pltext.data(), pltext.size()};
+
+        auto html = ::pltxt2htm_test::pltxt2advanced_htmld(pltext_view);
+        ::pltxt2htm_test::assert_true(html == ::fast_io::u8string_view{answer.data(), answer.size()});
+        auto html1 = ::pltxt2htm_test::pltxt2fixedadv_htmld(pltext_view);
+        ::pltxt2htm_test::assert_true(html1 == ::fast_io::u8string_view{answer.data(), answer.size()});
+        // lists are not rendered by common html
+        auto html2 = ::pltxt2htm_test::pltxt2common_htmld(pltext_view);
+        ::pltxt2htm_test::assert_true(html2 == u8"x");
+    }
+
+    return 0;
+}
@@ -0,0 +1,29 @@
+#include "precompile.hh"
+
+int main() {
+    // tag names are case insensitive, closing tags are matched word by word
+    auto html1 = ::pltxt2htm_test::pltxt2advanced_htmld(u8"<STRONG>a</sTrOnG><Del>b</DEL><H6>c</h6>");
+    auto answer1 = ::fast_io::u8string_view{u8"<strong>a</strong><del>b</del><h6>c</h6>"};
+    ::pltxt2htm_test::assert_true(html1 == answer1);
+
+    // digits are not case folded, control chars are dropped
+    auto html2 = ::pltxt2htm_test::pltxt2advanced_htmld(u8"<h\x11>x");
+    auto answer2 = ::fast_io::u8string_view{u8"&lt;h&gt;x"};
+    ::pltxt2htm_test::assert_true(html2 == answer2);
+
+    // names sharing a prefix or a word with a tag name are not tags
+    auto html3 = ::pltxt2htm_test::pltxt2advanced_htmld(u8"<bb><experimen=1><experiments=1><discussio=1>");
+    auto answer3 = ::fast_io::u8string_view{u8"&lt;bb&gt;&lt;experimen=1&gt;&lt;experiments=1&gt;&lt;discussio=1&gt;"};
+    ::pltxt2htm_test::assert_true(html3 == answer3);
+
+    // tags at the very end of the text, where less than a word is left
+    auto html4 = ::pltxt2htm_test::pltxt2advanced_htmld(u8"<i>x</i>");
+    auto answer4 = ::fast_io::u8string_view{u8"<em>x</em>"};
+    ::pltxt2htm_test::assert_true(html4 == answer4);
+    auto html5 = ::pltxt2htm_test::pltxt2advanced_htmld(u8"<Discussion=ab1>x</DISCUSSION>");
+    auto answer5 = ::fast_io::u8string_view{
+        u8"<a href=\"localhost:5173/ExperimentSummary/Discussion/ab1\" internal>x</a>"};
+    ::pltxt2htm_test::assert_true(html5 == answer5);
+
+    return 0;
+}
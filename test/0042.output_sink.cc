@@ -0,0 +1,49 @@
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <exception/exception.hh>
+#include <pltxt2htm/pltxt2htm.hh>
+
+int main() {
+    ::fast_io::u8string_view const pltext{u8"<b>物理</b><color=red>实验</color><experiment=123>室</experiment>\n<i>x</i>"};
+    auto const answer = ::pltxt2htm::pltxt2advanced_html(pltext, u8"localhost:5173");
+    ::fast_io::u8string_view const answer_view{answer.data(), answer.size()};
+
+    // the html is appended to the string, its capacity is reused by the next call
+    ::fast_io::u8string buffer{};
+    ::pltxt2htm::pltxt2advanced_html(pltext, u8"localhost:5173", buffer);
+    ::exception::assert_true(::fast_io::u8string_view{buffer.data(), buffer.size()} == answer_view);
+    auto const capacity = buffer.capacity();
+    buffer.clear();
+    ::pltxt2htm::pltxt2advanced_html(pltext, u8"localhost:5173", buffer);
+    ::exception::assert_true(::fast_io::u8string_view{buffer.data(), buffer.size()} == answer_view);
+    ::exception::assert_true(buffer.capacity() == capacity);
+    ::pltxt2htm::pltxt2common_html(u8"y", buffer);
+    ::exception::assert_true(buffer.size() == answer.size() + 1 && buffer.back() == u8'y');
+
+    // fast_io output stream
+    ::fast_io::u8string streamed{};
+    ::fast_io::u8ostring_ref_fast_io stream{__builtin_addressof(streamed)};
+    ::pltxt2htm::pltxt2fixedadv_html(pltext, u8"localhost:5173", stream);
+    auto const fixedadv_answer = ::pltxt2htm::pltxt2fixedadv_html(pltext, u8"localhost:5173");
+    ::exception::assert_true(::fast_io::u8string_view{streamed.data(), streamed.size()} ==
+                             ::fast_io::u8string_view{fixedadv_answer.data(), fixedadv_answer.size()});
+
+    // callback, documents longer than the buffer of the sink are passed in several pieces
+    ::fast_io::u8string long_pltext{};
+    for (::std::size_t i{}; i < 1000; ++i) {
+        long_pltext.append(::fast_io::u8string_view{u8"<b>a</b>&"});
+    }
+    ::fast_io::u8string_view const long_pltext_view{long_pltext.data(), long_pltext.size()};
+    ::fast_io::u8string collected{};
+    ::std::size_t pieces{};
+    ::pltxt2htm::pltxt2common_html(long_pltext_view, [&collected, &pieces](::fast_io::u8string_view str) {
+        collected.append(str);
+        ++pieces;
+    });
+    auto const common_answer = ::pltxt2htm::pltxt2common_html(long_pltext_view);
+    ::exception::assert_true(::fast_io::u8string_view{collected.data(), collected.size()} ==
+                             ::fast_io::u8string_view{common_answer.data(), common_answer.size()});
+    ::exception::assert_true(pieces > 1);
+
+    return 0;
+}
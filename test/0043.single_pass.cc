@@ -0,0 +1,89 @@
+#include <cstddef>
+#include <cstdint>
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <exception/exception.hh>
+#include <pltxt2htm/pltxt2htm.hh>
+
+namespace {
+
+::fast_io::u8string_view view(::fast_io::u8string const& str) noexcept {
+    return ::fast_io::u8string_view{str.data(), str.size()};
+}
+
+/**
+ * @brief The single pass renderer must write the same html as parse -> optimize -> render.
+ */
+void assert_same_html(::fast_io::u8string_view pltext) noexcept {
+    constexpr ::fast_io::u8string_view host{u8"localhost:5173"};
+    ::exception::assert_true(view(::pltxt2htm::pltxt2advanced_html<false, true, true>(pltext, host)) ==
+                             view(::pltxt2htm::pltxt2advanced_html<false, true>(pltext, host)));
+    ::exception::assert_true(view(::pltxt2htm::pltxt2advanced_html<false, false, true>(pltext, host)) ==
+                             view(::pltxt2htm::pltxt2advanced_html<false, false>(pltext, host)));
+    ::exception::assert_true(view(::pltxt2htm::pltxt2fixedadv_html<false, true, true>(pltext, host)) ==
+                             view(::pltxt2htm::pltxt2fixedadv_html<false, true>(pltext, host)));
+    ::exception::assert_true(view(::pltxt2htm::pltxt2common_html<false, false, true>(pltext)) ==
+                             view(::pltxt2htm::pltxt2common_html<false, false>(pltext)));
+    ::exception::assert_true(view(::pltxt2htm::pltxt2common_html<false, true, true>(pltext)) ==
+                             view(::pltxt2htm::pltxt2common_html<false, true>(pltext)));
+}
+
+} // namespace
+
+int main() {
+    // the quirks of optimize_ast
+    auto html1 = ::pltxt2htm::pltxt2advanced_html<false, true, true>(
+        u8"<color=red><color=blue>x</color></color><b><b>y</b></b><i></i><color=red><b></b></color>", u8"h");
+    ::exception::assert_true(view(html1) == u8"<span style=\"color:blue;\">x</span><strong>y</strong>");
+    auto html2 = ::pltxt2htm::pltxt2advanced_html<false, true, true>(u8"<p>a</p><b></b><b><b>z</b></b>", u8"h");
+    ::exception::assert_true(view(html2) == u8"<p>a</p><strong></strong><strong><strong>z</strong></strong>");
+    auto html3 = ::pltxt2htm::pltxt2advanced_html<false, true, true>(
+        u8"<size=12><size=14><size=14>q</size></size></size><a><a></a></a>", u8"h");
+    ::exception::assert_true(view(html3) ==
+                             u8"<span style=\"font-size:7px\">q</span><span style=\"color:#0000AA;\"></span>");
+
+    // corpus of the other tests
+    constexpr ::fast_io::u8string_view corpus[]{
+        u8"<b>物理</b><color=red>实验</color><experiment=123>室</experiment>\n<i>x</i>",
+        u8"<Discussion=ab1>x</DISCUSSION><STRONG>a</sTrOnG><Del>b</DEL><H6>c</h6>",
+        u8"# title\n<color=red><color=red>a</color>b</color>\n---\n<strong>unclosed",
+        u8"  ### <b>x</b> <br>rest<ul><li>1</li><li><code>2</code></li></ul><pre>\t</pre>",
+        u8"<user=u><user=u>a</user></user><user=u><user=v>b</user></user><size=1><size=1></size></size>",
+        u8"<!-- note --><b><!----></b><i>\\*\\_&<>'\"</i><color=#0000AA><a>x</a></color><hr>\xff\xfe",
+        u8"<experiment=1><experiment=2><experiment=2>x</experiment></experiment></experiment>",
+        u8"<a><color=blue><color=blue></color></color></a><color=x><color=y>a</color>\n</color>",
+        u8"<b><p>block</p><b>after</b></b><em><i>raw</i></em><h1>#</h1><del><del></del></del>",
+        u8"<color=red>## not heading\n<b>a\n# heading <b>b\nc",
+    };
+    for (auto const pltext : corpus) {
+        assert_same_html(pltext);
+    }
+
+    // deterministic tag soup, which nests, merges and leaves tags unclosed at random
+    constexpr ::fast_io::u8string_view atoms[]{
+        u8"<color=red>", u8"<color=blue>", u8"</color>", u8"<a>",      u8"</a>",   u8"<b>",     u8"</b>",
+        u8"<strong>",    u8"</strong>",    u8"<i>",      u8"</em>",    u8"<del>",  u8"</del>",  u8"<size=12>",
+        u8"</size>",     u8"<user=u>",     u8"</user>",  u8"<p>",      u8"</p>",   u8"<h3>",    u8"</h3>",
+        u8"<pre>",       u8"</pre>",       u8"x",        u8"\n",       u8"# ",     u8"---\n",   u8"<br>",
+        u8"<!--c-->",    u8"&",            u8"<experiment=e>", u8"</experiment>"};
+    ::std::uint_least32_t state{12345};
+    for (::std::size_t i{}; i < 20000; ++i) {
+        ::fast_io::u8string pltext{};
+        state = state * 1103515245 + 12345;
+        auto const length = (state >> 16) % 24;
+        for (::std::size_t j{}; j < length; ++j) {
+            state = state * 1103515245 + 12345;
+            pltext.append(atoms[(state >> 16) % (sizeof(atoms) / sizeof(atoms[0]))]);
+        }
+        assert_same_html(view(pltext));
+    }
+
+    // sink overload
+    ::fast_io::u8string collected{};
+    ::pltxt2htm::pltxt2advanced_html<false, true, true>(
+        corpus[0], u8"localhost:5173", [&collected](::fast_io::u8string_view str) { collected.append(str); });
+    ::exception::assert_true(view(collected) ==
+                             view(::pltxt2htm::pltxt2advanced_html<false>(corpus[0], u8"localhost:5173")));
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <cstddef>
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <exception/exception.hh>
+#include <pltxt2htm/pltxt2htm.hh>
+
+namespace {
+
+::fast_io::u8string_view view(::fast_io::u8string const& str) noexcept {
+    return ::fast_io::u8string_view{str.data(), str.size()};
+}
+
+/**
+ * @brief The measured size must equal the size of the rendered html, and measuring must not change the html.
+ */
+void assert_exact_size(::fast_io::u8string_view pltext, ::fast_io::u8string_view host) noexcept {
+    auto const advanced_html = ::pltxt2htm::pltxt2advanced_html<false>(pltext, host);
+    ::exception::assert_true(::pltxt2htm::advanced_html_size<false>(pltext, host) == advanced_html.size());
+    ::exception::assert_true(view(::pltxt2htm::pltxt2advanced_html<false, true, false, true>(pltext, host)) ==
+                             view(advanced_html));
+    ::exception::assert_true(view(::pltxt2htm::pltxt2advanced_html<false, true, true, true>(pltext, host)) ==
+                             view(advanced_html));
+    ::exception::assert_true(::pltxt2htm::advanced_html_size<false, false>(pltext, host) ==
+                             ::pltxt2htm::pltxt2advanced_html<false, false>(pltext, host).size());
+
+    auto const fixedadv_html = ::pltxt2htm::pltxt2fixedadv_html<false>(pltext, host);
+    ::exception::assert_true(::pltxt2htm::fixedadv_html_size<false>(pltext, host) == fixedadv_html.size());
+    ::exception::assert_true(view(::pltxt2htm::pltxt2fixedadv_html<false, true, false, true>(pltext, host)) ==
+                             view(fixedadv_html));
+
+    auto const common_html = ::pltxt2htm::pltxt2common_html<false>(pltext);
+    ::exception::assert_true(::pltxt2htm::common_html_size<false>(pltext) == common_html.size());
+    ::exception::assert_true(view(::pltxt2htm::pltxt2common_html<false, false, false, true>(pltext)) ==
+                             view(common_html));
+
+    // an ast which is measured and then rendered
+    auto ast = ::pltxt2htm::parse_pltxt<false>(pltext);
+    ::exception::assert_true(::pltxt2htm::common_html_size<false>(ast) == common_html.size());
+    ::pltxt2htm::optimize_ast<false>(ast);
+    ::exception::assert_true(::pltxt2htm::advanced_html_size<false>(ast, host) == advanced_html.size());
+    ::exception::assert_true(::pltxt2htm::advanced_html_size<false, false>(ast, host) == fixedadv_html.size());
+}
+
+} // namespace
+
+int main() {
+    assert_exact_size(u8"", u8"");
+    assert_exact_size(u8"<>&'\"\t  \n", u8"h");
+    // ids, host and the digits of font size
+    assert_exact_size(u8"<experiment=642cf37a>a</experiment><discussion=x>b</discussion><user=u>c</user>",
+                      u8"localhost:5173");
+    assert_exact_size(u8"<size=1>a</size><size=12345678901>b</size><color=#123456>c</color><a>d</a>", u8"");
+    assert_exact_size(u8"# 物理\n<b><i>实验</i></b><br><hr>\\*\\_---\n<!-- note --><p><del>x</del></p>\xff",
+                      u8"physics-lab.net");
+    assert_exact_size(u8"<color=red><color=red>merged</color></color><b><b></b></b><h1>unclosed", u8"h");
+
+    // the destination is allocated once, its size is exactly the html
+    auto const html = ::pltxt2htm::pltxt2advanced_html<false, true, false, true>(u8"a\tb", u8"h");
+    ::exception::assert_true(view(html) == u8"a&nbsp;&nbsp;&nbsp;&nbsp;b");
+
+    return 0;
+}
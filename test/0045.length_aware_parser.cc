@@ -0,0 +1,44 @@
+#include <cstdlib>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <exception/exception.hh>
+#include <pltxt2htm/pltxt2htm.h>
+
+namespace {
+
+/**
+ * @brief Compare the html returned by C-Pointer-Style interface, then free it.
+ */
+bool html_equal(char8_t const* html, ::fast_io::u8string_view expected) noexcept {
+    bool const result = ::fast_io::u8string_view{::fast_io::mnp::os_c_str(html)} == expected;
+    ::std::free(const_cast<char8_t*>(html));
+    return result;
+}
+
+} // namespace
+
+int main() {
+    // text and host are not null-terminated
+    constexpr char8_t text[]{u8'<', u8'b', u8'>', u8'x', u8'<', u8'/', u8'b', u8'>', u8'#', u8'#'};
+    constexpr char8_t host[]{u8'h', u8'o', u8's', u8't', u8'!'};
+    ::exception::assert_true(html_equal(::pltxt2htm::advanced_parser(text, 8, host, 4), u8"<strong>x</strong>"));
+    ::exception::assert_true(html_equal(::pltxt2htm::fixedadv_parser(text, 8, host, 4), u8"<strong>x</strong>"));
+    ::exception::assert_true(html_equal(::pltxt2htm::common_parser(text, 8), u8"<strong>x</strong>"));
+
+    constexpr char8_t experiment[]{u8"<experiment=1>e</experiment>"};
+    ::exception::assert_true(
+        html_equal(::pltxt2htm::advanced_parser(experiment, sizeof(experiment) - 1, host, 4),
+                   u8"<a href=\"host/ExperimentSummary/Experiment/1\" internal>e</a>"));
+
+    // the same as the null-terminated interface
+    constexpr char8_t note[]{u8"<color=red>a</color> &\t<br>"};
+    auto const expected = ::pltxt2htm::pltxt2advanced_html(note, u8"_");
+    ::exception::assert_true(
+        html_equal(::pltxt2htm::advanced_parser(note, sizeof(note) - 1, u8"_", 1),
+                   ::fast_io::u8string_view{expected.data(), expected.size()}));
+
+    // `\0` does not end the text
+    constexpr char8_t with_nul[]{u8'a', u8'\0', u8'<', u8'i', u8'>', u8'b', u8'<', u8'/', u8'i', u8'>'};
+    ::exception::assert_true(html_equal(::pltxt2htm::common_parser(with_nul, sizeof(with_nul)), u8"a<em>b</em>"));
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include <cstddef>
+#include <memory>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <exception/exception.hh>
+#include <pltxt2htm/pltxt2htm.h>
+
+int main() {
+    constexpr char8_t text[]{u8"<color=red>物理</color>\t<experiment=1>实验</experiment>"};
+    constexpr ::fast_io::u8string_view host{u8"localhost:5173"};
+    auto const expected = ::pltxt2htm::pltxt2advanced_html(text, host);
+    ::fast_io::u8string_view const expected_view{expected.data(), expected.size()};
+
+    // the returned html owns its buffer, and its length is returned explicitly
+    ::std::size_t html_size{};
+    auto const html =
+        ::pltxt2htm::advanced_parser(text, sizeof(text) - 1, host.data(), host.size(), ::std::addressof(html_size));
+    ::exception::assert_true(html_size == expected.size());
+    ::exception::assert_true(::fast_io::u8string_view{html, html_size} == expected_view);
+    ::exception::assert_true(html[html_size] == u8'\0');
+    ::pltxt2htm::free_html(html);
+
+    // a too small buffer is untouched, and the needed length is returned
+    char8_t buffer[256];
+    buffer[0] = u8'?';
+    auto const needed =
+        ::pltxt2htm::advanced_parser_to(text, sizeof(text) - 1, host.data(), host.size(), buffer, expected.size());
+    ::exception::assert_true(needed == expected.size());
+    ::exception::assert_true(buffer[0] == u8'?');
+
+    // retry with the needed length + 1
+    auto const written =
+        ::pltxt2htm::advanced_parser_to(text, sizeof(text) - 1, host.data(), host.size(), buffer, needed + 1);
+    ::exception::assert_true(written == needed);
+    ::exception::assert_true(::fast_io::u8string_view{buffer, written} == expected_view);
+    ::exception::assert_true(buffer[written] == u8'\0');
+
+    auto const fixedadv_size =
+        ::pltxt2htm::fixedadv_parser_to(u8"a<b", 3, host.data(), host.size(), buffer, sizeof(buffer));
+    ::exception::assert_true(::fast_io::u8string_view{buffer, fixedadv_size} == u8"a<b");
+    auto const common_size = ::pltxt2htm::common_parser_to(u8"<i>x</i><br>", 12, buffer, sizeof(buffer));
+    ::exception::assert_true(::fast_io::u8string_view{buffer, common_size} == u8"<em>x</em>");
+
+    // an empty html still fits an one byte buffer
+    ::exception::assert_true(::pltxt2htm::common_parser_to(u8"", 0, buffer, 1) == 0);
+    ::exception::assert_true(buffer[0] == u8'\0');
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <fast_io/fast_io_dsal/vector.h>
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <exception/exception.hh>
+#include <pltxt2htm/pltxt2htm.hh>
+#include <pltxt2htm/pltxt2htm.h>
+
+namespace {
+
+::fast_io::u8string_view view(::fast_io::u8string const& str) noexcept {
+    return ::fast_io::u8string_view{str.data(), str.size()};
+}
+
+constexpr ::fast_io::u8string_view host{u8"localhost:5173"};
+
+/**
+ * @brief convert_batch must return the same htmls in the same order as converting the texts one by one.
+ */
+void assert_same_html(::std::span<::fast_io::u8string_view const> pltexts, ::std::size_t threads) noexcept {
+    auto const advanced = ::pltxt2htm::convert_batch(pltexts, host, ::pltxt2htm::BatchOptions{.threads = threads});
+    auto const fixedadv = ::pltxt2htm::convert_batch(
+        pltexts, host, ::pltxt2htm::BatchOptions{.html = ::pltxt2htm::BatchHtml::fixedadv, .threads = threads});
+    auto const common = ::pltxt2htm::convert_batch(
+        pltexts, host,
+        ::pltxt2htm::BatchOptions{.html = ::pltxt2htm::BatchHtml::common, .optimize = false, .threads = threads});
+    ::exception::assert_true(advanced.size() == pltexts.size());
+    ::exception::assert_true(fixedadv.size() == pltexts.size());
+    ::exception::assert_true(common.size() == pltexts.size());
+    for (::std::size_t i{}; i < pltexts.size(); ++i) {
+        ::exception::assert_true(view(advanced.index_unchecked(i)) ==
+                                 view(::pltxt2htm::pltxt2advanced_html<false>(pltexts[i], host)));
+        ::exception::assert_true(view(fixedadv.index_unchecked(i)) ==
+                                 view(::pltxt2htm::pltxt2fixedadv_html<false>(pltexts[i], host)));
+        ::exception::assert_true(view(common.index_unchecked(i)) ==
+                                 view(::pltxt2htm::pltxt2common_html<false>(pltexts[i])));
+    }
+}
+
+} // namespace
+
+int main() {
+    // empty batch
+    ::exception::assert_true(::pltxt2htm::convert_batch(::std::span<::fast_io::u8string_view const>{}, host).empty());
+
+    // short titles mixed with a few large documents, in deterministic tag soup
+    constexpr ::fast_io::u8string_view atoms[]{
+        u8"<color=red>", u8"</color>", u8"<a>",      u8"</a>",     u8"<b>",    u8"</b>",     u8"<i>",
+        u8"</em>",       u8"<del>",    u8"</del>",   u8"<size=12>", u8"</size>", u8"<user=u>", u8"</user>",
+        u8"<p>",         u8"</p>",     u8"<h3>",     u8"</h3>",    u8"x",      u8"实验",     u8"\n",
+        u8"# ",          u8"---\n",    u8"<br>",     u8"<!--c-->", u8"&",      u8"\xff"};
+    ::fast_io::vector<::fast_io::u8string> storage{};
+    ::std::uint_least32_t state{54321};
+    for (::std::size_t i{}; i < 500; ++i) {
+        ::fast_io::u8string pltext{};
+        state = state * 1103515245 + 12345;
+        auto length = (state >> 16) % 16;
+        if (i % 97 == 3) {
+            length = 20000;
+        }
+        for (::std::size_t j{}; j < length; ++j) {
+            state = state * 1103515245 + 12345;
+            pltext.append(atoms[(state >> 16) % (sizeof(atoms) / sizeof(atoms[0]))]);
+        }
+        storage.push_back(::std::move(pltext));
+    }
+    ::fast_io::vector<::fast_io::u8string_view> pltexts{};
+    for (auto const& pltext : storage) {
+        pltexts.push_back(view(pltext));
+    }
+    ::std::span<::fast_io::u8string_view const> const all{pltexts.data(), pltexts.size()};
+
+    // 0 is the number of cpus, more threads than documents are allowed
+    for (::std::size_t const threads : {0, 1, 2, 3, 8}) {
+        assert_same_html(all, threads);
+    }
+    assert_same_html(all.subspan(0, 5), 64);
+
+    // C-Pointer-Style interface
+    ::fast_io::vector<char8_t const*> texts{};
+    ::fast_io::vector<::std::size_t> text_sizes{};
+    for (auto const pltext : all) {
+        texts.push_back(pltext.data());
+        text_sizes.push_back(pltext.size());
+    }
+    ::fast_io::vector<char8_t const*> htmls(all.size());
+    ::fast_io::vector<::std::size_t> html_sizes(all.size());
+    ::pltxt2htm::advanced_parser_batch<false>(texts.data(), text_sizes.data(), all.size(), host.data(), host.size(),
+                                              4, htmls.data(), html_sizes.data());
+    for (::std::size_t i{}; i < all.size(); ++i) {
+        auto const expected = ::pltxt2htm::pltxt2advanced_html<false>(all[i], host);
+        ::exception::assert_true(html_sizes.index_unchecked(i) == expected.size());
+        ::exception::assert_true(::fast_io::u8string_view{htmls.index_unchecked(i), html_sizes.index_unchecked(i)} ==
+                                 view(expected));
+        ::exception::assert_true(htmls.index_unchecked(i)[expected.size()] == u8'\0');
+        ::pltxt2htm::free_html(htmls.index_unchecked(i));
+    }
+    ::pltxt2htm::common_parser_batch<false>(texts.data(), text_sizes.data(), all.size(), 0, htmls.data());
+    for (::std::size_t i{}; i < all.size(); ++i) {
+        auto const expected = ::pltxt2htm::pltxt2common_html<false>(all[i]);
+        // the html never contains `\0`, which is dropped from the text
+        ::exception::assert_true(::fast_io::u8string_view{::fast_io::mnp::os_c_str(htmls.index_unchecked(i))} ==
+                                 view(expected));
+        ::pltxt2htm::free_html(htmls.index_unchecked(i));
+    }
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <exception/exception.hh>
+#include <pltxt2htm/pltxt2htm.hh>
+
+namespace {
+
+constexpr ::fast_io::u8string_view host{u8"localhost:5173"};
+
+/**
+ * @brief `unit` repeated `count` times.
+ */
+::fast_io::u8string repeat(::fast_io::u8string_view unit, ::std::size_t count) {
+    ::fast_io::u8string pltext{};
+    for (::std::size_t i{}; i < count; ++i) {
+        pltext.append(unit);
+    }
+    return pltext;
+}
+
+} // namespace
+
+int main() {
+    constexpr ::fast_io::u8string_view pltext{u8"<color=red>a</color> <b>b&c</b>\n# d<br>中文"};
+
+    // unlimited is the same as without limits
+    ::exception::assert_true(::pltxt2htm::pltxt2advanced_html<false>(pltext, host, ::pltxt2htm::Limits{}) ==
+                             ::pltxt2htm::pltxt2advanced_html<false>(pltext, host));
+    ::exception::assert_true(::pltxt2htm::pltxt2fixedadv_html<false>(pltext, host, ::pltxt2htm::Limits{}) ==
+                             ::pltxt2htm::pltxt2fixedadv_html<false>(pltext, host));
+    ::exception::assert_true(::pltxt2htm::pltxt2common_html<false>(pltext, ::pltxt2htm::Limits{}) ==
+                             ::pltxt2htm::pltxt2common_html<false>(pltext));
+    ::exception::assert_true(::pltxt2htm::parse_pltxt<false>(pltext, ::pltxt2htm::Limits{}).has_value());
+
+    // every budget which runs out degrades to the escaped text
+    constexpr ::fast_io::u8string_view plain_text{u8"a&lt;b&gt;c&amp;d"};
+    constexpr ::fast_io::u8string_view tagged_text{u8"a<b>c&d"};
+    ::exception::assert_true(
+        ::pltxt2htm::pltxt2advanced_html<false>(tagged_text, host, ::pltxt2htm::Limits{.max_nodes = 1}) ==
+        plain_text);
+    ::exception::assert_true(
+        ::pltxt2htm::pltxt2advanced_html<false>(tagged_text, host, ::pltxt2htm::Limits{.max_depth = 0}) ==
+        plain_text);
+    ::exception::assert_true(
+        ::pltxt2htm::pltxt2advanced_html<false>(tagged_text, host, ::pltxt2htm::Limits{.max_output_size = 5}) ==
+        u8"a&lt;");
+    ::exception::assert_true(
+        ::pltxt2htm::pltxt2advanced_html<false>(tagged_text, host, ::pltxt2htm::Limits{.max_depth = 1}) ==
+        u8"a<strong>c&amp;d</strong>");
+    ::exception::assert_true(!::pltxt2htm::parse_pltxt<false>(tagged_text, ::pltxt2htm::Limits{.max_depth = 0})
+                                  .has_value());
+    // `<` is kept by pltxt2fixedadv_html, line breaks are dropped by pltxt2common_html
+    ::exception::assert_true(
+        ::pltxt2htm::pltxt2fixedadv_html<false>(tagged_text, host, ::pltxt2htm::Limits{.max_nodes = 1}) ==
+        u8"a<b&gt;c&amp;d");
+    ::exception::assert_true(
+        ::pltxt2htm::pltxt2common_html<false>(u8"<b>a\nb</b>", ::pltxt2htm::Limits{.max_depth = 0}) ==
+        u8"&lt;b&gt;ab&lt;/b&gt;");
+
+    // utf-8 is never cut, invalid utf-8 and control chars are not passed through
+    ::exception::assert_true(
+        ::pltxt2htm::pltxt2advanced_html<false>(u8"<b>中文", host, ::pltxt2htm::Limits{.max_depth = 0,
+                                                                                       .max_output_size = 13}) ==
+        u8"&lt;b&gt;中");
+    ::fast_io::u8string invalid{u8"<b>a"};
+    invalid.push_back(char8_t{0xff});
+    invalid.push_back(char8_t{0x01});
+    auto const invalid_html = ::pltxt2htm::pltxt2advanced_html<false>(
+        ::fast_io::u8string_view{invalid.data(), invalid.size()}, host, ::pltxt2htm::Limits{.max_depth = 0});
+    ::exception::assert_true(invalid_html == u8"&lt;b&gt;a\ufffd");
+
+    // the depth is bounded before the ast is built
+    auto const deep = repeat(u8"<ul><li>", 200000);
+    auto const deep_html = ::pltxt2htm::pltxt2advanced_html<false>(
+        ::fast_io::u8string_view{deep.data(), deep.size()}, host, ::pltxt2htm::Limits{.max_depth = 64});
+    ::exception::assert_true(::fast_io::u8string_view{deep_html.data(), deep_html.size()}.starts_with(
+        u8"&lt;ul&gt;&lt;li&gt;"));
+    auto const many = repeat(u8"<b>a</b>", 200000);
+    ::exception::assert_true(!::pltxt2htm::parse_pltxt<false>(::fast_io::u8string_view{many.data(), many.size()},
+                                                              ::pltxt2htm::Limits{.max_nodes = 1000})
+                                  .has_value());
+
+    // cancelled and late conversions give up
+    ::std::atomic<bool> cancelled{true};
+    ::exception::assert_true(
+        ::pltxt2htm::pltxt2advanced_html<false>(tagged_text, host, ::pltxt2htm::Limits{.cancelled = &cancelled}) ==
+        plain_text);
+    cancelled = false;
+    ::exception::assert_true(
+        ::pltxt2htm::pltxt2advanced_html<false>(tagged_text, host, ::pltxt2htm::Limits{.cancelled = &cancelled}) ==
+        ::pltxt2htm::pltxt2advanced_html<false>(tagged_text, host));
+    ::exception::assert_true(
+        ::pltxt2htm::pltxt2advanced_html<false>(
+            tagged_text, host, ::pltxt2htm::Limits{.deadline = ::std::chrono::steady_clock::now()}) == plain_text);
+
+    return 0;
+}
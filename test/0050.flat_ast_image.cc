@@ -0,0 +1,146 @@
+#include <cstddef>
+#include <cstdint>
+#include <fast_io/fast_io_dsal/string.h>
+#include <fast_io/fast_io_dsal/string_view.h>
+#include <exception/exception.hh>
+#include <pltxt2htm/pltxt2htm.hh>
+
+namespace {
+
+constexpr ::fast_io::u8string_view host{u8"localhost:5173"};
+
+/**
+ * @brief Render `flat_ast` to all targets, the htmls are separated by '\0'.
+ */
+template<::pltxt2htm::flat_ast_like FlatAstType>
+::fast_io::u8string render_all(FlatAstType const& flat_ast) {
+    ::fast_io::u8string html{};
+    ::pltxt2htm::details::ast2advanced_html<false>(flat_ast, host, html);
+    html.push_back(u8'\0');
+    ::pltxt2htm::details::ast2advanced_html<false, false>(flat_ast, host, html);
+    html.push_back(u8'\0');
+    ::pltxt2htm::details::ast2common_html<false>(flat_ast, html);
+    return html;
+}
+
+/**
+ * @brief Overwrite the little endian u32 at `offset` of `image`.
+ */
+void patch_u32(::fast_io::u8string& image, ::std::size_t offset, ::std::uint_least32_t value) {
+    for (::std::size_t i{}; i < 4; ++i) {
+        image[offset + i] = static_cast<char8_t>(value >> (i * 8));
+    }
+}
+
+bool loads(::fast_io::u8string const& image) {
+    return ::pltxt2htm::load_flat_ast(::fast_io::u8string_view{image.data(), image.size()}).has_value();
+}
+
+} // namespace
+
+int main() {
+    constexpr ::fast_io::u8string_view pltexts[]{
+        u8"",
+        u8"物理<color=red>实验<b>室</b></color>\n",
+        u8"# title\n<experiment=642cf37a494746375aae306a>exp</experiment> <discussion=1>d</discussion>"
+        u8"<user=2>u</user><size=12>big</size><a>link</a>\n- - -\n\\*<i>&'\"<>\t</i><br><!-- note -->",
+        u8"<h1>a</h1><p>b<del>c</del><em>d</em><strong>e</strong></p><ul><li>f</li></ul><code>g</code><pre>h</pre>",
+    };
+    for (auto const pltext : pltexts) {
+        auto ast = ::pltxt2htm::parse_pltxt<false>(pltext);
+        ::pltxt2htm::optimize_ast<false>(ast);
+        auto const flat_ast = ::pltxt2htm::flatten_ast<false>(ast);
+        auto const image = ::pltxt2htm::serialize_flat_ast(flat_ast);
+        ::exception::assert_true(image == ::pltxt2htm::serialize_flat_ast(flat_ast));
+
+        // the view renders the same html as the FlatAst
+        auto const view = ::pltxt2htm::load_flat_ast(::fast_io::u8string_view{image.data(), image.size()});
+        ::exception::assert_true(view.has_value());
+        ::exception::assert_true(view.value<false>().size() == flat_ast.size());
+        ::exception::assert_true(render_all(view.value<false>()) == render_all(flat_ast));
+
+        // the image is relocatable and needs no alignment
+        ::fast_io::u8string moved{u8"x"};
+        moved.append(::fast_io::u8string_view{image.data(), image.size()});
+        auto const moved_view = ::pltxt2htm::load_flat_ast(::fast_io::u8string_view{moved.data() + 1, image.size()});
+        ::exception::assert_true(render_all(moved_view.value<false>()) == render_all(flat_ast));
+
+        // every truncated image is rejected
+        for (::std::size_t size{}; size < image.size(); ++size) {
+            ::exception::assert_true(!::pltxt2htm::load_flat_ast(::fast_io::u8string_view{image.data(), size})
+                                          .has_value());
+        }
+    }
+
+    auto const ast = ::pltxt2htm::parse_pltxt<false>(u8"<b>a</b><size=5>b</size>");
+    auto const flat_ast = ::pltxt2htm::flatten_ast<false>(ast);
+    auto const image = ::pltxt2htm::serialize_flat_ast(flat_ast);
+    ::exception::assert_true(loads(image));
+    // root, b, text_run, size, text_run
+    ::exception::assert_true(flat_ast.size() == 5);
+    constexpr ::std::size_t header_size{28};
+    constexpr ::std::size_t first_child{header_size + 5};
+    constexpr ::std::size_t next_sibling{first_child + 4 * 5};
+    constexpr ::std::size_t payloads{next_sibling + 4 * 5};
+
+    // other versions, other NodeType and trailing bytes
+    auto bad = image;
+    bad[0] = u8'Q';
+    ::exception::assert_true(!loads(bad));
+    bad = image;
+    patch_u32(bad, 8, ::pltxt2htm::flat_ast_image_version + 1);
+    ::exception::assert_true(!loads(bad));
+    bad = image;
+    patch_u32(bad, 12, static_cast<::std::uint_least32_t>(::pltxt2htm::NodeType::md_code_fence) + 2);
+    ::exception::assert_true(!loads(bad));
+    bad = image;
+    bad.push_back(u8'\0');
+    ::exception::assert_true(!loads(bad));
+
+    // unknown node types, a second root, links which loop, point out of the image, link a node twice or skip
+    // the first child, payloads out of range
+    bad = image;
+    bad[header_size + 1] = static_cast<char8_t>(0xff);
+    ::exception::assert_true(!loads(bad));
+    bad = image;
+    bad[header_size + 1] = u8'\0';
+    ::exception::assert_true(!loads(bad));
+    bad = image;
+    patch_u32(bad, next_sibling + 4 * 3, 1);
+    ::exception::assert_true(!loads(bad));
+    bad = image;
+    patch_u32(bad, first_child + 4 * 1, 5);
+    ::exception::assert_true(!loads(bad));
+    bad = image;
+    patch_u32(bad, next_sibling + 4 * 1, 2);
+    ::exception::assert_true(!loads(bad));
+    bad = image;
+    patch_u32(bad, first_child + 4 * 3, 4);
+    patch_u32(bad, first_child + 4 * 0, 3);
+    ::exception::assert_true(!loads(bad));
+    bad = image;
+    patch_u32(bad, payloads + 8 * 2 + 4, 1000);
+    ::exception::assert_true(!loads(bad));
+    bad = image;
+    patch_u32(bad, payloads + 8 * 3, 1);
+    ::exception::assert_true(!loads(bad));
+
+    // a chain whose first child and next sibling are both the next node is a dag of 2^60 paths
+    constexpr ::std::size_t chain_size{61};
+    ::pltxt2htm::FlatAst chain{};
+    chain.push_node(::pltxt2htm::NodeType::base);
+    for (::std::size_t i{1}; i < chain_size; ++i) {
+        chain.push_node(::pltxt2htm::NodeType::pl_b);
+    }
+    auto dag = ::pltxt2htm::serialize_flat_ast(chain);
+    constexpr ::std::size_t chain_first_child{header_size + chain_size};
+    constexpr ::std::size_t chain_next_sibling{chain_first_child + 4 * chain_size};
+    patch_u32(dag, chain_first_child, 1);
+    for (::std::uint_least32_t i{1}; i + 1 < chain_size; ++i) {
+        patch_u32(dag, chain_first_child + 4 * i, i + 1);
+        patch_u32(dag, chain_next_sibling + 4 * i, i + 1);
+    }
+    ::exception::assert_true(!loads(dag));
+
+    return 0;
+}
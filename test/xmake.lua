@@ -34,6 +34,9 @@ for _, file in ipairs(os.files("*.cc")) do
         if is_plat("windows") or is_plat("mingw") then
             add_syslinks("ntdll")
         end
+        if is_plat("linux") or is_plat("bsd") then
+            add_syslinks("pthread")
+        end
 
         on_config(function (target)
             local toolchains = target:tool("cxx")
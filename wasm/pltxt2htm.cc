@@ -2,6 +2,7 @@
     #error "Enable exception in wasm is not recommended"
 #endif
 
+#include <cstddef>
 #include <pltxt2htm/pltxt2htm.h>
 
 extern "C"
@@ -69,3 +70,105 @@ extern "C"
 #endif
         >(text);
 }
+
+extern "C"
+#if __has_cpp_attribute(__gnu__::__used__)
+    [[__gnu__::__used__]]
+#endif
+    char8_t const* advanced_parser_n(char8_t const* const text, ::std::size_t const text_size,
+                                     char8_t const* const host, ::std::size_t const host_size,
+                                     ::std::size_t* const html_size) noexcept {
+    return ::pltxt2htm::advanced_parser<
+#ifdef NDEBUG
+        true
+#else
+        false
+#endif
+        >(text, text_size, host, host_size, html_size);
+}
+
+extern "C"
+#if __has_cpp_attribute(__gnu__::__used__)
+    [[__gnu__::__used__]]
+#endif
+    char8_t const* fixedadv_parser_n(char8_t const* const text, ::std::size_t const text_size,
+                                     char8_t const* const host, ::std::size_t const host_size,
+                                     ::std::size_t* const html_size) noexcept {
+    return ::pltxt2htm::fixedadv_parser<
+#ifdef NDEBUG
+        true
+#else
+        false
+#endif
+        >(text, text_size, host, host_size, html_size);
+}
+
+extern "C"
+#if __has_cpp_attribute(__gnu__::__used__)
+    [[__gnu__::__used__]]
+#endif
+    char8_t const* common_parser_n(char8_t const* const text, ::std::size_t const text_size,
+                                   ::std::size_t* const html_size) noexcept {
+    return ::pltxt2htm::common_parser<
+#ifdef NDEBUG
+        true
+#else
+        false
+#endif
+        >(text, text_size, html_size);
+}
+
+extern "C"
+#if __has_cpp_attribute(__gnu__::__used__)
+    [[__gnu__::__used__]]
+#endif
+    ::std::size_t advanced_parser_to(char8_t const* const text, ::std::size_t const text_size,
+                                     char8_t const* const host, ::std::size_t const host_size,
+                                     char8_t* const buffer, ::std::size_t const buffer_size) noexcept {
+    return ::pltxt2htm::advanced_parser_to<
+#ifdef NDEBUG
+        true
+#else
+        false
+#endif
+        >(text, text_size, host, host_size, buffer, buffer_size);
+}
+
+extern "C"
+#if __has_cpp_attribute(__gnu__::__used__)
+    [[__gnu__::__used__]]
+#endif
+    ::std::size_t fixedadv_parser_to(char8_t const* const text, ::std::size_t const text_size,
+                                     char8_t const* const host, ::std::size_t const host_size,
+                                     char8_t* const buffer, ::std::size_t const buffer_size) noexcept {
+    return ::pltxt2htm::fixedadv_parser_to<
+#ifdef NDEBUG
+        true
+#else
+        false
+#endif
+        >(text, text_size, host, host_size, buffer, buffer_size);
+}
+
+extern "C"
+#if __has_cpp_attribute(__gnu__::__used__)
+    [[__gnu__::__used__]]
+#endif
+    ::std::size_t common_parser_to(char8_t const* const text, ::std::size_t const text_size,
+                                   char8_t* const buffer, ::std::size_t const buffer_size) noexcept {
+    return ::pltxt2htm::common_parser_to<
+#ifdef NDEBUG
+        true
+#else
+        false
+#endif
+        >(text, text_size, buffer, buffer_size);
+}
+
+extern "C"
+#if __has_cpp_attribute(__gnu__::__used__)
+    [[__gnu__::__used__]]
+#endif
+    void pltxt2htm_free(char8_t const* const html) noexcept {
+    ::pltxt2htm::free_html(html);
+}